@@ -0,0 +1,433 @@
+#include <benchmark/benchmark.h>
+#include <algorithms/connected_components.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/dijkstra_algorithm.h>
+#include <algorithms/shortest_paths/distance_matrix.h>
+#include <algorithms/shortest_paths/hub_labels.h>
+#include <algorithms/shortest_paths/landmarks.h>
+#include <algorithms/shortest_paths/multilevel_overlay.h>
+#include <algorithms/shortest_paths/partitioned_dijkstra.h>
+#include <algorithms/shortest_paths/point_to_point.h>
+#include <algorithms/shortest_paths/quantized_dijkstra.h>
+#include <algorithms/vertex_order.h>
+#include <compiled_graph.h>
+#include <compressed_graph.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <partitioned_graph.h>
+#include <quantized_weights.h>
+#include <random>
+#include <simplified_graph.h>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "graph_generators.h"
+
+namespace {
+
+const float kDistCutoff = 5'000;
+
+const graph::Graph<int>& grid_graph(size_t side) {
+    static std::unordered_map<size_t, graph::Graph<int>> cache;
+    auto it = cache.find(side);
+    if (it == cache.end()) {
+        it = cache.emplace(side, bench::make_grid_graph(side, side).to_int_graph()).first;
+    }
+    return it->second;
+}
+
+const graph::Graph<int>& random_graph(size_t nodes_count) {
+    static std::unordered_map<size_t, graph::Graph<int>> cache;
+    auto it = cache.find(nodes_count);
+    if (it == cache.end()) {
+        it = cache.emplace(nodes_count, bench::make_random_geometric_graph(nodes_count).to_int_graph()).first;
+    }
+    return it->second;
+}
+
+enum class VertexOrderKind { Hash = 0, Hilbert = 1, Rcm = 2 };
+
+// Random geometric graph compiled in hash map order, then renumbered by the requested order
+const graph::CompiledGraph<osm::OSMNode>& compiled_random_graph(size_t nodes_count, VertexOrderKind order_kind) {
+    static std::map<std::pair<size_t, VertexOrderKind>, graph::CompiledGraph<osm::OSMNode>> cache;
+    auto key = std::make_pair(nodes_count, order_kind);
+    auto it = cache.find(key);
+
+    if (it == cache.end()) {
+        graph::CompiledGraph<osm::OSMNode> compiled(bench::make_random_geometric_graph(nodes_count).to_osm_graph(), true);
+        if (order_kind == VertexOrderKind::Hilbert) {
+            compiled = compiled.permuted(graph::algorithms::hilbert_order(compiled));
+        } else if (order_kind == VertexOrderKind::Rcm) {
+            compiled = compiled.permuted(graph::algorithms::rcm_order(compiled));
+        }
+        it = cache.emplace(key, std::move(compiled)).first;
+    }
+    return it->second;
+}
+
+const graph::algorithms::Landmarks<osm::OSMNode>& graph_landmarks(const graph::CompiledGraph<osm::OSMNode>& graph) {
+    static std::map<const void*, graph::algorithms::Landmarks<osm::OSMNode>> cache;
+    auto it = cache.find(&graph);
+    if (it == cache.end()) {
+        it = cache.emplace(&graph, graph::algorithms::Landmarks<osm::OSMNode>(graph, 16)).first;
+    }
+    return it->second;
+}
+
+std::vector<int> sources(size_t nodes_count, size_t sources_count) {
+    std::vector<int> res;
+    for (size_t i = 0; i < sources_count; i++) {
+        res.push_back((i * 7919) % nodes_count);
+    }
+    return res;
+}
+
+// Key to look up a generated OSM vertex by its id
+osm::OSMNode osm_node(int id) {
+    return osm::OSMNode{lib::pooled_string(std::to_string(id).c_str()), 0, 0};
+}
+
+}  // namespace
+
+static void BM_single_source_dijkstra_grid(benchmark::State& state) {
+    size_t side = state.range(0);
+    const auto& graph = grid_graph(side);
+    auto cutoff = [](float dist) { return dist <= kDistCutoff; };
+    int start = side * side / 2 + side / 2;
+    size_t settled = 0;
+
+    for (auto _ : state) {
+        auto res = graph::algorithms::single_source_dijkstra(graph, start, cutoff);
+        settled = res.size();
+        benchmark::DoNotOptimize(res);
+    }
+
+    state.counters["settled"] = settled;
+    state.counters["nodes_per_second"] = benchmark::Counter(settled, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_single_source_dijkstra_grid)->Arg(100)->Arg(300)->Arg(1'000)->Unit(benchmark::kMillisecond);
+
+static void BM_single_source_dijkstra_random(benchmark::State& state) {
+    size_t nodes_count = state.range(0);
+    const auto& graph = random_graph(nodes_count);
+    auto cutoff = [](float dist) { return dist <= kDistCutoff; };
+    size_t settled = 0;
+
+    for (auto _ : state) {
+        auto res = graph::algorithms::single_source_dijkstra(graph, static_cast<int>(nodes_count / 2), cutoff);
+        settled = res.size();
+        benchmark::DoNotOptimize(res);
+    }
+
+    state.counters["settled"] = settled;
+}
+BENCHMARK(BM_single_source_dijkstra_random)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+// Macrobenchmark: batch of isochrones on a 1M node grid at several thread counts
+static void BM_multi_source_dijkstra(benchmark::State& state) {
+    const size_t side = 1'000;
+    const auto& graph = grid_graph(side);
+    auto cutoff = [](float dist) { return dist <= kDistCutoff; };
+    auto starts_vec = sources(side * side, 64);
+    int n_threads = state.range(0);
+
+    for (auto _ : state) {
+        auto res = graph::algorithms::multi_source_dijkstra(graph, starts_vec, n_threads, cutoff);
+        benchmark::DoNotOptimize(res);
+    }
+
+    state.counters["queries_per_second"] = benchmark::Counter(starts_vec.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_multi_source_dijkstra)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Same searches on the flat graph in hash map order and after locality reordering
+static void BM_compiled_dijkstra_random(benchmark::State& state) {
+    size_t nodes_count = state.range(0);
+    auto order_kind = static_cast<VertexOrderKind>(state.range(1));
+    const auto& graph = compiled_random_graph(nodes_count, order_kind);
+    auto cutoff = [](float dist) { return dist <= kDistCutoff; };
+    graph::algorithms::DijkstraWorkspace workspace;
+    graph::algorithms::NoSearchStats stats;
+    auto starts_vec = sources(nodes_count, 16);
+    size_t settled = 0;
+
+    for (auto _ : state) {
+        settled = 0;
+        for (auto start : starts_vec) {
+            auto start_idx = graph.index(osm_node(start));
+            graph::algorithms::single_source_dijkstra(graph, start_idx, cutoff, workspace, stats);
+            settled += workspace.reached().size();
+        }
+        benchmark::DoNotOptimize(workspace.reached().data());
+    }
+
+    state.counters["mean_edge_span"] = graph::algorithms::mean_edge_span(graph);
+    state.counters["nodes_per_second"] = benchmark::Counter(settled, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_compiled_dijkstra_random)
+    ->ArgsProduct({{100'000, 1'000'000}, {0, 1, 2}})
+    ->ArgNames({"nodes", "order"})
+    ->Unit(benchmark::kMillisecond);
+
+// Point-to-point queries between random vertices: bidirectional dijkstra, bidirectional A* and ALT
+static void BM_point_to_point_random(benchmark::State& state) {
+    size_t nodes_count = state.range(0);
+    auto heuristic = static_cast<graph::algorithms::PointToPointHeuristic>(state.range(1));
+    const auto& graph = compiled_random_graph(nodes_count, VertexOrderKind::Hilbert);
+    auto engine = heuristic == graph::algorithms::PointToPointHeuristic::Landmarks
+                      ? graph::algorithms::PointToPointEngine<osm::OSMNode>(graph, graph_landmarks(graph))
+                      : graph::algorithms::PointToPointEngine<osm::OSMNode>(graph, 1, heuristic);
+    graph::algorithms::PointToPointWorkspace workspace;
+    graph::algorithms::SearchStats stats;
+    auto sources_vec = sources(nodes_count, 16);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < sources_vec.size(); i++) {
+            auto source = graph.index(osm_node(sources_vec[i]));
+            auto target = graph.index(osm_node(sources_vec[(i + 1) % sources_vec.size()]));
+            benchmark::DoNotOptimize(engine.distance(source, target, workspace, stats));
+        }
+    }
+
+    state.counters["settled_per_query"] = static_cast<double>(stats.settled_nodes) / stats.queries;
+    state.counters["queries_per_second"] = benchmark::Counter(sources_vec.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_point_to_point_random)
+    ->ArgsProduct({{100'000, 1'000'000}, {0, 1, 2}})
+    ->ArgNames({"nodes", "heuristic"})
+    ->Unit(benchmark::kMillisecond);
+
+// Origin-destination matrix between vertices spread over the graph
+static void BM_distance_matrix(benchmark::State& state) {
+    size_t nodes_count = 100'000;
+    size_t size = state.range(0);
+    const auto& graph = compiled_random_graph(nodes_count, VertexOrderKind::Hilbert);
+    std::vector<std::uint32_t> sources_vec;
+    std::vector<std::uint32_t> targets_vec;
+    for (size_t i = 0; i < size; i++) {
+        sources_vec.push_back((i * 7919) % nodes_count);
+        targets_vec.push_back((i * 104'729 + 13) % nodes_count);
+    }
+    std::vector<float> matrix(size * size);
+
+    for (auto _ : state) {
+        graph::algorithms::distance_matrix(graph, sources_vec, targets_vec, matrix.data());
+        benchmark::DoNotOptimize(matrix.data());
+    }
+
+    state.counters["cells_per_second"] = benchmark::Counter(size * size, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_distance_matrix)->Arg(100)->Arg(500)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Strongly connected components of the 1M vertex graph by the number of threads
+static void BM_strong_components(benchmark::State& state) {
+    const auto& graph = compiled_random_graph(1'000'000, VertexOrderKind::Hilbert);
+    graph::algorithms::ThreadPool pool(state.range(0));
+    size_t largest = 0;
+
+    for (auto _ : state) {
+        auto components = graph::algorithms::connected_components(graph, graph::algorithms::Connectivity::Strong, pool);
+        largest = components.largest_size();
+    }
+
+    state.counters["largest_share"] = static_cast<double>(largest) / graph.vertices_count();
+    state.counters["nodes_per_second"] = benchmark::Counter(graph.vertices_count(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_strong_components)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Isochrones on a graph with shape nodes, as loaded and after chain contraction
+static void BM_simplified_dijkstra(benchmark::State& state) {
+    static graph::Graph<int> shaped(bench::add_shape_nodes(bench::make_random_geometric_graph(100'000), 4).to_weights());
+    auto starts_vec = sources(100'000, 16);
+    static graph::SimplifiedGraph<int> simplified(shaped, std::unordered_set<int>(starts_vec.begin(), starts_vec.end()));
+    bool contracted = state.range(0);
+    const auto& graph = contracted ? simplified.graph() : shaped;
+    auto cutoff = [](float dist) { return dist <= kDistCutoff; };
+    size_t reached = 0;
+
+    for (auto _ : state) {
+        reached = 0;
+        for (auto start : starts_vec) {
+            auto dists = graph::algorithms::single_source_dijkstra(graph, start, cutoff);
+            if (contracted) {
+                dists = simplified.expand(dists, cutoff);
+            }
+            reached += dists.size();
+        }
+    }
+
+    state.counters["vertices"] = graph.get_weights().size();
+    state.counters["reached_per_second"] = benchmark::Counter(reached, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_simplified_dijkstra)->Arg(0)->Arg(1)->ArgName("contracted")->Unit(benchmark::kMillisecond);
+
+// Isochrones with float weights in a binary heap and with decimeter weights in Dial's bucket queue
+static void BM_quantized_dijkstra(benchmark::State& state) {
+    const auto& graph = compiled_random_graph(1'000'000, VertexOrderKind::Hilbert);
+    static graph::QuantizedWeights<std::uint16_t> weights(graph, {0.1f});
+    bool quantized = state.range(0);
+    auto cutoff = [](float dist) { return dist <= kDistCutoff; };
+    graph::algorithms::DijkstraWorkspace workspace;
+    graph::algorithms::QuantizedDijkstraSearch<std::uint16_t> search(graph::algorithms::QuantizedWeight<std::uint16_t>{&weights});
+    graph::algorithms::NoSearchStats stats;
+    auto starts_vec = sources(1'000'000, 16);
+    size_t settled = 0;
+
+    for (auto _ : state) {
+        settled = 0;
+        for (auto start : starts_vec) {
+            auto start_idx = graph.index(osm_node(start));
+            if (quantized) {
+                graph::algorithms::quantized_dijkstra(graph, weights, start_idx, cutoff, search, stats);
+                settled += search.settled().size();
+            } else {
+                graph::algorithms::single_source_dijkstra(graph, start_idx, cutoff, workspace, stats);
+                settled += workspace.reached().size();
+            }
+        }
+    }
+
+    state.counters["weight_bytes"] = quantized ? weights.memory_usage().total() : graph.memory_usage()[lib::MemoryCategory::Weights];
+    state.counters["nodes_per_second"] = benchmark::Counter(settled, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_quantized_dijkstra)->Arg(0)->Arg(1)->ArgName("quantized")->Unit(benchmark::kMillisecond);
+
+// Isochrones on the flat graph and on the compressed adjacency with decimeter weights
+static void BM_compressed_dijkstra(benchmark::State& state) {
+    const auto& graph = compiled_random_graph(1'000'000, VertexOrderKind::Hilbert);
+    static graph::CompressedGraph<osm::OSMNode> compressed(graph, {0.1f});
+    bool is_compressed = state.range(0);
+    auto cutoff = [](float dist) { return dist <= kDistCutoff; };
+    graph::algorithms::DijkstraWorkspace workspace;
+    graph::algorithms::CompressedDijkstraSearch search;
+    graph::algorithms::NoSearchStats stats;
+    auto starts_vec = sources(1'000'000, 16);
+    size_t settled = 0;
+
+    for (auto _ : state) {
+        settled = 0;
+        for (auto start : starts_vec) {
+            auto start_idx = graph.index(osm_node(start));
+            if (is_compressed) {
+                graph::algorithms::compressed_dijkstra(compressed, start_idx, cutoff, search, stats);
+                settled += search.settled().size();
+            } else {
+                graph::algorithms::single_source_dijkstra(graph, start_idx, cutoff, workspace, stats);
+                settled += workspace.reached().size();
+            }
+        }
+    }
+
+    auto memory = graph.memory_usage();
+    state.counters["adjacency_bytes"] = is_compressed ? compressed.adjacency_bytes()
+                                                      : memory[lib::MemoryCategory::Topology] + memory[lib::MemoryCategory::Weights];
+    state.counters["nodes_per_second"] = benchmark::Counter(settled, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_compressed_dijkstra)->Arg(0)->Arg(1)->ArgName("compressed")->Unit(benchmark::kMillisecond);
+
+// Isochrones on the partitioned file with a cell budget far below the graph size; the first
+// iteration maps the cells, later ones find them mapped
+static void BM_partitioned_dijkstra(benchmark::State& state) {
+    const auto& compiled = compiled_random_graph(1'000'000, VertexOrderKind::Hilbert);
+    static std::string path = (std::filesystem::temp_directory_path() / "bench_partitioned_graph.bin").string();
+    static bool written = (graph::write_partitioned_graph(compiled, path), true);
+    benchmark::DoNotOptimize(written);
+    graph::PartitionedGraph graph(path, size_t(state.range(0)) << 20);
+    auto cutoff = [](float dist) { return dist <= kDistCutoff; };
+    graph::algorithms::PartitionedDijkstraSearch search;
+    graph::algorithms::NoSearchStats stats;
+    std::vector<std::uint32_t> starts_vec;
+    for (auto start : sources(1'000'000, 16)) {
+        starts_vec.push_back(graph.partitioned_index(compiled.index(osm_node(start))));
+    }
+    size_t settled = 0;
+
+    for (auto _ : state) {
+        settled = 0;
+        for (auto start : starts_vec) {
+            graph::algorithms::partitioned_dijkstra(graph, start, cutoff, search, stats);
+            settled += search.settled().size();
+        }
+    }
+
+    state.counters["resident_bytes"] = graph.resident_bytes();
+    state.counters["cell_loads"] = graph.cell_loads();
+    state.counters["nodes_per_second"] = benchmark::Counter(settled, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_partitioned_dijkstra)->Arg(16)->Arg(256)->ArgName("budget_mb")->Unit(benchmark::kMillisecond);
+
+// Re-customization of the overlay for new weights, the step repeated on every traffic update
+static void BM_overlay_customization(benchmark::State& state) {
+    size_t nodes_count = state.range(0);
+    const auto& graph = compiled_random_graph(nodes_count, VertexOrderKind::Hilbert);
+    graph::algorithms::MultilevelOverlay<osm::OSMNode> overlay(graph);
+    graph::algorithms::OverlayMetric<osm::OSMNode> metric(overlay);
+    std::vector<float> weights(graph.edges_count());
+    for (std::uint32_t edge = 0; edge < weights.size(); edge++) {
+        weights[edge] = graph.weight(edge) * (1 + edge % 3);
+    }
+
+    for (auto _ : state) {
+        metric.customize(weights);
+    }
+
+    state.counters["boundary_vertices"] = overlay.boundary_count(1);
+    state.counters["overlay_bytes"] = overlay.memory_usage().total() + metric.memory_usage().total();
+}
+BENCHMARK(BM_overlay_customization)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Point to point queries on the overlay, the same pairs as BM_point_to_point_random
+static void BM_overlay_query(benchmark::State& state) {
+    size_t nodes_count = state.range(0);
+    const auto& graph = compiled_random_graph(nodes_count, VertexOrderKind::Hilbert);
+    graph::algorithms::MultilevelOverlay<osm::OSMNode> overlay(graph);
+    graph::algorithms::OverlayMetric<osm::OSMNode> metric(overlay);
+    graph::algorithms::OverlayDijkstraSearch search;
+    graph::algorithms::SearchStats stats;
+    auto sources_vec = sources(nodes_count, 16);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < sources_vec.size(); i++) {
+            auto source = graph.index(osm_node(sources_vec[i]));
+            auto target = graph.index(osm_node(sources_vec[(i + 1) % sources_vec.size()]));
+            benchmark::DoNotOptimize(graph::algorithms::overlay_distance(metric, source, target, search, stats));
+        }
+    }
+
+    state.counters["settled_per_query"] = static_cast<double>(stats.settled_nodes) / stats.queries;
+    state.counters["queries_per_second"] = benchmark::Counter(sources_vec.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_overlay_query)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+// Hub label lookups between random vertices of a metro-sized graph; labels are built once
+static void BM_hub_labels_query(benchmark::State& state) {
+    size_t nodes_count = state.range(0);
+    const auto& graph = compiled_random_graph(nodes_count, VertexOrderKind::Hilbert);
+    static std::map<size_t, graph::algorithms::HubLabels> labels_cache;
+    auto it = labels_cache.find(nodes_count);
+    if (it == labels_cache.end()) {
+        it = labels_cache.emplace(nodes_count, graph::algorithms::HubLabels(graph, graph::algorithms::contract_graph(graph))).first;
+    }
+    const auto& labels = it->second;
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<std::uint32_t> vertex_dist(0, graph.vertices_count() - 1);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs(1 << 16);
+    for (auto& pair : pairs) {
+        pair = {vertex_dist(gen), vertex_dist(gen)};
+    }
+
+    for (auto _ : state) {
+        for (const auto& [s, t] : pairs) {
+            benchmark::DoNotOptimize(labels.distance(s, t));
+        }
+    }
+
+    auto report = labels.report();
+    state.counters["average_label"] = report.average_size;
+    state.counters["max_label"] = report.max_size;
+    state.counters["label_bytes"] = report.bytes;
+    state.counters["queries_per_second"] = benchmark::Counter(pairs.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_hub_labels_query)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
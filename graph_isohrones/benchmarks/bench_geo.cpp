@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+#include <algorithms/light_polygon.h>
+#include <algorithms/polygon_cover.h>
+#include <algorithms/prepared_polygon.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <geo_utils/geohash.h>
+
+namespace {
+
+std::vector<std::pair<double, double>> random_points(size_t count, double min_coord, double max_coord) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> coord_dist(min_coord, max_coord);
+    std::vector<std::pair<double, double>> res(count);
+    for (auto& point : res) {
+        point = {coord_dist(gen), coord_dist(gen)};
+    }
+    return res;
+}
+
+// Isochrone-like star polygon around (cx, cy)
+graph::algorithms::LightMultiPolygon star_polygon(size_t vertices_count, double cx, double cy) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> radius_dist(0.5, 1.0);
+    std::vector<graph::algorithms::Point2d> points;
+    for (size_t i = 0; i < vertices_count; i++) {
+        double angle = 2 * M_PI * i / vertices_count;
+        double radius = radius_dist(gen);
+        points.push_back({cx + radius * std::cos(angle), cy + radius * std::sin(angle)});
+    }
+    points.push_back(points.front());
+
+    graph::algorithms::LightMultiPolygon res;
+    res.polygons_vec.resize(1);
+    res.polygons_vec[0].external_polygon = graph::algorithms::LightSimplePolygon(points);
+    return res;
+}
+
+}  // namespace
+
+static void BM_geohash_encode(benchmark::State& state) {
+    auto points = random_points(1 << 16, -50, 50);
+    size_t i = 0;
+
+    for (auto _ : state) {
+        auto& point = points[i++ & (points.size() - 1)];
+        benchmark::DoNotOptimize(geo_utils::geohash::encode(point.first, point.second));
+    }
+}
+BENCHMARK(BM_geohash_encode);
+
+static void BM_geohash_encode_to_int(benchmark::State& state) {
+    auto points = random_points(1 << 16, -50, 50);
+    size_t i = 0;
+
+    for (auto _ : state) {
+        auto& point = points[i++ & (points.size() - 1)];
+        benchmark::DoNotOptimize(geo_utils::geohash::encode_to_int(point.first, point.second));
+    }
+}
+BENCHMARK(BM_geohash_encode_to_int);
+
+static void BM_light_polygon_contains(benchmark::State& state) {
+    auto polygon = star_polygon(state.range(0), 0, 0);
+    auto points = random_points(1 << 12, -1.1, 1.1);
+    size_t i = 0;
+
+    for (auto _ : state) {
+        auto& point = points[i++ & (points.size() - 1)];
+        benchmark::DoNotOptimize(polygon.contains(point.first, point.second));
+    }
+}
+BENCHMARK(BM_light_polygon_contains)->Arg(100)->Arg(10'000)->Arg(100'000);
+
+static void BM_prepared_polygon_contains(benchmark::State& state) {
+    graph::algorithms::PreparedMultiPolygon polygon(star_polygon(state.range(0), 0, 0));
+    auto points = random_points(1 << 12, -1.1, 1.1);
+    size_t i = 0;
+
+    for (auto _ : state) {
+        auto& point = points[i++ & (points.size() - 1)];
+        benchmark::DoNotOptimize(polygon.contains(point.first, point.second));
+    }
+}
+BENCHMARK(BM_prepared_polygon_contains)->Arg(100)->Arg(10'000)->Arg(100'000);
+
+static void BM_polygon_cover(benchmark::State& state) {
+    auto polygon = star_polygon(10'000, 37.6, 55.75);
+    int precision = state.range(0);
+    size_t cells_count = 0;
+
+    for (auto _ : state) {
+        auto codes = graph::algorithms::polygon_cover(polygon, precision, 2, 4);
+        cells_count = codes.size();
+        benchmark::DoNotOptimize(codes);
+    }
+
+    state.counters["cells"] = cells_count;
+}
+BENCHMARK(BM_polygon_cover)->Arg(12)->Arg(14)->Arg(16)->Unit(benchmark::kMillisecond);
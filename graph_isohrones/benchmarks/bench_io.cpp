@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include <io/load_graphml.h>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <io/read_file.h>
+
+namespace {
+
+// Same file as the load_graphml test; override with GRAPH_UTILS_BENCH_GRAPHML
+std::string graphml_filename() {
+    const char* filename = std::getenv("GRAPH_UTILS_BENCH_GRAPHML");
+    return filename ? filename : "test/tests/test_io/resources/sahalin_region.graphml";
+}
+
+}  // namespace
+
+static void BM_load_graphml(benchmark::State& state) {
+    std::string content;
+
+    try {
+        content = io::read_file(graphml_filename());
+    } catch (...) {
+        state.SkipWithError(("Can not read " + graphml_filename()).c_str());
+        return;
+    }
+
+    for (auto _ : state) {
+        std::istringstream stream(content);
+        auto graph = io::load_graphml(stream);
+        benchmark::DoNotOptimize(graph);
+    }
+
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(BM_load_graphml)->Unit(benchmark::kMillisecond);
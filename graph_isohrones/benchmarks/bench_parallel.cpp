@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+#include <algorithms/parallel.h>
+#include <algorithms/thread_pool.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Task cost grows with the item, so static batches get unbalanced
+std::uint64_t uneven_task(int itm) {
+    std::uint64_t res = itm;
+    for (int i = 0; i < itm % 1'000; i++) {
+        res = res * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return res;
+}
+
+}  // namespace
+
+static void BM_run_in_threads(benchmark::State& state) {
+    int n_threads = state.range(0);
+    std::vector<int> input(200'000);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = i;
+    }
+
+    for (auto _ : state) {
+        auto res = graph::algorithms::run_in_threads(input, n_threads, [](int itm, int thread_num) { return uneven_task(itm); });
+        benchmark::DoNotOptimize(res);
+    }
+
+    state.counters["items_per_second"] = benchmark::Counter(input.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_run_in_threads)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_thread_pool_parallel_for(benchmark::State& state) {
+    graph::algorithms::ThreadPool pool(state.range(0));
+    std::vector<std::uint64_t> res(200'000);
+
+    for (auto _ : state) {
+        pool.parallel_for(res.size(), [&res](size_t idx, int worker_id) { res[idx] = uneven_task(idx); }, 256);
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    state.counters["items_per_second"] = benchmark::Counter(res.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_thread_pool_parallel_for)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Unit(benchmark::kMillisecond)->UseRealTime();
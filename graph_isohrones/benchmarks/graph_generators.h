@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <geo_utils/osm_graph.h>
+#include <graph.h>
+
+namespace bench {
+
+struct SyntheticEdge {
+    std::uint32_t from;
+    std::uint32_t to;
+    float length;
+};
+
+/**
+ * @brief Road-like graph as plain arrays: node coordinates in lon/lat and directed edges
+ */
+struct SyntheticGraph {
+    std::vector<std::pair<float, float>> coords;
+    std::vector<SyntheticEdge> edges;
+
+    size_t nodes_count() const {
+        return coords.size();
+    }
+
+    std::unordered_map<int, std::unordered_map<int, float>> to_weights() const {
+        std::unordered_map<int, std::unordered_map<int, float>> weights;
+        weights.reserve(coords.size());
+
+        for (std::uint32_t node = 0; node < coords.size(); node++) {
+            weights[node];
+        }
+        for (const auto& edge : edges) {
+            weights[edge.from][edge.to] = edge.length;
+        }
+
+        return weights;
+    }
+
+    graph::Graph<int> to_int_graph() const {
+        return graph::Graph<int>(to_weights());
+    }
+
+    osm::OSMGraph to_osm_graph() const {
+        auto string_pool = std::make_shared<lib::StringPool>();
+        std::vector<osm::OSMNode> nodes;
+        nodes.reserve(coords.size());
+
+        for (std::uint32_t node = 0; node < coords.size(); node++) {
+            nodes.push_back(osm::OSMNode{string_pool->intern(std::to_string(node)), coords[node].first, coords[node].second});
+        }
+
+        std::unordered_map<osm::OSMNode, std::unordered_map<osm::OSMNode, float>> weights;
+        weights.reserve(coords.size());
+
+        for (const auto& node : nodes) {
+            weights[node];
+        }
+        for (const auto& edge : edges) {
+            weights[nodes[edge.from]][nodes[edge.to]] = edge.length;
+        }
+
+        return osm::OSMGraph(std::move(weights), std::move(string_pool));
+    }
+};
+
+// Meters per degree of latitude
+constexpr double kMetersPerDegree = 111'320.0;
+
+inline float distance_meters(std::pair<float, float> lhs, std::pair<float, float> rhs) {
+    double lat = (lhs.second + rhs.second) / 2 * M_PI / 180;
+    double dx = (lhs.first - rhs.first) * std::cos(lat);
+    double dy = lhs.second - rhs.second;
+    return std::sqrt(dx * dx + dy * dy) * kMetersPerDegree;
+}
+
+/**
+ * @brief Rows x cols grid of two-way streets with jittered lengths
+ *
+ * @param rows Number of grid rows
+ * @param cols Number of grid columns
+ * @param step_deg Distance between neighbouring nodes in degrees
+ * @param seed Random seed
+ */
+inline SyntheticGraph make_grid_graph(size_t rows, size_t cols, double step_deg = 0.001, std::uint32_t seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> jitter(1.0f, 1.3f);
+    SyntheticGraph res;
+    res.coords.reserve(rows * cols);
+
+    for (size_t row = 0; row < rows; row++) {
+        for (size_t col = 0; col < cols; col++) {
+            res.coords.push_back({static_cast<float>(37.0 + col * step_deg), static_cast<float>(55.0 + row * step_deg)});
+        }
+    }
+
+    auto add_street = [&res, &gen, &jitter](std::uint32_t u, std::uint32_t v) {
+        float length = distance_meters(res.coords[u], res.coords[v]) * jitter(gen);
+        res.edges.push_back({u, v, length});
+        res.edges.push_back({v, u, length});
+    };
+
+    for (size_t row = 0; row < rows; row++) {
+        for (size_t col = 0; col < cols; col++) {
+            std::uint32_t node = row * cols + col;
+            if (col + 1 < cols) {
+                add_street(node, node + 1);
+            }
+            if (row + 1 < rows) {
+                add_street(node, node + cols);
+            }
+        }
+    }
+
+    return res;
+}
+
+/**
+ * @brief Random geometric graph resembling a road network.
+ * Nodes are uniform in a square, every node is linked to its k nearest neighbours,
+ * a share of links is one-way. Neighbours are searched in a uniform grid, so the
+ * generator is linear in the number of nodes and scales to millions of them.
+ *
+ * @param nodes_count Number of nodes
+ * @param k Number of nearest neighbours to link
+ * @param one_way_share Share of one-way links
+ * @param seed Random seed
+ */
+inline SyntheticGraph make_random_geometric_graph(size_t nodes_count, size_t k = 3, double one_way_share = 0.1, std::uint32_t seed = 42) {
+    std::mt19937 gen(seed);
+    // Keep average node spacing around 100 meters
+    double side_deg = std::sqrt(static_cast<double>(nodes_count)) * 100.0 / kMetersPerDegree;
+    std::uniform_real_distribution<double> coord_dist(0, side_deg);
+    std::uniform_real_distribution<double> share_dist(0, 1);
+    SyntheticGraph res;
+    res.coords.reserve(nodes_count);
+
+    for (size_t node = 0; node < nodes_count; node++) {
+        res.coords.push_back({static_cast<float>(37.0 + coord_dist(gen)), static_cast<float>(55.0 + coord_dist(gen))});
+    }
+
+    size_t grid_dim = std::max<size_t>(1, std::sqrt(static_cast<double>(nodes_count) / 2));
+    double cell_deg = side_deg / grid_dim;
+    std::vector<std::vector<std::uint32_t>> cells(grid_dim * grid_dim);
+    auto cell_of = [&res, cell_deg, grid_dim](std::uint32_t node) {
+        size_t x = std::min<size_t>(grid_dim - 1, (res.coords[node].first - 37.0) / cell_deg);
+        size_t y = std::min<size_t>(grid_dim - 1, (res.coords[node].second - 55.0) / cell_deg);
+        return std::pair<size_t, size_t>{x, y};
+    };
+
+    for (std::uint32_t node = 0; node < nodes_count; node++) {
+        auto cell = cell_of(node);
+        cells[cell.second * grid_dim + cell.first].push_back(node);
+    }
+
+    std::vector<std::pair<float, std::uint32_t>> candidates;
+
+    for (std::uint32_t node = 0; node < nodes_count; node++) {
+        auto cell = cell_of(node);
+        candidates.clear();
+
+        for (size_t y = cell.second > 0 ? cell.second - 1 : 0; y <= std::min(grid_dim - 1, cell.second + 1); y++) {
+            for (size_t x = cell.first > 0 ? cell.first - 1 : 0; x <= std::min(grid_dim - 1, cell.first + 1); x++) {
+                for (auto other : cells[y * grid_dim + x]) {
+                    if (other != node) {
+                        candidates.push_back({distance_meters(res.coords[node], res.coords[other]), other});
+                    }
+                }
+            }
+        }
+
+        size_t links_count = std::min(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + links_count, candidates.end());
+
+        for (size_t i = 0; i < links_count; i++) {
+            // Roads are a bit longer than straight lines
+            float length = candidates[i].first * 1.2f;
+            res.edges.push_back({node, candidates[i].second, length});
+            if (share_dist(gen) >= one_way_share) {
+                res.edges.push_back({candidates[i].second, node, length});
+            }
+        }
+    }
+
+    return res;
+}
+
+/**
+ * @brief Same graph with every street drawn through intermediate shape nodes like in raw
+ * OSM exports; both directions of a two-way street share the shape nodes
+ *
+ * @param graph Source graph
+ * @param shape_nodes Number of intermediate nodes per street
+ */
+inline SyntheticGraph add_shape_nodes(const SyntheticGraph& graph, size_t shape_nodes) {
+    SyntheticGraph res;
+    res.coords = graph.coords;
+    std::unordered_map<std::uint64_t, std::uint32_t> first_shape_node;
+
+    for (const auto& edge : graph.edges) {
+        auto key = (static_cast<std::uint64_t>(std::min(edge.from, edge.to)) << 32) | std::max(edge.from, edge.to);
+        auto [it, inserted] = first_shape_node.emplace(key, res.coords.size());
+        if (inserted) {
+            auto from = graph.coords[std::min(edge.from, edge.to)];
+            auto to = graph.coords[std::max(edge.from, edge.to)];
+            for (size_t i = 1; i <= shape_nodes; i++) {
+                float share = static_cast<float>(i) / (shape_nodes + 1);
+                res.coords.push_back({from.first + (to.first - from.first) * share, from.second + (to.second - from.second) * share});
+            }
+        }
+
+        // Shape nodes are stored from the lower node id
+        std::vector<std::uint32_t> path = {edge.from};
+        for (size_t i = 0; i < shape_nodes; i++) {
+            path.push_back(it->second + (edge.from < edge.to ? i : shape_nodes - 1 - i));
+        }
+        path.push_back(edge.to);
+
+        float length = edge.length / (shape_nodes + 1);
+        for (size_t i = 0; i + 1 < path.size(); i++) {
+            res.edges.push_back({path[i], path[i + 1], length});
+        }
+    }
+
+    return res;
+}
+
+}  // namespace bench
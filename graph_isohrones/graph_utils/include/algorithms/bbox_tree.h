@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <algorithms/light_polygon.h>
+
+namespace graph {
+namespace algorithms {
+
+inline bool boxContains(const BoundingBox &box, Point2d point) {
+  return !(point.x < box.xmin || point.x > box.xmax || point.y < box.ymin ||
+           point.y > box.ymax);
+}
+
+inline bool boxesIntersect(const BoundingBox &lhs, const BoundingBox &rhs) {
+  return !(lhs.xmax < rhs.xmin || rhs.xmax < lhs.xmin || lhs.ymax < rhs.ymin ||
+           rhs.ymax < lhs.ymin);
+}
+
+inline BoundingBox boxUnion(const BoundingBox &lhs, const BoundingBox &rhs) {
+  return BoundingBox(std::min(lhs.xmin, rhs.xmin), std::max(lhs.xmax, rhs.xmax),
+                     std::min(lhs.ymin, rhs.ymin), std::max(lhs.ymax, rhs.ymax));
+}
+
+/**
+ * @brief Static bounding box tree packed with Sort-Tile-Recursive.
+ *
+ * Every level is a flat array and children of a node are a contiguous range of
+ * the level below, so the tree is a handful of vectors without pointers.
+ * Items are identified by their index in the vector of boxes passed to the constructor.
+ */
+class BBoxTree {
+  struct Node {
+    BoundingBox box;
+    std::uint32_t first;
+    std::uint32_t count;
+  };
+
+  // levels_[0] nodes point into items_, levels_[i] nodes point into levels_[i - 1]
+  std::vector<std::vector<Node>> levels_;
+  std::vector<std::uint32_t> items_;
+  std::vector<BoundingBox> item_boxes_;
+
+public:
+  static constexpr std::size_t kDefaultNodeCapacity = 16;
+  // Items are indexed by uint32 and every node holds at least two children
+  static constexpr std::size_t kMaxDepth = 32;
+
+  BBoxTree() = default;
+
+  explicit BBoxTree(const std::vector<BoundingBox> &boxes,
+                    std::size_t node_capacity = kDefaultNodeCapacity) {
+    if (node_capacity < 2) {
+      throw std::runtime_error("node_capacity must be >= 2");
+    }
+
+    std::vector<std::uint32_t> order(boxes.size());
+    std::iota(order.begin(), order.end(), 0);
+    packLevel(order, boxes, node_capacity);
+
+    items_ = std::move(order);
+    item_boxes_.reserve(items_.size());
+    for (auto item : items_) {
+      item_boxes_.push_back(boxes[item]);
+    }
+
+    levels_.push_back(groupNodes(item_boxes_, node_capacity));
+
+    while (levels_.back().size() > 1) {
+      std::vector<BoundingBox> node_boxes;
+      for (const auto &node : levels_.back()) {
+        node_boxes.push_back(node.box);
+      }
+
+      // Nodes of a level are packed again before grouping, so the level below is reordered too
+      std::vector<std::uint32_t> node_order(node_boxes.size());
+      std::iota(node_order.begin(), node_order.end(), 0);
+      packLevel(node_order, node_boxes, node_capacity);
+      reorderLevel(node_order);
+
+      std::vector<BoundingBox> packed_boxes;
+      for (auto idx : node_order) {
+        packed_boxes.push_back(node_boxes[idx]);
+      }
+      levels_.push_back(groupNodes(packed_boxes, node_capacity));
+    }
+  }
+
+  std::size_t size() const { return items_.size(); }
+
+  std::size_t depth() const { return levels_.size(); }
+
+  /**
+   * @brief Visit items whose boxes contain the point
+   *
+   * @param visitor Called with the item index; returns true to stop the search
+   * @return true if the visitor stopped the search
+   */
+  template <typename Visitor>
+  bool query(Point2d point, Visitor &&visitor) const {
+    return search([point](const BoundingBox &box) { return boxContains(box, point); },
+                  visitor);
+  }
+
+  /**
+   * @brief Visit items whose boxes intersect the box
+   *
+   * @param visitor Called with the item index; returns true to stop the search
+   * @return true if the visitor stopped the search
+   */
+  template <typename Visitor>
+  bool query(const BoundingBox &box, Visitor &&visitor) const {
+    return search([&box](const BoundingBox &other) { return boxesIntersect(other, box); },
+                  visitor);
+  }
+
+private:
+  template <typename Predicate, typename Visitor>
+  bool search(Predicate &&predicate, Visitor &visitor) const {
+    if (levels_.empty() || items_.empty()) {
+      return false;
+    }
+
+    // Nodes still to visit on every level of the current path, so the stack never allocates
+    struct Range {
+      std::uint32_t next;
+      std::uint32_t end;
+    };
+    std::array<Range, kMaxDepth> ranges;
+
+    const std::uint32_t top = static_cast<std::uint32_t>(levels_.size() - 1);
+    std::uint32_t level = top;
+    ranges[level] = Range{0, static_cast<std::uint32_t>(levels_[level].size())};
+
+    while (true) {
+      Range &range = ranges[level];
+      if (range.next == range.end) {
+        if (level == top) {
+          return false;
+        }
+        ++level;
+        continue;
+      }
+
+      const Node &node = levels_[level][range.next++];
+      if (!predicate(node.box)) {
+        continue;
+      }
+
+      if (level == 0) {
+        for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+          if (predicate(item_boxes_[i]) && visitor(items_[i])) {
+            return true;
+          }
+        }
+        continue;
+      }
+
+      --level;
+      ranges[level] = Range{node.first, node.first + node.count};
+    }
+  }
+
+  // Sort-Tile-Recursive: sort by x center, cut into vertical slices, sort every slice by y center
+  static void packLevel(std::vector<std::uint32_t> &order,
+                        const std::vector<BoundingBox> &boxes,
+                        std::size_t node_capacity) {
+    auto center_x = [&boxes](std::uint32_t idx) { return boxes[idx].xmin + boxes[idx].xmax; };
+    auto center_y = [&boxes](std::uint32_t idx) { return boxes[idx].ymin + boxes[idx].ymax; };
+
+    std::sort(order.begin(), order.end(), [&center_x](std::uint32_t lhs, std::uint32_t rhs) {
+      return center_x(lhs) < center_x(rhs);
+    });
+
+    std::size_t nodes_count = (order.size() + node_capacity - 1) / node_capacity;
+    std::size_t slices_count = std::max<std::size_t>(1, std::ceil(std::sqrt(nodes_count)));
+    std::size_t slice_size = slices_count * node_capacity;
+
+    for (std::size_t start = 0; start < order.size(); start += slice_size) {
+      auto end = order.begin() + std::min(order.size(), start + slice_size);
+      std::sort(order.begin() + start, end, [&center_y](std::uint32_t lhs, std::uint32_t rhs) {
+        return center_y(lhs) < center_y(rhs);
+      });
+    }
+  }
+
+  static std::vector<Node> groupNodes(const std::vector<BoundingBox> &boxes,
+                                      std::size_t node_capacity) {
+    std::vector<Node> nodes;
+
+    for (std::size_t start = 0; start < boxes.size(); start += node_capacity) {
+      std::size_t end = std::min(boxes.size(), start + node_capacity);
+      BoundingBox box = boxes[start];
+      for (std::size_t i = start + 1; i < end; ++i) {
+        box = boxUnion(box, boxes[i]);
+      }
+      nodes.push_back(Node{box, static_cast<std::uint32_t>(start),
+                           static_cast<std::uint32_t>(end - start)});
+    }
+
+    if (nodes.empty()) {
+      nodes.push_back(Node{BoundingBox(), 0, 0});
+    }
+
+    return nodes;
+  }
+
+  void reorderLevel(const std::vector<std::uint32_t> &order) {
+    std::vector<Node> reordered;
+    reordered.reserve(order.size());
+    for (auto idx : order) {
+      reordered.push_back(levels_.back()[idx]);
+    }
+    levels_.back() = std::move(reordered);
+  }
+};
+
+} // namespace algorithms
+} // namespace graph
@@ -0,0 +1,408 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/thread_pool.h>
+
+namespace graph {
+namespace algorithms {
+
+enum class Connectivity {
+    // Vertices connected ignoring edge directions
+    Weak,
+    // Vertices reachable from each other
+    Strong,
+};
+
+struct ComponentStats {
+    size_t vertices = 0;
+    // Edges with both ends in the component
+    size_t edges = 0;
+};
+
+/**
+ * @brief Partition of graph vertices into components numbered by decreasing size,
+ * so component 0 is the largest one
+ */
+struct Components {
+    std::vector<std::uint32_t> component_of;
+    std::vector<ComponentStats> stats;
+
+    size_t count() const {
+        return stats.size();
+    }
+
+    size_t largest_size() const {
+        return stats.empty() ? 0 : stats[0].vertices;
+    }
+};
+
+namespace detail {
+
+using ComponentIndex = std::uint32_t;
+constexpr ComponentIndex kNoPart = std::numeric_limits<ComponentIndex>::max();
+
+// Concurrent union-find: roots are only ever linked under smaller roots, so parents decrease
+// along every path and links from several threads can not make a cycle
+class ConcurrentUnionFind {
+   public:
+    explicit ConcurrentUnionFind(size_t count) : parent_(count) {
+        for (size_t v = 0; v < count; v++) {
+            parent_[v].store(v, std::memory_order_relaxed);
+        }
+    }
+
+    ComponentIndex find(ComponentIndex v) {
+        while (true) {
+            ComponentIndex parent = parent_[v].load(std::memory_order_relaxed);
+            if (parent == v) {
+                return v;
+            }
+            // Path halving; a failed exchange only means someone else shortened the path
+            ComponentIndex grandparent = parent_[parent].load(std::memory_order_relaxed);
+            if (grandparent != parent) {
+                parent_[v].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+            }
+            v = grandparent;
+        }
+    }
+
+    void unite(ComponentIndex u, ComponentIndex v) {
+        while (true) {
+            u = find(u);
+            v = find(v);
+            if (u == v) {
+                return;
+            }
+            if (u < v) {
+                std::swap(u, v);
+            }
+            ComponentIndex expected = u;
+            if (parent_[u].compare_exchange_strong(expected, v, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+   private:
+    std::vector<std::atomic<ComponentIndex>> parent_;
+};
+
+// Turns representative vertices into component ids by decreasing size and counts the edges
+template <typename Vertex>
+Components number_components(const CompiledGraph<Vertex>& graph, const std::vector<ComponentIndex>& representative) {
+    const size_t count = graph.vertices_count();
+    std::vector<size_t> sizes(count, 0);
+    for (auto root : representative) {
+        sizes[root]++;
+    }
+
+    std::vector<ComponentIndex> roots;
+    for (ComponentIndex v = 0; v < count; v++) {
+        if (sizes[v] > 0) {
+            roots.push_back(v);
+        }
+    }
+    std::sort(roots.begin(), roots.end(), [&sizes](ComponentIndex lhs, ComponentIndex rhs) {
+        return std::make_pair(sizes[rhs], lhs) < std::make_pair(sizes[lhs], rhs);
+    });
+
+    std::vector<ComponentIndex> id_of_root(count, kNoPart);
+    Components res;
+    res.stats.resize(roots.size());
+    for (ComponentIndex id = 0; id < roots.size(); id++) {
+        id_of_root[roots[id]] = id;
+        res.stats[id].vertices = sizes[roots[id]];
+    }
+
+    res.component_of.resize(count);
+    for (ComponentIndex v = 0; v < count; v++) {
+        res.component_of[v] = id_of_root[representative[v]];
+    }
+    for (ComponentIndex v = 0; v < count; v++) {
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            if (res.component_of[graph.target(edge)] == res.component_of[v]) {
+                res.stats[res.component_of[v]].edges++;
+            }
+        }
+    }
+    return res;
+}
+
+template <typename Vertex>
+std::vector<ComponentIndex> weak_representatives(const CompiledGraph<Vertex>& graph, ThreadPool& pool) {
+    const size_t count = graph.vertices_count();
+    ConcurrentUnionFind union_find(count);
+
+    pool.parallel_for(count, [&](size_t v, int) {
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            union_find.unite(v, graph.target(edge));
+        }
+    }, 4096, "weak_components");
+
+    std::vector<ComponentIndex> representative(count);
+    pool.parallel_for(count, [&](size_t v, int) {
+        representative[v] = union_find.find(v);
+    }, 4096, "weak_components");
+    return representative;
+}
+
+// Vertices of the part reachable from pivot without leaving the part
+template <SearchDirection Direction, typename Vertex>
+std::vector<bool> reachable_in_part(
+    const CompiledGraph<Vertex>& graph,
+    const std::vector<ComponentIndex>& part,
+    ComponentIndex pivot
+) {
+    std::vector<bool> reached(graph.vertices_count(), false);
+    std::vector<ComponentIndex> queue = {pivot};
+    reached[pivot] = true;
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        graph.template for_each_edge<Direction>(queue[head], [&](ComponentIndex u, float) {
+            if (!reached[u] && part[u] == part[pivot]) {
+                reached[u] = true;
+                queue.push_back(u);
+            }
+        });
+    }
+    return reached;
+}
+
+// Per-thread stacks of the iterative Tarjan search
+struct TarjanWorkspace {
+    std::vector<std::pair<ComponentIndex, std::uint32_t>> calls;
+    std::vector<ComponentIndex> stack;
+};
+
+/**
+ * Tarjan search over the vertices of one part following only edges inside the part; marks every
+ * strongly connected component by its root vertex. Parts are closed under strong connectivity,
+ * so different parts run concurrently on the shared arrays.
+ */
+template <typename Vertex>
+void tarjan_in_part(
+    const CompiledGraph<Vertex>& graph,
+    const std::vector<ComponentIndex>& part,
+    const ComponentIndex* part_begin,
+    const ComponentIndex* part_end,
+    std::vector<ComponentIndex>& visit_order,
+    std::vector<ComponentIndex>& low,
+    std::vector<char>& on_stack,
+    std::vector<ComponentIndex>& representative,
+    TarjanWorkspace& workspace
+) {
+    auto& calls = workspace.calls;
+    auto& stack = workspace.stack;
+    ComponentIndex counter = 0;
+
+    auto visit = [&](ComponentIndex v) {
+        visit_order[v] = low[v] = counter++;
+        on_stack[v] = true;
+        stack.push_back(v);
+        calls.push_back({v, graph.first_edge(v)});
+    };
+
+    for (auto it = part_begin; it != part_end; it++) {
+        if (visit_order[*it] != kNoPart) {
+            continue;
+        }
+        visit(*it);
+
+        while (!calls.empty()) {
+            auto [v, edge] = calls.back();
+
+            if (edge < graph.last_edge(v)) {
+                calls.back().second++;
+                ComponentIndex u = graph.target(edge);
+                if (part[u] != part[v]) {
+                    continue;
+                }
+                if (visit_order[u] == kNoPart) {
+                    visit(u);
+                } else if (on_stack[u]) {
+                    low[v] = std::min(low[v], visit_order[u]);
+                }
+                continue;
+            }
+
+            calls.pop_back();
+            if (!calls.empty()) {
+                auto caller = calls.back().first;
+                low[caller] = std::min(low[caller], low[v]);
+            }
+            if (low[v] == visit_order[v]) {
+                ComponentIndex w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    on_stack[w] = false;
+                    representative[w] = v;
+                } while (w != v);
+            }
+        }
+    }
+}
+
+template <typename Vertex>
+std::vector<ComponentIndex> strong_representatives(const CompiledGraph<Vertex>& graph, ThreadPool& pool) {
+    const ComponentIndex count = graph.vertices_count();
+    std::vector<ComponentIndex> representative(count, kNoPart);
+    // Strongly connected components never cross weak ones, so they are the first parts
+    std::vector<ComponentIndex> part = weak_representatives(graph, pool);
+
+    std::vector<ComponentIndex> part_sizes(count, 0);
+    for (auto root : part) {
+        part_sizes[root]++;
+    }
+
+    // One forward-backward step splits the parts too large to leave to a single thread:
+    // vertices reachable both from and to a pivot are its component, the ones reachable only
+    // one way or not at all form three new parts closed under strong connectivity
+    const size_t split_size = std::max<size_t>(1 << 14, count / (2 * pool.size()));
+    if (graph.has_transposed() && pool.size() > 1) {
+        for (ComponentIndex root = 0; root < count; root++) {
+            if (part_sizes[root] < split_size) {
+                continue;
+            }
+
+            ComponentIndex pivot = root;
+            size_t pivot_degree = 0;
+            for (ComponentIndex v = 0; v < count; v++) {
+                size_t degree = size_t{graph.out_degree(v)} * (graph.last_in_edge(v) - graph.first_in_edge(v));
+                if (part[v] == root && degree > pivot_degree) {
+                    pivot = v;
+                    pivot_degree = degree;
+                }
+            }
+
+            std::vector<bool> forward;
+            std::vector<bool> backward;
+            pool.parallel_for(2, [&](size_t side, int) {
+                if (side == 0) {
+                    forward = reachable_in_part<SearchDirection::Forward>(graph, part, pivot);
+                } else {
+                    backward = reachable_in_part<SearchDirection::Backward>(graph, part, pivot);
+                }
+            }, 1, "strong_components");
+
+            // New parts are named by their first vertex like the weak ones
+            ComponentIndex first_forward = kNoPart;
+            ComponentIndex first_backward = kNoPart;
+            ComponentIndex first_rest = kNoPart;
+            for (ComponentIndex v = 0; v < count; v++) {
+                if (part[v] != root) {
+                    continue;
+                }
+                if (forward[v] && backward[v]) {
+                    representative[v] = pivot;
+                    part[v] = kNoPart;
+                } else if (forward[v] || backward[v]) {
+                    auto& first = forward[v] ? first_forward : first_backward;
+                    first = std::min(first, v);
+                    part[v] = first;
+                } else {
+                    first_rest = std::min(first_rest, v);
+                    part[v] = first_rest;
+                }
+            }
+        }
+    }
+
+    // Vertices grouped by part, largest parts first so they do not finish last
+    std::vector<ComponentIndex> vertices;
+    vertices.reserve(count);
+    for (ComponentIndex v = 0; v < count; v++) {
+        if (part[v] != kNoPart) {
+            vertices.push_back(v);
+        }
+    }
+    std::fill(part_sizes.begin(), part_sizes.end(), 0);
+    for (auto v : vertices) {
+        part_sizes[part[v]]++;
+    }
+    std::stable_sort(vertices.begin(), vertices.end(), [&](ComponentIndex lhs, ComponentIndex rhs) {
+        return std::make_pair(part_sizes[part[rhs]], part[lhs]) < std::make_pair(part_sizes[part[lhs]], part[rhs]);
+    });
+    std::vector<size_t> part_starts;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        if (i == 0 || part[vertices[i]] != part[vertices[i - 1]]) {
+            part_starts.push_back(i);
+        }
+    }
+    part_starts.push_back(vertices.size());
+
+    std::vector<ComponentIndex> visit_order(count, kNoPart);
+    std::vector<ComponentIndex> low(count);
+    std::vector<char> on_stack(count, false);
+    std::vector<TarjanWorkspace> workspaces(pool.size());
+
+    pool.parallel_for(part_starts.size() - 1, [&](size_t idx, int worker_id) {
+        tarjan_in_part(
+            graph, part, vertices.data() + part_starts[idx], vertices.data() + part_starts[idx + 1],
+            visit_order, low, on_stack, representative, workspaces[worker_id]
+        );
+    }, 1, "strong_components");
+    return representative;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Weakly or strongly connected components with their sizes.
+ *
+ * Weak components come from a concurrent union-find over the edges split between the pool
+ * workers. Strong components are searched by Tarjan's algorithm inside every weak component,
+ * weak components running in parallel. When the graph has the transposed adjacency, weak
+ * components too large for one worker are first split by a forward-backward step, whose two
+ * searches also run in parallel.
+ */
+template <typename Vertex>
+Components connected_components(
+    const CompiledGraph<Vertex>& graph,
+    Connectivity connectivity = Connectivity::Strong,
+    ThreadPool& pool = ThreadPool::shared()
+) {
+    auto representative = connectivity == Connectivity::Weak ? detail::weak_representatives(graph, pool)
+                                                              : detail::strong_representatives(graph, pool);
+    return detail::number_components(graph, representative);
+}
+
+/**
+ * @brief Subgraph of the components with at least min_size vertices; vertices keep their
+ * relative order, so a locality order survives
+ */
+template <typename Vertex>
+CompiledGraph<Vertex> keep_components(const CompiledGraph<Vertex>& graph, const Components& components, size_t min_size) {
+    std::vector<std::uint32_t> vertices;
+    for (std::uint32_t v = 0; v < graph.vertices_count(); v++) {
+        if (components.stats[components.component_of[v]].vertices >= min_size) {
+            vertices.push_back(v);
+        }
+    }
+    return graph.subgraph(vertices);
+}
+
+/**
+ * @brief Subgraph of the largest component only
+ */
+template <typename Vertex>
+CompiledGraph<Vertex> keep_largest_component(const CompiledGraph<Vertex>& graph, const Components& components) {
+    std::vector<std::uint32_t> vertices;
+    for (std::uint32_t v = 0; v < graph.vertices_count(); v++) {
+        if (components.component_of[v] == 0) {
+            vertices.push_back(v);
+        }
+    }
+    return graph.subgraph(vertices);
+}
+
+}  // namespace algorithms
+}  // namespace graph
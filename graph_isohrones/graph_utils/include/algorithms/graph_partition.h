@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Vertices split into shards numbered [0, count())
+ */
+struct GraphPartition {
+    std::vector<std::uint32_t> shard_of;
+    std::vector<size_t> shard_sizes;
+    // Edges between different shards
+    size_t cut_edges = 0;
+
+    size_t count() const {
+        return shard_sizes.size();
+    }
+};
+
+namespace detail {
+
+class GeometricBisection {
+   public:
+    using Index = std::uint32_t;
+
+    GeometricBisection(std::vector<float> x, std::vector<float> y, std::vector<Index> offsets, std::vector<Index> neighbors, double imbalance)
+        : x_(std::move(x)), y_(std::move(y)), offsets_(std::move(offsets)), neighbors_(std::move(neighbors)),
+          imbalance_(imbalance), part_(x_.size(), 0), moved_(x_.size(), false) {}
+
+    // Split vertices into shards [first_shard, first_shard + shards), writing shard ids into part_
+    void split(std::vector<Index>& vertices, Index first_shard, Index shards) {
+        if (shards <= 1 || vertices.size() <= 1) {
+            for (auto v : vertices) {
+                part_[v] = first_shard;
+            }
+            return;
+        }
+
+        Index left_shards = shards / 2;
+        size_t left_size = best_cut(vertices, left_shards, shards);
+        std::vector<Index> right(vertices.begin() + left_size, vertices.end());
+        vertices.resize(left_size);
+        vertices.shrink_to_fit();
+        split(vertices, first_shard, left_shards);
+        split(right, first_shard + left_shards, shards - left_shards);
+    }
+
+    std::vector<Index>& parts() {
+        return part_;
+    }
+
+   private:
+    static constexpr std::array<std::pair<float, float>, 4> kDirections = {{{1, 0}, {0, 1}, {1, 1}, {1, -1}}};
+
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<Index> offsets_;
+    std::vector<Index> neighbors_;
+    double imbalance_;
+    std::vector<Index> part_;
+    std::vector<bool> moved_;
+
+    // Sorts vertices along the direction with the cheapest balanced cut, returns the left size.
+    // Both sides keep at least a vertex per shard, so no shard ends up empty
+    size_t best_cut(std::vector<Index>& vertices, Index left_shards, Index shards) {
+        const size_t count = vertices.size();
+        const double target = count * static_cast<double>(left_shards) / shards;
+        const size_t min_left = left_shards;
+        const size_t max_left = count - (shards - left_shards);
+        size_t lo = std::clamp<size_t>(std::floor(target * (1 - imbalance_)), min_left, max_left);
+        size_t hi = std::clamp<size_t>(std::ceil(target * (1 + imbalance_)), lo, max_left);
+
+        // Vertices of this part are marked, neighbors in other parts do not change the cut
+        constexpr Index kInside = std::numeric_limits<Index>::max();
+        std::vector<std::pair<Index, Index>> saved;
+        saved.reserve(count);
+        for (auto v : vertices) {
+            saved.push_back({v, part_[v]});
+            part_[v] = kInside;
+        }
+
+        size_t best_size = 0;
+        size_t best_cut = std::numeric_limits<size_t>::max();
+        size_t best_direction = 0;
+        std::vector<std::pair<float, Index>> projected(count);
+
+        for (size_t direction = 0; direction < kDirections.size(); direction++) {
+            project(vertices, direction, projected);
+
+            // Move vertices to the left side one by one: edges to moved neighbors leave the cut,
+            // edges to the other ones join it
+            long long cut = 0;
+            for (size_t i = 0; i < hi; i++) {
+                Index v = projected[i].second;
+                for (auto n = offsets_[v]; n < offsets_[v + 1]; n++) {
+                    Index u = neighbors_[n];
+                    if (part_[u] == kInside) {
+                        cut += moved_[u] ? -1 : 1;
+                    }
+                }
+                moved_[v] = true;
+                if (i + 1 >= lo && static_cast<size_t>(cut) < best_cut) {
+                    best_cut = cut;
+                    best_size = i + 1;
+                    best_direction = direction;
+                }
+            }
+            for (size_t i = 0; i < hi; i++) {
+                moved_[projected[i].second] = false;
+            }
+        }
+
+        project(vertices, best_direction, projected);
+        for (size_t i = 0; i < count; i++) {
+            vertices[i] = projected[i].second;
+        }
+        for (const auto& [v, part] : saved) {
+            part_[v] = part;
+        }
+        return best_size;
+    }
+
+    void project(const std::vector<Index>& vertices, size_t direction, std::vector<std::pair<float, Index>>& projected) const {
+        const auto& [dx, dy] = kDirections[direction];
+        for (size_t i = 0; i < vertices.size(); i++) {
+            Index v = vertices[i];
+            projected[i] = {dx * x_[v] + dy * y_[v], v};
+        }
+        std::sort(projected.begin(), projected.end());
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Split the graph into shards by recursive geometric bisection: every split tries cuts
+ * across 4 directions of the x and y coordinates at every position allowed by the balance
+ * constraint and keeps the one crossed by the fewest edges. Shards are contiguous pieces of the
+ * map with sizes within about the imbalance of vertices_count() / shards.
+ *
+ * @param graph Compiled graph with coordinates
+ * @param shards Number of shards
+ * @param imbalance Allowed relative deviation of a split from the balanced size
+ */
+template <typename Vertex>
+GraphPartition geometric_partition(const CompiledGraph<Vertex>& graph, std::uint32_t shards, double imbalance = 0.05) {
+    using Index = std::uint32_t;
+    const size_t count = graph.vertices_count();
+    if (!graph.has_coordinates()) {
+        throw std::runtime_error("Geometric partition needs vertex coordinates");
+    }
+    if (shards == 0 || shards > std::max<size_t>(count, 1)) {
+        throw std::runtime_error("Can not split " + std::to_string(count) + " vertices into " + std::to_string(shards) + " shards");
+    }
+
+    // Undirected adjacency without self-loops: a cut edge costs the same in both directions
+    std::vector<float> x(count), y(count);
+    std::vector<Index> offsets(count + 1, 0);
+    for (Index v = 0; v < count; v++) {
+        x[v] = graph.x(v);
+        y[v] = graph.y(v);
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            if (graph.target(edge) != v) {
+                offsets[v + 1]++;
+                offsets[graph.target(edge) + 1]++;
+            }
+        }
+    }
+    for (size_t v = 0; v < count; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<Index> neighbors(offsets[count]);
+    std::vector<Index> fill(offsets.begin(), offsets.end() - 1);
+    for (Index v = 0; v < count; v++) {
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            Index u = graph.target(edge);
+            if (u != v) {
+                neighbors[fill[v]++] = u;
+                neighbors[fill[u]++] = v;
+            }
+        }
+    }
+
+    detail::GeometricBisection bisection(std::move(x), std::move(y), std::move(offsets), std::move(neighbors), imbalance);
+    std::vector<Index> vertices(count);
+    for (Index v = 0; v < count; v++) {
+        vertices[v] = v;
+    }
+    bisection.split(vertices, 0, shards);
+
+    GraphPartition res;
+    res.shard_of = std::move(bisection.parts());
+    res.shard_sizes.assign(shards, 0);
+    for (Index v = 0; v < count; v++) {
+        res.shard_sizes[res.shard_of[v]]++;
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            res.cut_edges += res.shard_of[v] != res.shard_of[graph.target(edge)];
+        }
+    }
+    return res;
+}
+
+}  // namespace algorithms
+}  // namespace graph
@@ -37,9 +37,9 @@ struct BoundingBox {
 
   BoundingBox() {
     this->xmin = std::numeric_limits<double>::max();
-    this->xmax = std::numeric_limits<double>::min();
+    this->xmax = std::numeric_limits<double>::lowest();
     this->ymin = std::numeric_limits<double>::max();
-    this->ymax = std::numeric_limits<double>::min();
+    this->ymax = std::numeric_limits<double>::lowest();
   }
 };
 
@@ -69,7 +69,7 @@ struct LightSimplePolygon {
     calcBoundingBox();
   }
 
-  bool inBoundingBox(Point2d point) {
+  bool inBoundingBox(Point2d point) const {
     if (point.x < bbox.xmin || point.x > bbox.xmax || point.y < bbox.ymin ||
         point.y > bbox.ymax) {
       return false;
@@ -78,11 +78,11 @@ struct LightSimplePolygon {
     }
   }
 
-  bool contains(double lon, double lat) {
+  bool contains(double lon, double lat) const {
     return this->contains(Point2d{lon, lat});
   }
 
-  bool contains(Point2d point) {
+  bool contains(Point2d point) const {
     if (!inBoundingBox(point)) {
       return false;
     }
@@ -105,7 +105,7 @@ struct LightSimplePolygon {
     return (intersections % 2 != 0);
   }
 
-  double direction(Point2d pi, Point2d pj, Point2d pk) {
+  double direction(Point2d pi, Point2d pj, Point2d pk) const {
     return (pk.x - pi.x) * (pj.y - pi.y) - (pj.x - pi.x) * (pk.y - pi.y);
   }
 
@@ -118,7 +118,7 @@ struct LightSimplePolygon {
   //   }
   // }
 
-  bool segmentIntersect(Point2d p1, Point2d p2, Point2d p3, Point2d p4) {
+  bool segmentIntersect(Point2d p1, Point2d p2, Point2d p3, Point2d p4) const {
     auto d1 = direction(p3, p4, p1);
     auto d2 = direction(p3, p4, p2);
     auto d3 = direction(p1, p2, p3);
@@ -147,12 +147,14 @@ private:
     for (const auto &point : points) {
       if (point.x < bbox.xmin) {
         bbox.xmin = point.x;
-      } else if (point.x > bbox.xmax) {
+      }
+      if (point.x > bbox.xmax) {
         bbox.xmax = point.x;
       }
       if (point.y < bbox.ymin) {
         bbox.ymin = point.y;
-      } else if (point.y > bbox.ymax) {
+      }
+      if (point.y > bbox.ymax) {
         bbox.ymax = point.y;
       }
     }
@@ -181,12 +183,12 @@ struct LightPolygon {
     }
   }
 
-  bool contains(double lon, double lat) {
+  bool contains(double lon, double lat) const {
     return this->contains(Point2d{lon, lat});
   }
 
-  bool contains(Point2d point) {
-    for (auto hole : internal_polygons_vec) {
+  bool contains(Point2d point) const {
+    for (const auto &hole : internal_polygons_vec) {
       if (hole.contains(point)) {
         return false;
       }
@@ -215,12 +217,12 @@ struct LightMultiPolygon {
     }
   }
 
-  bool contains(double lon, double lat) {
+  bool contains(double lon, double lat) const {
     return this->contains(Point2d{lon, lat});
   }
 
-  bool contains(Point2d point) {
-    for (auto polygon : polygons_vec) {
+  bool contains(Point2d point) const {
+    for (const auto &polygon : polygons_vec) {
       if (polygon.contains(point)) {
         return true;
       }
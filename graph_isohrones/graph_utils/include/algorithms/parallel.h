@@ -1,52 +1,96 @@
 #pragma once
 
-#include <condition_variable>
 #include <cstddef>
 #include <type_traits>
+#include <utility>
 #include <vector>
-#include <mutex>
-#include <thread>
+#include <algorithms/thread_pool.h>
+#include <algorithms/thread_pool_telemetry.h>
 
 namespace graph {
 namespace algorithms {
 
+namespace detail {
+
 template<typename Data, typename Task>
 std::vector<typename std::invoke_result<Task, const Data&, int>::type> run_in_threads(
-// std::vector<typename std::result_of<Task(const Data&, int)>::type> run_in_threads(
     const std::vector<Data>& data,
     const int n_threads,
-    Task&& task
+    Task&& task,
+    PoolTelemetry* telemetry,
+    std::vector<TraceEvent>* trace
 ) {
     using ReturnType = typename std::invoke_result<Task, const Data&, int>::type;
-    // using ReturnType = typename std::result_of<Task(const Data&, int)>::type;
-
-    auto iter = data.begin();
-    int batch_size = data.size() / n_threads + 1;
-    std::vector<std::thread> workers;
     static_assert(std::is_default_constructible<ReturnType>::value, "ReturnType is not default constructible");
     std::vector<ReturnType> results(data.size());
 
-    for (int thread_id = 0; thread_id < n_threads; ++thread_id) {
-        workers.push_back(
-            std::thread(
-                [&data, &task, &results, batch_size, thread_id]{
-                    size_t batch_start = batch_size * thread_id;
-                    size_t batch_end = std::min(data.size(), batch_start + batch_size);
-
-                    for (size_t itm_idx = batch_start; itm_idx < batch_end; itm_idx++) {
-                        results.data()[itm_idx] = task(data[itm_idx], thread_id);
-                    }
-                }
-            )
-        );
+    // At most n_threads batches of consecutive items, the same split as before the pool.
+    // Batches are queued per worker and idle workers steal them, so a thread may run several
+    // batches or none, but a batch is never divided: skewed items are not rebalanced.
+    // Callers that need balancing use ThreadPool::parallel_for with a smaller grain.
+    size_t batch_size = data.size() / n_threads + 1;
+    ThreadPool pool(n_threads);
+
+    if (trace) {
+        pool.start_trace();
     }
 
-    for (auto& worker : workers) {
-        worker.join();
+    pool.parallel_for(data.size(), [&data, &task, &results](size_t itm_idx, int thread_id) {
+        results.data()[itm_idx] = task(data[itm_idx], thread_id);
+    }, batch_size, "run_in_threads");
+
+    if (telemetry) {
+        *telemetry = pool.telemetry();
+    }
+    if (trace) {
+        *trace = pool.stop_trace();
     }
 
     return results;
 }
 
+}  // namespace detail
+
+template<typename Data, typename Task>
+std::vector<typename std::invoke_result<Task, const Data&, int>::type> run_in_threads(
+    const std::vector<Data>& data,
+    const int n_threads,
+    Task&& task
+) {
+    return detail::run_in_threads(data, n_threads, std::forward<Task>(task), nullptr, nullptr);
+}
+
+/**
+ * @brief run_in_threads which also reports the load of every thread
+ *
+ * @param telemetry Filled with per-thread busy time, task counts, steals and queue waits of the run
+ */
+template<typename Data, typename Task>
+std::vector<typename std::invoke_result<Task, const Data&, int>::type> run_in_threads(
+    const std::vector<Data>& data,
+    const int n_threads,
+    Task&& task,
+    PoolTelemetry& telemetry
+) {
+    return detail::run_in_threads(data, n_threads, std::forward<Task>(task), &telemetry, nullptr);
+}
+
+/**
+ * @brief run_in_threads which also reports the load of every thread and records a trace of the run
+ *
+ * @param telemetry Filled with per-thread busy time, task counts, steals and queue waits of the run
+ * @param trace Filled with an event per batch, see write_chrome_trace
+ */
+template<typename Data, typename Task>
+std::vector<typename std::invoke_result<Task, const Data&, int>::type> run_in_threads(
+    const std::vector<Data>& data,
+    const int n_threads,
+    Task&& task,
+    PoolTelemetry& telemetry,
+    std::vector<TraceEvent>& trace
+) {
+    return detail::run_in_threads(data, n_threads, std::forward<Task>(task), &telemetry, &trace);
+}
+
+}
 }
-}
\ No newline at end of file
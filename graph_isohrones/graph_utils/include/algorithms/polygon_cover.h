@@ -0,0 +1,373 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+#include <algorithms/light_polygon.h>
+#include <algorithms/parallel.h>
+#include <geo_utils/geohash.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Which cells get into a polygon cover
+ *
+ * Center: cells whose center lies inside the polygon (even-odd rule, so holes are excluded)
+ * Intersects: cells which share any point with the polygon; a superset of Center
+ */
+enum class CoverMode {
+    Center,
+    Intersects
+};
+
+/**
+ * @brief Cell of a mixed precision cover
+ */
+struct CoverCell {
+    std::uint64_t code;
+    int precision;
+
+    bool operator==(const CoverCell& other) const {
+        return code == other.code && precision == other.precision;
+    }
+};
+
+namespace detail {
+
+constexpr int kMinRowsPerChunk = 16;
+constexpr int kChunksPerThread = 8;
+
+struct CoverEdge {
+    double ax;
+    double ay;
+    double bx;
+    double by;
+    std::int64_t row_lo;
+    std::int64_t row_hi;
+};
+
+/**
+ * @brief Edges of one polygon bucketed by chunks of grid rows
+ */
+struct CoverRows {
+    std::int64_t row_lo = 0;
+    std::int64_t row_hi = -1;
+    std::int64_t rows_per_chunk = kMinRowsPerChunk;
+    std::vector<std::vector<CoverEdge>> chunks;
+};
+
+inline std::int64_t lat_to_row(double lat, std::uint64_t dim) {
+    auto row = static_cast<std::int64_t>(std::floor((lat - geo_utils::geohash::kLatIntervalMin) / 180.0 * dim));
+    return std::clamp<std::int64_t>(row, 0, dim - 1);
+}
+
+inline std::int64_t lon_to_col(double lon, std::uint64_t dim) {
+    auto col = static_cast<std::int64_t>(std::floor((lon - geo_utils::geohash::kLonIntervalMin) / 360.0 * dim));
+    return std::clamp<std::int64_t>(col, 0, dim - 1);
+}
+
+inline void add_ring_edges(const std::vector<Point2d>& points, std::uint64_t dim, std::vector<CoverEdge>& edges) {
+    for (size_t i = 0; i < points.size(); i++) {
+        const Point2d& a = points[i];
+        const Point2d& b = points[(i + 1) % points.size()];
+        edges.push_back(CoverEdge{
+            a.x, a.y, b.x, b.y,
+            lat_to_row(std::min(a.y, b.y), dim),
+            lat_to_row(std::max(a.y, b.y), dim)
+        });
+    }
+}
+
+inline CoverRows prepare_cover_rows(const LightMultiPolygon& polygon, std::uint64_t dim, int n_threads) {
+    CoverRows rows;
+    std::vector<CoverEdge> edges;
+
+    for (const auto& part : polygon.polygons_vec) {
+        add_ring_edges(part.external_polygon.points, dim, edges);
+
+        for (const auto& hole : part.internal_polygons_vec) {
+            add_ring_edges(hole.points, dim, edges);
+        }
+    }
+
+    if (edges.empty()) {
+        return rows;
+    }
+
+    rows.row_lo = edges.front().row_lo;
+    rows.row_hi = edges.front().row_hi;
+
+    for (const auto& edge : edges) {
+        rows.row_lo = std::min(rows.row_lo, edge.row_lo);
+        rows.row_hi = std::max(rows.row_hi, edge.row_hi);
+    }
+
+    std::int64_t rows_count = rows.row_hi - rows.row_lo + 1;
+    rows.rows_per_chunk = std::max<std::int64_t>(kMinRowsPerChunk, rows_count / (std::max(n_threads, 1) * kChunksPerThread) + 1);
+    rows.chunks.resize((rows_count + rows.rows_per_chunk - 1) / rows.rows_per_chunk);
+
+    for (const auto& edge : edges) {
+        std::int64_t chunk_lo = (edge.row_lo - rows.row_lo) / rows.rows_per_chunk;
+        std::int64_t chunk_hi = (edge.row_hi - rows.row_lo) / rows.rows_per_chunk;
+
+        for (std::int64_t chunk = chunk_lo; chunk <= chunk_hi; chunk++) {
+            rows.chunks[chunk].push_back(edge);
+        }
+    }
+
+    for (auto& chunk : rows.chunks) {
+        std::sort(chunk.begin(), chunk.end(), [](const CoverEdge& lhs, const CoverEdge& rhs) {
+            return lhs.row_lo < rhs.row_lo;
+        });
+    }
+
+    return rows;
+}
+
+/**
+ * @brief Rasterize one chunk of rows with an active edge list
+ *
+ * @return Hilbert codes of the covered cells in the chunk, unsorted
+ */
+inline std::vector<std::uint64_t> cover_chunk(const CoverRows& rows, size_t chunk_idx, std::uint64_t dim, CoverMode mode) {
+    const double lat_step = 180.0 / dim;
+    const double lon_step = 360.0 / dim;
+    const std::vector<CoverEdge>& edges = rows.chunks[chunk_idx];
+    std::int64_t chunk_row_lo = rows.row_lo + chunk_idx * rows.rows_per_chunk;
+    std::int64_t chunk_row_hi = std::min(rows.row_hi, chunk_row_lo + rows.rows_per_chunk - 1);
+
+    std::vector<std::uint64_t> codes;
+    std::vector<const CoverEdge*> active;
+    std::vector<double> crossings;
+    std::vector<std::pair<std::int64_t, std::int64_t>> spans;
+    size_t next_edge = 0;
+
+    for (std::int64_t row = chunk_row_lo; row <= chunk_row_hi; row++) {
+        while (next_edge < edges.size() && edges[next_edge].row_lo <= row) {
+            active.push_back(&edges[next_edge]);
+            next_edge++;
+        }
+
+        active.erase(
+            std::remove_if(active.begin(), active.end(), [row](const CoverEdge* edge) { return edge->row_hi < row; }),
+            active.end()
+        );
+
+        if (active.empty()) {
+            continue;
+        }
+
+        double band_lo = geo_utils::geohash::kLatIntervalMin + row * lat_step;
+        double band_hi = band_lo + lat_step;
+        double center_lat = band_lo + lat_step / 2;
+        crossings.clear();
+        spans.clear();
+
+        for (const CoverEdge* edge : active) {
+            // Half open rule: an edge crosses the scanline iff exactly one end is above it
+            if ((edge->ay <= center_lat) != (edge->by <= center_lat)) {
+                double t = (center_lat - edge->ay) / (edge->by - edge->ay);
+                crossings.push_back(edge->ax + t * (edge->bx - edge->ax));
+            }
+
+            if (mode == CoverMode::Intersects) {
+                // A segment is monotonic in x, so its part within the band covers a contiguous run of cells
+                double x_lo = edge->ax;
+                double x_hi = edge->bx;
+
+                if (edge->ay != edge->by) {
+                    double t_lo = std::clamp((band_lo - edge->ay) / (edge->by - edge->ay), 0.0, 1.0);
+                    double t_hi = std::clamp((band_hi - edge->ay) / (edge->by - edge->ay), 0.0, 1.0);
+                    x_lo = edge->ax + t_lo * (edge->bx - edge->ax);
+                    x_hi = edge->ax + t_hi * (edge->bx - edge->ax);
+                }
+
+                if (x_lo > x_hi) {
+                    std::swap(x_lo, x_hi);
+                }
+
+                spans.push_back({lon_to_col(x_lo, dim), lon_to_col(x_hi, dim)});
+            }
+        }
+
+        std::sort(crossings.begin(), crossings.end());
+
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+            // Cells whose center lon is in [crossings[i], crossings[i + 1])
+            double col_lo = std::ceil((crossings[i] - geo_utils::geohash::kLonIntervalMin) / lon_step - 0.5);
+            double col_hi = std::ceil((crossings[i + 1] - geo_utils::geohash::kLonIntervalMin) / lon_step - 0.5) - 1;
+            col_lo = std::max<double>(col_lo, 0);
+            col_hi = std::min<double>(col_hi, dim - 1);
+
+            if (col_lo <= col_hi) {
+                spans.push_back({static_cast<std::int64_t>(col_lo), static_cast<std::int64_t>(col_hi)});
+            }
+        }
+
+        std::sort(spans.begin(), spans.end());
+        std::int64_t next_col = 0;
+
+        for (const auto& span : spans) {
+            for (std::int64_t col = std::max(span.first, next_col); col <= span.second; col++) {
+                codes.push_back(geo_utils::geohash::xy2hash(col, row, dim));
+            }
+            next_col = std::max(next_col, span.second + 1);
+        }
+    }
+
+    return codes;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Cover polygons with geohash cells of a single precision by scanline rasterization.
+ * Work is split into chunks of grid rows and all (polygon, chunk) pairs run in parallel.
+ *
+ * @param polygons Polygons to cover; coordinates are lon/lat
+ * @param precision The number of characters in a geohash
+ * @param bits_per_char The number of bits per coding character
+ * @param n_threads Number of parallel running threads
+ * @param mode Which cells get into the cover
+ * @return Sorted Hilbert codes of covered cells for every polygon
+ */
+inline std::vector<std::vector<std::uint64_t>> polygon_cover(
+    const std::vector<LightMultiPolygon>& polygons,
+    int precision = geo_utils::geohash::kDefaultPrecision,
+    int bits_per_char = geo_utils::geohash::kDefaultBitsPerChar,
+    int n_threads = 1,
+    CoverMode mode = CoverMode::Center
+) {
+    int level = geo_utils::geohash::code_level(precision, bits_per_char);
+    std::uint64_t dim = 1ull << level;
+    std::vector<size_t> polygon_ids(polygons.size());
+    std::iota(polygon_ids.begin(), polygon_ids.end(), 0);
+
+    auto rows_vec = run_in_threads(polygon_ids, n_threads, [&polygons, dim, n_threads](size_t polygon_idx, int thread_num) {
+        return detail::prepare_cover_rows(polygons[polygon_idx], dim, n_threads);
+    });
+
+    std::vector<std::pair<size_t, size_t>> tasks;
+
+    for (size_t polygon_idx = 0; polygon_idx < polygons.size(); polygon_idx++) {
+        for (size_t chunk_idx = 0; chunk_idx < rows_vec[polygon_idx].chunks.size(); chunk_idx++) {
+            tasks.push_back({polygon_idx, chunk_idx});
+        }
+    }
+
+    auto chunk_codes = run_in_threads(tasks, n_threads, [&rows_vec, dim, mode](const std::pair<size_t, size_t>& task, int thread_num) {
+        return detail::cover_chunk(rows_vec[task.first], task.second, dim, mode);
+    });
+
+    std::vector<std::vector<std::uint64_t>> res(polygons.size());
+
+    for (size_t task_idx = 0; task_idx < tasks.size(); task_idx++) {
+        auto& codes = res[tasks[task_idx].first];
+        codes.insert(codes.end(), chunk_codes[task_idx].begin(), chunk_codes[task_idx].end());
+    }
+
+    return run_in_threads(polygon_ids, n_threads, [&res](size_t polygon_idx, int thread_num) {
+        std::vector<std::uint64_t> codes = std::move(res[polygon_idx]);
+        std::sort(codes.begin(), codes.end());
+        return codes;
+    });
+}
+
+/**
+ * @brief Cover a single polygon with geohash cells of a single precision
+ *
+ * @return Sorted Hilbert codes of covered cells
+ */
+inline std::vector<std::uint64_t> polygon_cover(
+    const LightMultiPolygon& polygon,
+    int precision = geo_utils::geohash::kDefaultPrecision,
+    int bits_per_char = geo_utils::geohash::kDefaultBitsPerChar,
+    int n_threads = 1,
+    CoverMode mode = CoverMode::Center
+) {
+    return polygon_cover(std::vector<LightMultiPolygon>{polygon}, precision, bits_per_char, n_threads, mode)[0];
+}
+
+/**
+ * @brief Compact a single precision cover into a mixed precision one.
+ * Every complete group of 2^bits_per_char sibling cells is replaced by its parent,
+ * repeatedly, but not coarser than min_precision.
+ *
+ * @param codes Sorted unique codes of one precision
+ * @param precision Precision of codes
+ * @param bits_per_char The number of bits per coding character
+ * @param min_precision The coarsest precision allowed in the result
+ * @return Cells ordered along the hilbert curve
+ */
+inline std::vector<CoverCell> compact_cover(
+    const std::vector<std::uint64_t>& codes,
+    int precision,
+    int bits_per_char = geo_utils::geohash::kDefaultBitsPerChar,
+    int min_precision = 1
+) {
+    geo_utils::geohash::code_level(precision, bits_per_char);
+    const size_t children_count = 1ull << bits_per_char;
+    std::vector<CoverCell> res;
+    std::vector<std::uint64_t> level_codes = codes;
+
+    for (int cur_precision = precision; !level_codes.empty(); cur_precision--) {
+        if (cur_precision <= min_precision) {
+            for (auto code : level_codes) {
+                res.push_back(CoverCell{code, cur_precision});
+            }
+            break;
+        }
+
+        std::vector<std::uint64_t> parents;
+        size_t group_start = 0;
+
+        for (size_t i = 1; i <= level_codes.size(); i++) {
+            std::uint64_t parent = level_codes[group_start] >> bits_per_char;
+
+            if (i < level_codes.size() && level_codes[i] >> bits_per_char == parent) {
+                continue;
+            }
+
+            if (i - group_start == children_count) {
+                parents.push_back(parent);
+            } else {
+                for (size_t j = group_start; j < i; j++) {
+                    res.push_back(CoverCell{level_codes[j], cur_precision});
+                }
+            }
+            group_start = i;
+        }
+
+        level_codes = std::move(parents);
+    }
+
+    std::sort(res.begin(), res.end(), [precision, bits_per_char](const CoverCell& lhs, const CoverCell& rhs) {
+        return lhs.code << (bits_per_char * (precision - lhs.precision)) <
+               rhs.code << (bits_per_char * (precision - rhs.precision));
+    });
+
+    return res;
+}
+
+/**
+ * @brief Convert cover cells to string geohashes
+ */
+inline std::vector<std::string> cover_to_strings(const std::vector<CoverCell>& cells, int bits_per_char = geo_utils::geohash::kDefaultBitsPerChar) {
+    std::vector<std::string> res;
+    res.reserve(cells.size());
+
+    for (const auto& cell : cells) {
+        res.push_back(geo_utils::geohash::code_to_string(cell.code, bits_per_char, cell.precision));
+    }
+
+    return res;
+}
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <algorithms/bbox_tree.h>
+#include <algorithms/light_polygon.h>
+
+namespace graph {
+namespace algorithms {
+
+// Same formula as LightSimplePolygon::direction, so both give bitwise equal signs
+inline double orientation(double ix, double iy, double jx, double jy, double kx, double ky) {
+  return (kx - ix) * (jy - iy) - (jx - ix) * (ky - iy);
+}
+
+/**
+ * @brief LightSimplePolygon prepared for many point-in-polygon queries.
+ *
+ * LightSimplePolygon::contains counts strict intersections of every ring edge with the
+ * segment from the query point to outside = (xmin - 1, ymin). All ring points and all points
+ * passing the bbox check lie to the right of and not below outside, so seen from outside
+ * they have slopes in [0, inf), and an edge can only cross the segment if its slope range
+ * contains the slope of the query point. Edges are bucketed into slabs by slope, so a query
+ * does a binary search for its slab and runs the original test only against the slab edges.
+ * Slope ranges are padded, so the result is exactly the one of LightSimplePolygon::contains.
+ */
+struct PreparedSimplePolygon {
+  static constexpr std::size_t kDefaultEdgesPerSlab = 8;
+
+  PreparedSimplePolygon() = default;
+
+  explicit PreparedSimplePolygon(const LightSimplePolygon &polygon,
+                                 std::size_t edges_per_slab = kDefaultEdgesPerSlab)
+      : bbox(polygon.bbox) {
+    if (edges_per_slab == 0) {
+      throw std::runtime_error("edges_per_slab must be positive");
+    }
+
+    outside = Point2d{bbox.xmin - 1, bbox.ymin};
+    const auto &points = polygon.points;
+
+    if (points.empty()) {
+      return;
+    }
+
+    // Edges in the order LightSimplePolygon::contains tests them
+    std::vector<std::pair<Point2d, Point2d>> edges;
+    edges.reserve(points.size());
+    for (std::size_t i = 0; i + 1 < points.size(); ++i) {
+      edges.push_back({points[i], points[i + 1]});
+    }
+    edges.push_back({points[points.size() - 1], points[0]});
+
+    std::vector<double> slopes;
+    slopes.reserve(points.size());
+    for (const auto &point : points) {
+      slopes.push_back(slope(point));
+    }
+    std::sort(slopes.begin(), slopes.end());
+
+    for (std::size_t i = 0; i < slopes.size(); i += edges_per_slab) {
+      if (slab_bounds.empty() || slopes[i] > slab_bounds.back()) {
+        slab_bounds.push_back(slopes[i]);
+      }
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> edge_slabs;
+    edge_slabs.reserve(edges.size());
+    slab_offsets.assign(slab_bounds.size() + 1, 0);
+
+    for (const auto &edge : edges) {
+      double slope_a = slope(edge.first);
+      double slope_b = slope(edge.second);
+      double lo = std::min(slope_a, slope_b);
+      double hi = std::max(slope_a, slope_b);
+      std::size_t slab_lo = findSlab(lo - slopeTolerance(lo));
+      std::size_t slab_hi = findSlab(hi + slopeTolerance(hi));
+      edge_slabs.push_back({slab_lo, slab_hi});
+
+      for (std::size_t slab = slab_lo; slab <= slab_hi; ++slab) {
+        slab_offsets[slab + 1]++;
+      }
+    }
+
+    for (std::size_t slab = 0; slab < slab_bounds.size(); ++slab) {
+      slab_offsets[slab + 1] += slab_offsets[slab];
+    }
+
+    std::size_t slab_edges_count = slab_offsets.back();
+    ax.resize(slab_edges_count);
+    ay.resize(slab_edges_count);
+    bx.resize(slab_edges_count);
+    by.resize(slab_edges_count);
+    std::vector<std::uint32_t> fill(slab_offsets.begin(), slab_offsets.end() - 1);
+
+    for (std::size_t edge_idx = 0; edge_idx < edges.size(); ++edge_idx) {
+      for (std::size_t slab = edge_slabs[edge_idx].first;
+           slab <= edge_slabs[edge_idx].second; ++slab) {
+        std::uint32_t pos = fill[slab]++;
+        ax[pos] = edges[edge_idx].first.x;
+        ay[pos] = edges[edge_idx].first.y;
+        bx[pos] = edges[edge_idx].second.x;
+        by[pos] = edges[edge_idx].second.y;
+      }
+    }
+  }
+
+  bool inBoundingBox(Point2d point) const {
+    return !(point.x < bbox.xmin || point.x > bbox.xmax ||
+             point.y < bbox.ymin || point.y > bbox.ymax);
+  }
+
+  bool contains(double lon, double lat) const {
+    return this->contains(Point2d{lon, lat});
+  }
+
+  bool contains(Point2d point) const {
+    if (slab_bounds.empty() || !inBoundingBox(point)) {
+      return false;
+    }
+
+    std::size_t slab = findSlab(slope(point));
+    return countCrossings(point, slab_offsets[slab], slab_offsets[slab + 1]) % 2 != 0;
+  }
+
+  /**
+   * @brief Batched point-in-polygon test over coordinate arrays
+   *
+   * @return 1 for points inside the polygon, 0 otherwise
+   */
+  std::vector<std::uint8_t> contains(const std::vector<double> &lon_vec,
+                                     const std::vector<double> &lat_vec) const {
+    if (lon_vec.size() != lat_vec.size()) {
+      throw std::runtime_error("lon_vec and lat_vec must have equal sizes");
+    }
+
+    std::vector<std::uint8_t> res(lon_vec.size(), 0);
+    for (std::size_t i = 0; i < lon_vec.size(); ++i) {
+      res[i] = contains(Point2d{lon_vec[i], lat_vec[i]});
+    }
+    return res;
+  }
+
+  std::size_t slabsCount() const { return slab_bounds.size(); }
+
+  BoundingBox bbox;
+
+private:
+  double slope(Point2d point) const {
+    return (point.y - outside.y) / (point.x - outside.x);
+  }
+
+  static double slopeTolerance(double value) {
+    return 1e-9 * (std::abs(value) + 1);
+  }
+
+  std::size_t findSlab(double value) const {
+    auto it = std::upper_bound(slab_bounds.begin(), slab_bounds.end(), value);
+    return it == slab_bounds.begin() ? 0 : it - slab_bounds.begin() - 1;
+  }
+
+  // Branch free loop over the slab edge arrays, so the compiler can vectorize it
+  int countCrossings(Point2d point, std::size_t begin, std::size_t end) const {
+    const double px = point.x;
+    const double py = point.y;
+    const double ox = outside.x;
+    const double oy = outside.y;
+    const double *ax_ptr = ax.data();
+    const double *ay_ptr = ay.data();
+    const double *bx_ptr = bx.data();
+    const double *by_ptr = by.data();
+    int intersections = 0;
+
+    for (std::size_t i = begin; i < end; ++i) {
+      double d1 = orientation(ax_ptr[i], ay_ptr[i], bx_ptr[i], by_ptr[i], px, py);
+      double d2 = orientation(ax_ptr[i], ay_ptr[i], bx_ptr[i], by_ptr[i], ox, oy);
+      double d3 = orientation(px, py, ox, oy, ax_ptr[i], ay_ptr[i]);
+      double d4 = orientation(px, py, ox, oy, bx_ptr[i], by_ptr[i]);
+      intersections += (((d1 > 0) & (d2 < 0)) | ((d1 < 0) & (d2 > 0))) &
+                       (((d3 > 0) & (d4 < 0)) | ((d3 < 0) & (d4 > 0)));
+    }
+
+    return intersections;
+  }
+
+  Point2d outside{0, 0};
+  std::vector<double> slab_bounds;
+  std::vector<std::uint32_t> slab_offsets;
+  std::vector<double> ax;
+  std::vector<double> ay;
+  std::vector<double> bx;
+  std::vector<double> by;
+};
+
+/**
+ * @brief LightPolygon prepared for many point-in-polygon queries.
+ * Holes are indexed by a bbox tree, so only holes whose boxes contain the point are tested.
+ */
+struct PreparedPolygon {
+  PreparedPolygon() = default;
+
+  explicit PreparedPolygon(const LightPolygon &polygon)
+      : external_polygon(polygon.external_polygon) {
+    std::vector<BoundingBox> hole_boxes;
+    internal_polygons_vec.reserve(polygon.internal_polygons_vec.size());
+
+    for (const auto &hole : polygon.internal_polygons_vec) {
+      internal_polygons_vec.emplace_back(hole);
+      hole_boxes.push_back(hole.bbox);
+    }
+    holes_tree = BBoxTree(hole_boxes);
+  }
+
+  explicit PreparedPolygon(const Polygon *geos_polygon)
+      : PreparedPolygon(LightPolygon(geos_polygon)) {}
+
+  bool contains(double lon, double lat) const {
+    return this->contains(Point2d{lon, lat});
+  }
+
+  bool contains(Point2d point) const {
+    if (!external_polygon.contains(point)) {
+      return false;
+    }
+
+    bool in_hole = holes_tree.query(point, [this, point](std::uint32_t hole_idx) {
+      return internal_polygons_vec[hole_idx].contains(point);
+    });
+    return !in_hole;
+  }
+
+  const BoundingBox &bbox() const { return external_polygon.bbox; }
+
+  PreparedSimplePolygon external_polygon;
+  std::vector<PreparedSimplePolygon> internal_polygons_vec;
+
+private:
+  BBoxTree holes_tree;
+};
+
+/**
+ * @brief LightMultiPolygon prepared for many point-in-polygon queries.
+ * Parts are indexed by an STR packed bbox tree and every part indexes its holes,
+ * so a query touches only parts and holes whose boxes contain the point.
+ */
+struct PreparedMultiPolygon {
+  PreparedMultiPolygon() = default;
+
+  explicit PreparedMultiPolygon(const LightMultiPolygon &multipolygon) {
+    std::vector<BoundingBox> part_boxes;
+    polygons_vec.reserve(multipolygon.polygons_vec.size());
+
+    for (const auto &polygon : multipolygon.polygons_vec) {
+      polygons_vec.emplace_back(polygon);
+      part_boxes.push_back(polygon.external_polygon.bbox);
+      bbox = boxUnion(bbox, polygon.external_polygon.bbox);
+    }
+    parts_tree = BBoxTree(part_boxes);
+  }
+
+  explicit PreparedMultiPolygon(const Geometry *geos_geometry)
+      : PreparedMultiPolygon(LightMultiPolygon(geos_geometry)) {}
+
+  bool contains(double lon, double lat) const {
+    return this->contains(Point2d{lon, lat});
+  }
+
+  bool contains(Point2d point) const {
+    return parts_tree.query(point, [this, point](std::uint32_t part_idx) {
+      return polygons_vec[part_idx].contains(point);
+    });
+  }
+
+  /**
+   * @brief Batched point-in-polygon test over coordinate arrays
+   *
+   * @return 1 for points inside the multipolygon, 0 otherwise
+   */
+  std::vector<std::uint8_t> contains(const std::vector<double> &lon_vec,
+                                     const std::vector<double> &lat_vec) const {
+    if (lon_vec.size() != lat_vec.size()) {
+      throw std::runtime_error("lon_vec and lat_vec must have equal sizes");
+    }
+
+    std::vector<std::uint8_t> res(lon_vec.size(), 0);
+    for (std::size_t i = 0; i < lon_vec.size(); ++i) {
+      res[i] = contains(Point2d{lon_vec[i], lat_vec[i]});
+    }
+    return res;
+  }
+
+  std::vector<PreparedPolygon> polygons_vec;
+  BoundingBox bbox;
+
+private:
+  BBoxTree parts_tree;
+};
+
+} // namespace algorithms
+} // namespace graph
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithms/thread_pool.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Result of a query cancelled before it finished
+ */
+class QueryCancelled : public std::runtime_error {
+   public:
+    QueryCancelled()
+        : std::runtime_error("Query cancelled") {}
+};
+
+/**
+ * @brief Handle of a submitted query: its result and its cancellation flag. Copies share both.
+ */
+template <typename T>
+class QueryFuture {
+   public:
+    QueryFuture() = default;
+
+    QueryFuture(std::shared_future<T> future, std::shared_ptr<std::atomic<bool>> cancelled)
+        : future_(std::move(future)), cancelled_(std::move(cancelled)) {}
+
+    bool valid() const {
+        return future_.valid();
+    }
+
+    /**
+     * @brief Wait for the result; rethrows the exception of the query, QueryCancelled if it was
+     * cancelled in time
+     */
+    const T& get() const {
+        return future_.get();
+    }
+
+    void wait() const {
+        future_.wait();
+    }
+
+    template <typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+        return future_.wait_for(timeout);
+    }
+
+    bool ready() const {
+        return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /**
+     * @brief Ask the query to stop: a queued query does not run, a running one stops at its next
+     * check of the flag. A query finishing before it sees the request keeps its result.
+     */
+    void cancel() const {
+        cancelled_->store(true, std::memory_order_relaxed);
+    }
+
+    bool cancel_requested() const {
+        return cancelled_->load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::shared_future<T> future_;
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/**
+ * @brief Priority queue of queries in front of a ThreadPool.
+ *
+ * Every submit posts one job to the pool, and the job runs the query with the highest priority
+ * queued when a worker picks it up, not the one it was posted for. So an interactive query
+ * submitted behind a large batch starts on the next free worker, without a pool of its own.
+ * Equal priorities run in submission order.
+ *
+ * Tasks get the worker id and the cancellation flag, which long tasks poll to stop early by
+ * throwing QueryCancelled. Queries queued at destruction are cancelled; the destructor waits for
+ * the running ones. A query submitted from a worker of the same pool runs inline.
+ */
+class QueryScheduler {
+   public:
+    explicit QueryScheduler(ThreadPool& pool = ThreadPool::shared())
+        : pool_(pool) {}
+
+    QueryScheduler(const QueryScheduler&) = delete;
+    QueryScheduler& operator=(const QueryScheduler&) = delete;
+
+    ~QueryScheduler() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (auto& entry : queue_) {
+            entry.cancelled->store(true, std::memory_order_relaxed);
+        }
+        idle_cv_.wait(lock, [this] { return outstanding_ == 0; });
+    }
+
+    ThreadPool& pool() const {
+        return pool_;
+    }
+
+    /**
+     * @brief Queue a task
+     *
+     * @param task Callable (int worker_id, const std::atomic<bool>& cancelled) -> result
+     * @param priority Higher runs first
+     * @param on_done Called in the worker with the finished future, e.g. to hand the result to
+     * an event loop; must not throw
+     */
+    template <typename Task, typename Result = std::invoke_result_t<Task, int, const std::atomic<bool>&>>
+    QueryFuture<Result> submit(Task task, int priority = 0, std::type_identity_t<std::function<void(const QueryFuture<Result>&)>> on_done = {}) {
+        auto promise = std::make_shared<std::promise<Result>>();
+        auto cancelled = std::make_shared<std::atomic<bool>>(false);
+        QueryFuture<Result> future(promise->get_future().share(), cancelled);
+
+        auto run = [task = std::move(task), promise, cancelled, future, on_done = std::move(on_done)](int worker_id) mutable {
+            const auto& flag = *cancelled;
+            try {
+                if (flag.load(std::memory_order_relaxed)) {
+                    throw QueryCancelled();
+                }
+                if constexpr (std::is_void_v<Result>) {
+                    task(worker_id, flag);
+                    promise->set_value();
+                } else {
+                    promise->set_value(task(worker_id, flag));
+                }
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+            if (on_done) {
+                on_done(future);
+            }
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(Entry{priority, next_sequence_++, cancelled, std::move(run)});
+            std::push_heap(queue_.begin(), queue_.end());
+            outstanding_++;
+        }
+        pool_.post([this](int worker_id) { run_next(worker_id); }, "query");
+        return future;
+    }
+
+    /**
+     * @brief Queries waiting for a worker
+     */
+    size_t queued() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+   private:
+    struct Entry {
+        int priority;
+        std::uint64_t sequence;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        std::function<void(int)> run;
+
+        // Heap top is the highest priority, then the earliest submitted
+        bool operator<(const Entry& other) const {
+            return priority < other.priority || (priority == other.priority && sequence > other.sequence);
+        }
+    };
+
+    ThreadPool& pool_;
+    mutable std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    std::vector<Entry> queue_;
+    std::uint64_t next_sequence_ = 0;
+    size_t outstanding_ = 0;
+
+    void run_next(int worker_id) {
+        std::function<void(int)> run;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::pop_heap(queue_.begin(), queue_.end());
+            run = std::move(queue_.back().run);
+            queue_.pop_back();
+        }
+        run(worker_id);
+        run = nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--outstanding_ == 0) {
+            idle_cv_.notify_all();
+        }
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/query_scheduler.h>
+#include <algorithms/thread_pool.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/search_stats.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Isochrone queries on a CompiledGraph submitted without blocking the caller: every
+ * submit returns a QueryFuture of the single_source_dijkstra result.
+ *
+ * Queries share one QueryScheduler on the pool, so interactive queries with a higher priority
+ * overtake queued batch ones. Every pool worker has its own workspace. A cancelled query stops
+ * relaxing edges at once and its future throws QueryCancelled. Do not submit from inside
+ * on_done callbacks or other tasks of the same pool, they would run inline.
+ */
+template <typename Vertex>
+class AsyncDijkstra {
+   public:
+    using Result = std::unordered_map<Vertex, float>;
+    using OnDone = std::function<void(const QueryFuture<Result>&)>;
+
+    /**
+     * @param graph Compiled graph; it has to outlive the engine
+     * @param pool Pool running the queries
+     */
+    explicit AsyncDijkstra(const CompiledGraph<Vertex>& graph, ThreadPool& pool = ThreadPool::shared())
+        : graph_(graph), workspaces_(pool.size()), scheduler_(pool) {}
+
+    /**
+     * @brief Queue an isochrone; unknown start vertices and directions the graph can not search
+     * throw here, not in the future
+     *
+     * @param start Start vertex
+     * @param max_distance Vertices farther than it are left out
+     * @param priority Higher runs first
+     * @param direction Backward gives distances to start and needs the transposed adjacency
+     * @param on_done Called in the worker once the future is ready
+     */
+    QueryFuture<Result> submit(
+        const Vertex& start,
+        float max_distance,
+        int priority = 0,
+        SearchDirection direction = SearchDirection::Forward,
+        OnDone on_done = {}
+    ) {
+        graph_.check_direction(direction);
+        auto start_index = graph_.index(start);
+        auto task = [this, start_index, max_distance, direction](int worker_id, const std::atomic<bool>& cancelled) {
+            auto& workspace = workspaces_[worker_id];
+            // A cancelled search rejects every edge, so the heap drains right away
+            auto cutoff = [max_distance, &cancelled](float dist) {
+                return dist <= max_distance && !cancelled.load(std::memory_order_relaxed);
+            };
+            NoSearchStats stats;
+            single_source_dijkstra(graph_, start_index, cutoff, workspace, stats, direction);
+            if (cancelled.load(std::memory_order_relaxed)) {
+                throw QueryCancelled();
+            }
+            return reached_to_map(graph_, workspace);
+        };
+        return scheduler_.submit(std::move(task), priority, std::move(on_done));
+    }
+
+    std::vector<QueryFuture<Result>> submit_batch(
+        const std::vector<Vertex>& starts,
+        float max_distance,
+        int priority = 0,
+        SearchDirection direction = SearchDirection::Forward
+    ) {
+        // Nothing is queued if a start is unknown
+        for (const auto& start : starts) {
+            graph_.index(start);
+        }
+        std::vector<QueryFuture<Result>> res;
+        res.reserve(starts.size());
+        for (const auto& start : starts) {
+            res.push_back(submit(start, max_distance, priority, direction));
+        }
+        return res;
+    }
+
+    /**
+     * @brief Queries waiting for a worker
+     */
+    size_t queued() const {
+        return scheduler_.queued();
+    }
+
+   private:
+    const CompiledGraph<Vertex>& graph_;
+    std::vector<DijkstraWorkspace> workspaces_;
+    // Destroyed first: waits for the running queries, which use the workspaces
+    QueryScheduler scheduler_;
+};
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/parallel.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+namespace algorithms {
+
+class DijkstraWorkspace;
+
+template <typename Vertex, typename Cutoff, typename Stats>
+void single_source_dijkstra(
+    const CompiledGraph<Vertex>& graph,
+    std::uint32_t start,
+    Cutoff&& cutoff,
+    DijkstraWorkspace& workspace,
+    Stats& stats,
+    SearchDirection direction = SearchDirection::Forward
+);
+
+/**
+ * @brief Reusable per-thread buffers of Dijkstra searches on a CompiledGraph.
+ * The distance array is sized once per graph and only entries reached by the previous
+ * search are reset, so a small isochrone does not pay for the whole graph.
+ */
+class DijkstraWorkspace {
+   public:
+    using Index = std::uint32_t;
+    static constexpr float kUnreached = std::numeric_limits<float>::infinity();
+
+    float dist(Index v) const {
+        return search_.dist(v);
+    }
+
+    /**
+     * @brief Vertices reached by the last search with final distances, in settle order
+     */
+    const std::vector<std::pair<Index, float>>& reached() const {
+        return search_.settled();
+    }
+
+    lib::MemoryReport memory_usage() const {
+        return search_.memory_usage();
+    }
+
+   private:
+    template <typename Vertex, typename Cutoff, typename Stats>
+    friend void single_source_dijkstra(const CompiledGraph<Vertex>&, Index, Cutoff&&, DijkstraWorkspace&, Stats&, SearchDirection);
+
+    DijkstraSearch<> search_;
+};
+
+/**
+ * @brief Dijkstra on a CompiledGraph with the semantics of single_source_dijkstra on Graph:
+ * edges are relaxed only if cutoff(new distance) holds. Results are in workspace.reached().
+ * Backward searches follow edges into vertices, giving distances to start (reverse isochrones),
+ * and need the transposed adjacency.
+ */
+template <typename Vertex, typename Cutoff, typename Stats>
+void single_source_dijkstra(
+    const CompiledGraph<Vertex>& graph,
+    DijkstraWorkspace::Index start,
+    Cutoff&& cutoff,
+    DijkstraWorkspace& workspace,
+    Stats& stats,
+    SearchDirection direction
+) {
+    CutoffVisitor<std::remove_reference_t<Cutoff>> visitor{cutoff};
+    workspace.search_.run(graph, start, visitor, stats, direction);
+}
+
+/**
+ * @brief Distances of the last search as vertex -> distance, like single_source_dijkstra on Graph returns
+ */
+template <typename Vertex>
+std::unordered_map<Vertex, float> reached_to_map(const CompiledGraph<Vertex>& graph, const DijkstraWorkspace& workspace) {
+    std::unordered_map<Vertex, float> ans;
+    ans.reserve(workspace.reached().size());
+    for (const auto& [v, dist] : workspace.reached()) {
+        ans.emplace(graph.vertex(v), dist);
+    }
+    return ans;
+}
+
+template <typename Vertex, typename Cutoff>
+std::unordered_map<Vertex, float> single_source_dijkstra(
+    const CompiledGraph<Vertex>& graph,
+    const Vertex& start,
+    Cutoff&& cutoff,
+    SearchDirection direction = SearchDirection::Forward
+) {
+    DijkstraWorkspace workspace;
+    NoSearchStats stats;
+    single_source_dijkstra(graph, graph.index(start), cutoff, workspace, stats, direction);
+    return reached_to_map(graph, workspace);
+}
+
+template <typename Vertex, typename Cutoff>
+std::vector<std::unordered_map<Vertex, float>> multi_source_dijkstra(
+    const CompiledGraph<Vertex>& graph,
+    const std::vector<Vertex>& starts_vec,
+    const int n_threads,
+    Cutoff&& cutoff_func,
+    SearchDirection direction = SearchDirection::Forward
+) {
+    // One workspace per thread, reused by all its queries
+    std::vector<DijkstraWorkspace> workspaces(n_threads);
+    graph.check_direction(direction);
+
+    auto task = [&graph, &cutoff_func, &workspaces, direction](const Vertex& start, int thread_num) {
+        DijkstraWorkspace& workspace = workspaces[thread_num];
+        NoSearchStats stats;
+        single_source_dijkstra(graph, graph.index(start), cutoff_func, workspace, stats, direction);
+        return reached_to_map(graph, workspace);
+    };
+    return run_in_threads(starts_vec, n_threads, task);
+}
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Contraction order of a graph with the shortcuts it needs.
+ *
+ * Every vertex has a rank, its position in the contraction order. Upward edges of v go to higher
+ * ranked vertices: graph edges and the shortcuts added when lower ranked vertices were contracted.
+ * Downward edges of v come from higher ranked vertices into v. A shortest path between any two
+ * vertices exists as an upward path followed by a downward one, meeting at its highest rank.
+ */
+struct ContractionHierarchy {
+    using Index = std::uint32_t;
+
+    std::vector<Index> rank;
+    std::vector<Index> up_offsets;
+    std::vector<Index> up_targets;
+    std::vector<float> up_weights;
+    std::vector<Index> down_offsets;
+    std::vector<Index> down_sources;
+    std::vector<float> down_weights;
+
+    size_t vertices_count() const {
+        return rank.size();
+    }
+
+    /**
+     * @brief Upward and downward edges, graph edges and shortcuts
+     */
+    size_t edges_count() const {
+        return up_targets.size() + down_sources.size();
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Indexes] += lib::vector_bytes(rank);
+        res[lib::MemoryCategory::Topology] += lib::vector_bytes(up_offsets) + lib::vector_bytes(up_targets) +
+                                              lib::vector_bytes(down_offsets) + lib::vector_bytes(down_sources);
+        res[lib::MemoryCategory::Weights] += lib::vector_bytes(up_weights) + lib::vector_bytes(down_weights);
+        return res;
+    }
+};
+
+namespace detail {
+
+// Graph shrinking while vertices are contracted; edges of contracted vertices are removed
+class ContractionGraph {
+   public:
+    using Index = std::uint32_t;
+
+    struct EdgeRef {
+        float weight;
+    };
+
+    using Edges = std::vector<std::pair<Index, float>>;
+
+    template <typename Vertex>
+    explicit ContractionGraph(const CompiledGraph<Vertex>& graph)
+        : out_(graph.vertices_count()), in_(graph.vertices_count()) {
+        for (Index v = 0; v < graph.vertices_count(); v++) {
+            for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+                if (graph.target(edge) != v) {
+                    add_edge(v, graph.target(edge), graph.weight(edge));
+                }
+            }
+        }
+    }
+
+    size_t vertices_count() const {
+        return out_.size();
+    }
+
+    void check_direction(SearchDirection) const {}
+
+    // Witness searches skip the vertex being contracted
+    void set_skipped(Index v) {
+        skipped_ = v;
+    }
+
+    template <SearchDirection Direction, typename Relax>
+    void for_each_edge_id(Index v, Relax&& relax) const {
+        for (const auto& [u, weight] : out_[v]) {
+            if (u != skipped_) {
+                relax(u, EdgeRef{weight});
+            }
+        }
+    }
+
+    const Edges& out(Index v) const {
+        return out_[v];
+    }
+
+    const Edges& in(Index v) const {
+        return in_[v];
+    }
+
+    void add_edge(Index from, Index to, float weight) {
+        if (!lower_weight(out_[from], to, weight)) {
+            out_[from].push_back({to, weight});
+            in_[to].push_back({from, weight});
+        } else {
+            lower_weight(in_[to], from, weight);
+        }
+    }
+
+    void remove(Index v) {
+        for (const auto& [u, weight] : out_[v]) {
+            erase(in_[u], v);
+        }
+        for (const auto& [u, weight] : in_[v]) {
+            erase(out_[u], v);
+        }
+        out_[v] = {};
+        in_[v] = {};
+    }
+
+   private:
+    std::vector<Edges> out_;
+    std::vector<Edges> in_;
+    Index skipped_ = std::numeric_limits<Index>::max();
+
+    // True if the edge exists; its weight becomes the smaller one
+    static bool lower_weight(Edges& edges, Index u, float weight) {
+        for (auto& edge : edges) {
+            if (edge.first == u) {
+                edge.second = std::min(edge.second, weight);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void erase(Edges& edges, Index u) {
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [u](const auto& edge) { return edge.first == u; }), edges.end());
+    }
+};
+
+struct ContractionWeight {
+    float operator()(const ContractionGraph&, ContractionGraph::EdgeRef edge) const {
+        return edge.weight;
+    }
+};
+
+// Contracts vertices one by one, deciding shortcuts with limited witness searches
+class Contraction {
+   public:
+    using Index = std::uint32_t;
+
+    template <typename Vertex>
+    Contraction(const CompiledGraph<Vertex>& graph, size_t witness_settled)
+        : graph_(graph), witness_settled_(witness_settled), deleted_neighbors_(graph.vertices_count(), 0) {}
+
+    // Shortcuts needed to contract v; adds them unless simulating
+    size_t contract(Index v, bool simulate) {
+        size_t shortcuts = 0;
+        graph_.set_skipped(v);
+        for (const auto& [u, in_weight] : graph_.in(v)) {
+            float limit = 0;
+            for (const auto& [x, out_weight] : graph_.out(v)) {
+                limit = std::max(limit, in_weight + out_weight);
+            }
+            witness_search(u, limit);
+            for (const auto& [x, out_weight] : graph_.out(v)) {
+                if (x != u && search_.dist(x) > in_weight + out_weight) {
+                    shortcuts++;
+                    if (!simulate) {
+                        added_.push_back({u, x, in_weight + out_weight});
+                    }
+                }
+            }
+        }
+        graph_.set_skipped(std::numeric_limits<Index>::max());
+
+        if (!simulate) {
+            for (const auto& [from, to, weight] : added_) {
+                graph_.add_edge(from, to, weight);
+            }
+            added_.clear();
+        }
+        return shortcuts;
+    }
+
+    // Smaller is contracted first: vertices whose removal does not grow the graph, spread evenly
+    long long priority(Index v) {
+        long long shortcuts = contract(v, true);
+        long long degree = graph_.in(v).size() + graph_.out(v).size();
+        return 2 * shortcuts - degree + deleted_neighbors_[v];
+    }
+
+    ContractionGraph& graph() {
+        return graph_;
+    }
+
+    void on_removed(Index v) {
+        for (const auto& [u, weight] : graph_.out(v)) {
+            deleted_neighbors_[u]++;
+        }
+        for (const auto& [u, weight] : graph_.in(v)) {
+            deleted_neighbors_[u]++;
+        }
+    }
+
+   private:
+    struct Shortcut {
+        Index from;
+        Index to;
+        float weight;
+    };
+
+    ContractionGraph graph_;
+    size_t witness_settled_;
+    std::vector<Index> deleted_neighbors_;
+    DijkstraSearch<BinaryHeap, DistanceLabels, ContractionWeight> search_;
+    std::vector<Shortcut> added_;
+
+    void witness_search(Index start, float limit) {
+        struct WitnessVisitor {
+            float limit;
+            size_t settled_limit;
+            size_t settled = 0;
+
+            bool accept(float dist) const {
+                return dist <= limit;
+            }
+
+            bool on_settle(Index, float) {
+                return ++settled < settled_limit;
+            }
+        };
+        NoSearchStats stats;
+        search_.run(graph_, start, WitnessVisitor{limit, witness_settled_}, stats);
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Contract the graph in the order of edge difference: the vertex whose removal adds the
+ * fewest shortcuts compared to the edges it takes away goes next, with a penalty for already
+ * contracted neighbors to spread the order over the map. A shortcut u -> x replaces u -> v -> x
+ * unless a witness search from u, bounded by witness_settled vertices, finds a path no longer.
+ * Priorities are updated lazily: a popped vertex is recomputed and put back if it got worse.
+ *
+ * @param graph Compiled graph with non-negative weights
+ * @param witness_settled Vertices settled by one witness search; smaller is faster to build
+ * and adds more shortcuts
+ */
+template <typename Vertex>
+ContractionHierarchy contract_graph(const CompiledGraph<Vertex>& graph, size_t witness_settled = 500) {
+    using Index = std::uint32_t;
+    const size_t count = graph.vertices_count();
+    detail::Contraction contraction(graph, witness_settled);
+    auto& remaining = contraction.graph();
+
+    using Item = std::pair<long long, Index>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    for (Index v = 0; v < count; v++) {
+        queue.push({contraction.priority(v), v});
+    }
+
+    ContractionHierarchy res;
+    res.rank.assign(count, 0);
+    std::vector<bool> contracted(count, false);
+    std::vector<std::vector<std::pair<Index, float>>> up(count), down(count);
+    Index next_rank = 0;
+
+    while (!queue.empty()) {
+        auto [priority, v] = queue.top();
+        queue.pop();
+        if (contracted[v]) {
+            continue;
+        }
+        auto current = contraction.priority(v);
+        if (!queue.empty() && current > queue.top().first) {
+            queue.push({current, v});
+            continue;
+        }
+
+        contraction.contract(v, false);
+        // Edges left at v all lead to vertices contracted later
+        up[v] = remaining.out(v);
+        down[v] = remaining.in(v);
+        contraction.on_removed(v);
+        remaining.remove(v);
+        contracted[v] = true;
+        res.rank[v] = next_rank++;
+    }
+
+    auto flatten = [count](auto& edges, auto& offsets, auto& targets, auto& weights) {
+        offsets.assign(1, 0);
+        for (Index v = 0; v < count; v++) {
+            for (const auto& [u, weight] : edges[v]) {
+                targets.push_back(u);
+                weights.push_back(weight);
+            }
+            offsets.push_back(targets.size());
+            edges[v] = {};
+        }
+    };
+    flatten(up, res.up_offsets, res.up_targets, res.up_weights);
+    flatten(down, res.down_offsets, res.down_sources, res.down_weights);
+    return res;
+}
+
+}  // namespace algorithms
+}  // namespace graph
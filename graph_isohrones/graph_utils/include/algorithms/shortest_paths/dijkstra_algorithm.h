@@ -1,53 +1,143 @@
 #pragma once
 #include <graph.h>
 #include <cstddef>
-#include <queue>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <algorithm>
 #include <vector>
-#include <graph.h>
 #include <algorithms/parallel.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <library/memory_accounting.h>
 
 namespace graph {
 namespace algorithms {
-template <typename Vertex, typename Cutoff>
-std::unordered_map<Vertex, float> single_source_dijkstra(const Graph<Vertex>& graph, const Vertex& start, Cutoff&& cutoff) {
-    std::unordered_map<Vertex, float> ans;
-    std::priority_queue<std::pair<Vertex, float>, std::vector<std::pair<Vertex, float>>, std::greater<std::pair<Vertex, float>>> queue;
 
-    ans[start] = 0;
-    queue.push({start, 0});
+namespace detail {
+
+/**
+ * @brief Graph as DijkstraSearch sees it: vertices are numbered in the order the search reaches
+ * them and edges are passed as their weights. Graph has no incoming edges, so only forward.
+ */
+template <typename Vertex>
+class DiscoveredGraph {
+   public:
+    using Index = std::uint32_t;
+
+    explicit DiscoveredGraph(const Graph<Vertex>& graph)
+        : graph_(graph) {}
+
+    Index index(const Vertex& vertex) const {
+        auto [it, inserted] = index_.try_emplace(vertex, static_cast<Index>(vertices_.size()));
+        if (inserted) {
+            vertices_.push_back(&it->first);
+        }
+        return it->second;
+    }
 
-    while (!queue.empty()) {
-        std::pair<Vertex, float> current = queue.top();
-        queue.pop();
+    const Vertex& vertex(Index v) const {
+        return *vertices_[v];
+    }
 
-        Vertex v = current.first;
-        float dst = current.second;
+    // Vertices numbered so far
+    size_t vertices_count() const {
+        return vertices_.size();
+    }
+
+    void check_direction(SearchDirection direction) const {
+        if (direction != SearchDirection::Forward) {
+            throw std::runtime_error("Graph has no incoming edges, use CompiledGraph for backward searches");
+        }
+    }
 
-        if (ans[v] < dst) {
-            continue;
+    template <SearchDirection Direction, typename Func>
+    void for_each_edge_id(Index v, Func&& func) const {
+        for (const auto& [u, weight] : graph_.get_neighbors(*vertices_[v])) {
+            func(index(u), weight);
         }
+    }
+
+   private:
+    const Graph<Vertex>& graph_;
+    // Numbering grows while the search walks the graph, vertices point to the keys of index_
+    mutable std::unordered_map<Vertex, Index> index_;
+    mutable std::vector<const Vertex*> vertices_;
+};
+
+// Weight policy for DiscoveredGraph, whose edges are their weights
+struct DiscoveredWeight {
+    template <typename Graph>
+    float operator()(const Graph&, float weight) const {
+        return weight;
+    }
+};
 
-        for (std::pair<Vertex, float> e: graph.get_neighbors(v)) {
-            Vertex u = e.first;
-            float len_vu = e.second;
-            float n_dst = dst + len_vu;
+// Labels of vertices numbered during the search, the array grows with the numbering
+class DiscoveredLabels {
+   public:
+    using Index = std::uint32_t;
+    using Distance = float;
+    static constexpr bool kTracksParents = false;
+    static constexpr Distance kUnreached = std::numeric_limits<Distance>::infinity();
+    static constexpr Index kNoParent = std::numeric_limits<Index>::max();
+
+    void prepare(size_t) {}
+
+    void reset(Index v) {
+        dist_[v] = kUnreached;
+    }
 
-            if (!cutoff(n_dst)) {
-                continue;
-            }
+    Distance dist(Index v) const {
+        return v < dist_.size() ? dist_[v] : kUnreached;
+    }
 
-            if (ans.find(u) == ans.end() || n_dst < ans[u]) {
-                ans[u] = n_dst;
-                queue.push({u, n_dst});
-            }
+    void update(Index v, Distance dist, Index) {
+        if (v >= dist_.size()) {
+            dist_.resize(v + 1, kUnreached);
         }
+        dist_[v] = dist;
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Caches] += lib::vector_bytes(dist_);
+        return res;
     }
 
+   private:
+    std::vector<Distance> dist_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Dijkstra on a Graph: edges are relaxed only if cutoff(new distance) holds,
+ * the start is always labeled
+ */
+template <typename Vertex, typename Cutoff, typename Stats>
+std::unordered_map<Vertex, float> single_source_dijkstra(const Graph<Vertex>& graph, const Vertex& start, Cutoff&& cutoff, Stats& stats) {
+    detail::DiscoveredGraph<Vertex> discovered(graph);
+    DijkstraSearch<BinaryHeap, detail::DiscoveredLabels, detail::DiscoveredWeight> search;
+    CutoffVisitor<std::remove_reference_t<Cutoff>> visitor{cutoff};
+    search.run(discovered, discovered.index(start), visitor, stats);
+
+    std::unordered_map<Vertex, float> ans;
+    ans.reserve(search.settled().size());
+    for (const auto& [v, dist] : search.settled()) {
+        ans.emplace(discovered.vertex(v), dist);
+    }
     return ans;
 }
 
+template <typename Vertex, typename Cutoff>
+std::unordered_map<Vertex, float> single_source_dijkstra(const Graph<Vertex>& graph, const Vertex& start, Cutoff&& cutoff) {
+    NoSearchStats stats;
+    return single_source_dijkstra(graph, start, cutoff, stats);
+}
+
 template<typename Vertex, typename Cutoff>
 std::vector<std::unordered_map<Vertex, float>> multi_source_dijkstra(
     const graph::Graph<Vertex>& graph,
@@ -61,5 +151,49 @@ std::vector<std::unordered_map<Vertex, float>> multi_source_dijkstra(
     return graph::algorithms::run_in_threads(starts_vec, n_threads, task);
 }
 
+/**
+ * @brief multi_source_dijkstra which also reports the load of every thread and records a trace of the run
+ */
+template<typename Vertex, typename Cutoff>
+std::vector<std::unordered_map<Vertex, float>> multi_source_dijkstra(
+    const graph::Graph<Vertex>& graph,
+    const std::vector<Vertex>& starts_vec,
+    const int n_threads,
+    Cutoff&& cutoff_func,
+    PoolTelemetry& telemetry,
+    std::vector<TraceEvent>& trace
+) {
+    auto task = [&graph, &cutoff_func](const Vertex& start, int thread_num) {
+        return graph::algorithms::single_source_dijkstra(graph, start, cutoff_func);
+    };
+    return graph::algorithms::run_in_threads(starts_vec, n_threads, task, telemetry, trace);
+}
+
+template<typename Vertex, typename Cutoff>
+std::vector<std::unordered_map<Vertex, float>> multi_source_dijkstra(
+    const graph::Graph<Vertex>& graph,
+    const std::vector<Vertex>& starts_vec,
+    const int n_threads,
+    Cutoff&& cutoff_func,
+    BatchSearchStats& stats
+) {
+    stats.per_query.assign(starts_vec.size(), SearchStats{});
+    stats.per_thread.assign(n_threads, SearchStats{});
+    std::vector<size_t> start_ids(starts_vec.size());
+
+    for (size_t start_idx = 0; start_idx < start_ids.size(); start_idx++) {
+        start_ids[start_idx] = start_idx;
+    }
+
+    // Every query writes its own slot and every thread its own aggregate, so no locking is needed
+    auto task = [&graph, &starts_vec, &cutoff_func, &stats](size_t start_idx, int thread_num) {
+        SearchStats& query_stats = stats.per_query[start_idx];
+        auto res = graph::algorithms::single_source_dijkstra(graph, starts_vec[start_idx], cutoff_func, query_stats);
+        stats.per_thread[thread_num] += query_stats;
+        return res;
+    };
+    return graph::algorithms::run_in_threads(start_ids, n_threads, task);
+}
+
 }  // namespace algorithm
 }  // namespace graph
@@ -0,0 +1,438 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Binary min-heap of (distance, vertex) pairs; decrease-key is a new push and
+ * outdated entries are skipped when popped
+ */
+class BinaryHeap {
+   public:
+    using Index = std::uint32_t;
+
+    void clear() {
+        items_.clear();
+    }
+
+    bool empty() const {
+        return items_.empty();
+    }
+
+    size_t size() const {
+        return items_.size();
+    }
+
+    void push(float key, Index v) {
+        items_.push_back({key, v});
+        std::push_heap(items_.begin(), items_.end(), std::greater<std::pair<float, Index>>());
+    }
+
+    std::pair<float, Index> pop() {
+        std::pop_heap(items_.begin(), items_.end(), std::greater<std::pair<float, Index>>());
+        auto top = items_.back();
+        items_.pop_back();
+        return top;
+    }
+
+    float top_key() const {
+        return items_.front().first;
+    }
+
+    template <typename Func>
+    void for_each_vertex(Func&& func) const {
+        for (const auto& [key, v] : items_) {
+            func(v);
+        }
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Caches] += lib::vector_bytes(items_);
+        return res;
+    }
+
+   private:
+    std::vector<std::pair<float, Index>> items_;
+};
+
+/**
+ * @brief Distance labels of a search, optionally with the shortest path tree parents.
+ * Arrays are sized once per graph, the search resets only the entries it labeled,
+ * so a small search does not pay for the whole graph. Integer distances are for
+ * quantized weights; unreached vertices get the largest value.
+ */
+template <bool TrackParents, typename DistanceType = float>
+class SearchLabels {
+   public:
+    using Index = std::uint32_t;
+    using Distance = DistanceType;
+    static constexpr bool kTracksParents = TrackParents;
+    static constexpr Distance kUnreached = std::numeric_limits<Distance>::has_infinity
+                                               ? std::numeric_limits<Distance>::infinity()
+                                               : std::numeric_limits<Distance>::max();
+    static constexpr Index kNoParent = std::numeric_limits<Index>::max();
+
+    void prepare(size_t vertices_count) {
+        if (dist_.size() != vertices_count) {
+            dist_.assign(vertices_count, kUnreached);
+            if constexpr (TrackParents) {
+                parents_.assign(vertices_count, kNoParent);
+            }
+        }
+    }
+
+    void reset(Index v) {
+        dist_[v] = kUnreached;
+        if constexpr (TrackParents) {
+            parents_[v] = kNoParent;
+        }
+    }
+
+    Distance dist(Index v) const {
+        return dist_[v];
+    }
+
+    Index parent(Index v) const
+        requires TrackParents
+    {
+        return parents_[v];
+    }
+
+    void update(Index v, Distance dist, Index parent) {
+        dist_[v] = dist;
+        if constexpr (TrackParents) {
+            parents_[v] = parent;
+        }
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Caches] += lib::vector_bytes(dist_);
+        if constexpr (TrackParents) {
+            res[lib::MemoryCategory::Caches] += lib::vector_bytes(parents_);
+        }
+        return res;
+    }
+
+   private:
+    struct NoParents {};
+
+    lib::CountedVector<Distance, lib::MemoryCategory::Caches> dist_;
+    [[no_unique_address]] std::conditional_t<TrackParents, lib::CountedVector<Index, lib::MemoryCategory::Caches>, NoParents> parents_;
+};
+
+using DistanceLabels = SearchLabels<false>;
+using ParentLabels = SearchLabels<true>;
+
+/**
+ * @brief Distance labels in a hash map, for graphs too large for per-vertex arrays:
+ * memory follows the number of labeled vertices instead of the graph size
+ */
+class SparseLabels {
+   public:
+    using Index = std::uint32_t;
+    using Distance = float;
+    static constexpr bool kTracksParents = false;
+    static constexpr Distance kUnreached = std::numeric_limits<Distance>::infinity();
+    static constexpr Index kNoParent = std::numeric_limits<Index>::max();
+
+    void prepare(size_t) {}
+
+    void reset(Index v) {
+        dist_.erase(v);
+    }
+
+    Distance dist(Index v) const {
+        auto it = dist_.find(v);
+        return it == dist_.end() ? kUnreached : it->second;
+    }
+
+    void update(Index v, Distance dist, Index) {
+        dist_[v] = dist;
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Caches] += lib::hash_buckets_bytes(dist_) +
+                                            dist_.size() * (lib::kHashNodeOverhead + sizeof(Index) + sizeof(Distance));
+        return res;
+    }
+
+   private:
+    std::unordered_map<Index, Distance> dist_;
+};
+
+/**
+ * @brief Edge weights as stored in the graph
+ */
+struct GraphWeight {
+    template <typename Vertex>
+    float operator()(const CompiledGraph<Vertex>& graph, std::uint32_t edge) const {
+        return graph.weight(edge);
+    }
+};
+
+/**
+ * @brief Isochrone visitor: labels only distances passing cutoff, like single_source_dijkstra
+ * on Graph
+ */
+template <typename Cutoff>
+struct CutoffVisitor {
+    Cutoff& cutoff;
+
+    bool accept(float dist) {
+        return cutoff(dist);
+    }
+};
+
+/**
+ * @brief Multi-band isochrone visitor: settled vertices go to the first band whose limit
+ * is not below their distance; limits are increasing, the search stops at the last one
+ */
+struct BandsVisitor {
+    const std::vector<float>& limits;
+    std::vector<std::vector<std::uint32_t>>& bands;
+
+    bool accept(float dist) const {
+        return dist <= limits.back();
+    }
+
+    bool on_settle(std::uint32_t v, float dist) {
+        auto band = std::lower_bound(limits.begin(), limits.end(), dist) - limits.begin();
+        bands[band].push_back(v);
+        return true;
+    }
+};
+
+/**
+ * @brief Dijkstra on a CompiledGraph, CompressedGraph or PartitionedGraph assembled from policies,
+ * so variants share one loop:
+ *
+ * - Heap: clear(), empty(), size(), push(key, v), pop() -> (key, v), for_each_vertex(func),
+ *   memory_usage(), and top_key() for stepwise searches; keys are Labels::Distance
+ * - Labels: prepare(vertices_count), reset(v), dist(v), update(v, dist, parent), memory_usage();
+ *   ParentLabels also keeps the shortest path tree. Labels::Distance is the distance type.
+ * - Weight: weight(graph, edge) of an edge passed by graph.for_each_edge_id: a forward edge id of
+ *   CompiledGraph, GraphWeight reads the graph; CompressedWeight and PartitionedWeight read the
+ *   edges of the other graphs
+ *
+ * Visitor and instrumentation are arguments of run(). Visitor hooks are optional:
+ * accept(dist) decides whether a vertex may be labeled with dist (cutoff), on_settle(v, dist)
+ * sees settled vertices in distance order and stops the search by returning false,
+ * on_improve(v, dist) sees every new label including the sources, and potential(v) turns the
+ * search into A*: vertices are queued by dist + potential(v). An admissible but inconsistent
+ * potential reopens vertices, which then appear in settled() again. Missing hooks and
+ * NoSearchStats compile to nothing, so an instantiation is as fast as a loop written for it.
+ *
+ * Bidirectional and goal-directed engines drive searches themselves with start(), top_key() and
+ * step(), checking their own stopping rules between steps.
+ *
+ * Buffers are reused between runs, keep one search object per thread. Labels are reset from the
+ * settled vertices and the heap left by the previous run, which are all the vertices it labeled.
+ */
+template <typename Heap = BinaryHeap, typename Labels = DistanceLabels, typename Weight = GraphWeight>
+class DijkstraSearch {
+   public:
+    using Index = std::uint32_t;
+    using Distance = typename Labels::Distance;
+    static constexpr Distance kUnreached = Labels::kUnreached;
+
+    DijkstraSearch() = default;
+
+    explicit DijkstraSearch(Weight weight)
+        : weight_(std::move(weight)) {}
+
+    /**
+     * @param graph Searched graph; Backward searches need the transposed adjacency
+     * @param start Start vertex index
+     * @param visitor Search visitor
+     * @param stats Search stats collector
+     * @param direction Forward gives distances from start, Backward distances to start
+     */
+    template <typename Graph, typename Visitor, typename Stats>
+    void run(
+        const Graph& graph,
+        Index start,
+        Visitor&& visitor,
+        Stats& stats,
+        SearchDirection direction = SearchDirection::Forward
+    ) {
+        const std::pair<Index, Distance> source{start, 0};
+        run(graph, std::span<const std::pair<Index, Distance>>(&source, 1), visitor, stats, direction);
+    }
+
+    /**
+     * @brief Search from several sources with initial distances, e.g. boundary vertices reached by
+     * another search; a vertex gets the shortest distance over all sources
+     */
+    template <typename Graph, typename Visitor, typename Stats>
+    void run(
+        const Graph& graph,
+        std::span<const std::pair<Index, Distance>> sources,
+        Visitor&& visitor,
+        Stats& stats,
+        SearchDirection direction = SearchDirection::Forward
+    ) {
+        graph.check_direction(direction);
+        dispatch_direction(direction, [&](auto direction_tag) {
+            search<decltype(direction_tag)::value>(graph, sources, visitor, stats);
+        });
+    }
+
+    /**
+     * @brief Label and queue the sources of a stepwise search, forgetting the previous one
+     */
+    template <typename Graph, typename Visitor, typename Stats>
+    void start(const Graph& graph, std::span<const std::pair<Index, Distance>> sources, Visitor& visitor, Stats& stats) {
+        reset();
+        labels_.prepare(graph.vertices_count());
+
+        for (const auto& [start, dist] : sources) {
+            if (dist < labels_.dist(start)) {
+                improve(start, dist, Labels::kNoParent, visitor, stats);
+            }
+        }
+    }
+
+    bool empty() const {
+        return heap_.empty();
+    }
+
+    /**
+     * @brief The smallest queued key: a distance, or distance plus potential for A*
+     */
+    Distance top_key() const {
+        return heap_.empty() ? kUnreached : heap_.top_key();
+    }
+
+    /**
+     * @brief Pop the smallest key and settle its vertex unless the entry is outdated
+     *
+     * @return false if the visitor stopped the search
+     */
+    template <SearchDirection Direction, typename Graph, typename Visitor, typename Stats>
+    bool step(const Graph& graph, Visitor& visitor, Stats& stats) {
+        auto [key, v] = heap_.pop();
+        const Distance dst = labels_.dist(v);
+
+        if (queue_key(v, dst, visitor) < key) {
+            stats.on_stale_pop();
+            return true;
+        }
+        stats.on_settle();
+        settled_.push_back({v, dst});
+        if constexpr (requires { { visitor.on_settle(v, dst) } -> std::convertible_to<bool>; }) {
+            if (!visitor.on_settle(v, dst)) {
+                return false;
+            }
+        }
+
+        graph.template for_each_edge_id<Direction>(v, [&, v = v](Index u, auto edge) {
+            Distance n_dst = dst + weight_(graph, edge);
+            stats.on_relax();
+
+            if constexpr (requires { { visitor.accept(n_dst) } -> std::convertible_to<bool>; }) {
+                if (!visitor.accept(n_dst)) {
+                    return;
+                }
+            }
+
+            if (n_dst < labels_.dist(u)) {
+                improve(u, n_dst, v, visitor, stats);
+            }
+        });
+        return true;
+    }
+
+    /**
+     * @brief Distance labels of the last search; vertices it did not reach are kUnreached
+     */
+    const Labels& labels() const {
+        return labels_;
+    }
+
+    Distance dist(Index v) const {
+        return labels_.dist(v);
+    }
+
+    /**
+     * @brief Vertices settled by the last search with final distances, in settle order
+     */
+    const std::vector<std::pair<Index, Distance>>& settled() const {
+        return settled_;
+    }
+
+    lib::MemoryReport memory_usage() const {
+        auto res = heap_.memory_usage();
+        res += labels_.memory_usage();
+        res[lib::MemoryCategory::Results] += lib::vector_bytes(settled_);
+        return res;
+    }
+
+   private:
+    Heap heap_;
+    Labels labels_;
+    std::vector<std::pair<Index, Distance>> settled_;
+    [[no_unique_address]] Weight weight_;
+
+    void reset() {
+        for (const auto& [v, dist] : settled_) {
+            labels_.reset(v);
+        }
+        heap_.for_each_vertex([this](Index v) {
+            labels_.reset(v);
+        });
+        settled_.clear();
+        heap_.clear();
+    }
+
+    template <typename Visitor>
+    Distance queue_key(Index v, Distance dist, Visitor& visitor) {
+        if constexpr (requires { { visitor.potential(v) } -> std::convertible_to<Distance>; }) {
+            return dist + visitor.potential(v);
+        } else {
+            return dist;
+        }
+    }
+
+    template <typename Visitor, typename Stats>
+    void improve(Index v, Distance dist, Index parent, Visitor& visitor, Stats& stats) {
+        labels_.update(v, dist, parent);
+        heap_.push(queue_key(v, dist, visitor), v);
+        stats.on_push(heap_.size());
+        if constexpr (requires { visitor.on_improve(v, dist); }) {
+            visitor.on_improve(v, dist);
+        }
+    }
+
+    template <SearchDirection Direction, typename Graph, typename Visitor, typename Stats>
+    void search(const Graph& graph, std::span<const std::pair<Index, Distance>> sources, Visitor& visitor, Stats& stats) {
+        stats.on_start();
+        start(graph, sources, visitor, stats);
+        while (!heap_.empty()) {
+            if (!step<Direction>(graph, visitor, stats)) {
+                break;
+            }
+        }
+        stats.on_finish();
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
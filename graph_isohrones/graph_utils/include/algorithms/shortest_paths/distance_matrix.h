@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/thread_pool.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Dense row-major matrix of distances: rows are sources, columns are targets
+ */
+struct DistanceMatrix {
+    static constexpr float kUnreachable = std::numeric_limits<float>::infinity();
+
+    size_t rows = 0;
+    size_t cols = 0;
+    std::vector<float> data;
+
+    float at(size_t row, size_t col) const {
+        return data[row * cols + col];
+    }
+};
+
+namespace detail {
+
+// Columns of the target vertices; a vertex listed several times gets its first column here,
+// the other ones are copied from it after every search
+struct MatrixTargets {
+    static constexpr std::uint32_t kNotTarget = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<std::uint32_t> column_of;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> duplicates;
+    size_t distinct_count = 0;
+
+    MatrixTargets(size_t vertices_count, const std::vector<std::uint32_t>& targets)
+        : column_of(vertices_count, kNotTarget) {
+        for (std::uint32_t col = 0; col < targets.size(); col++) {
+            auto& first_col = column_of[targets[col]];
+            if (first_col == kNotTarget) {
+                first_col = col;
+                distinct_count++;
+            } else {
+                duplicates.push_back({col, first_col});
+            }
+        }
+    }
+};
+
+// Writes settled target distances into the row and stops the search once all targets are settled
+struct MatrixRowVisitor {
+    const MatrixTargets& targets;
+    float max_distance;
+    float* row;
+    size_t settled_targets = 0;
+
+    bool accept(float dist) const {
+        return dist <= max_distance;
+    }
+
+    bool on_settle(std::uint32_t v, float dist) {
+        if (targets.column_of[v] != MatrixTargets::kNotTarget) {
+            row[targets.column_of[v]] = dist;
+            settled_targets++;
+        }
+        return settled_targets < targets.distinct_count;
+    }
+};
+
+/**
+ * Dijkstra from source writing distances of the targets into row; stops as soon as all
+ * targets are settled or the queue passes max_distance
+ */
+template <typename Vertex>
+void matrix_row(
+    const CompiledGraph<Vertex>& graph,
+    std::uint32_t source,
+    const MatrixTargets& targets,
+    float max_distance,
+    SearchDirection direction,
+    DijkstraSearch<>& search,
+    float* row
+) {
+    NoSearchStats stats;
+    search.run(graph, source, MatrixRowVisitor{targets, max_distance, row}, stats, direction);
+
+    for (const auto& [col, first_col] : targets.duplicates) {
+        row[col] = row[first_col];
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Many-to-many shortest path distances into a caller provided buffer.
+ *
+ * Every row is a Dijkstra from its source which stops once all targets are settled, so the cost
+ * depends on how far the targets are, not on the graph size. Sources are processed in index
+ * order, so after locality reordering consecutive searches touch the same part of the graph,
+ * and are split into tiles of consecutive rows spread over the thread pool. Each worker reuses
+ * its buffers and writes its rows straight into the output.
+ *
+ * @param graph Compiled graph
+ * @param sources Row vertices indices
+ * @param targets Column vertices indices, may repeat
+ * @param out Buffer of sources.size() * targets.size() floats, row-major;
+ * unreachable pairs get DistanceMatrix::kUnreachable
+ * @param max_distance Pairs farther than this are left unreachable
+ * @param direction Backward fills the matrix with distances from targets to sources,
+ * which needs the transposed adjacency
+ * @param pool Thread pool running the tiles
+ * @param tile_rows Number of rows in one pool task
+ */
+template <typename Vertex>
+void distance_matrix(
+    const CompiledGraph<Vertex>& graph,
+    const std::vector<std::uint32_t>& sources,
+    const std::vector<std::uint32_t>& targets,
+    float* out,
+    float max_distance = DistanceMatrix::kUnreachable,
+    SearchDirection direction = SearchDirection::Forward,
+    ThreadPool& pool = ThreadPool::shared(),
+    size_t tile_rows = 8
+) {
+    graph.check_direction(direction);
+    const size_t cols = targets.size();
+    std::fill(out, out + sources.size() * cols, DistanceMatrix::kUnreachable);
+    if (sources.empty() || cols == 0) {
+        return;
+    }
+
+    detail::MatrixTargets matrix_targets(graph.vertices_count(), targets);
+    std::vector<DijkstraSearch<>> searches(pool.size());
+    std::vector<size_t> rows_order(sources.size());
+    std::iota(rows_order.begin(), rows_order.end(), 0);
+    std::stable_sort(rows_order.begin(), rows_order.end(), [&sources](size_t lhs, size_t rhs) {
+        return sources[lhs] < sources[rhs];
+    });
+
+    auto task = [&](size_t idx, int worker_id) {
+        size_t row = rows_order[idx];
+        detail::matrix_row(
+            graph, sources[row], matrix_targets, max_distance, direction, searches[worker_id], out + row * cols
+        );
+    };
+    pool.parallel_for(sources.size(), task, tile_rows, "distance_matrix");
+}
+
+template <typename Vertex>
+DistanceMatrix distance_matrix(
+    const CompiledGraph<Vertex>& graph,
+    const std::vector<Vertex>& sources,
+    const std::vector<Vertex>& targets,
+    float max_distance = DistanceMatrix::kUnreachable,
+    SearchDirection direction = SearchDirection::Forward,
+    ThreadPool& pool = ThreadPool::shared()
+) {
+    auto to_indices = [&graph](const std::vector<Vertex>& vertices) {
+        std::vector<std::uint32_t> res;
+        res.reserve(vertices.size());
+        for (const auto& vertex : vertices) {
+            res.push_back(graph.index(vertex));
+        }
+        return res;
+    };
+
+    DistanceMatrix res;
+    res.rows = sources.size();
+    res.cols = targets.size();
+    res.data.resize(res.rows * res.cols);
+    distance_matrix(graph, to_indices(sources), to_indices(targets), res.data.data(), max_distance, direction, pool);
+    return res;
+}
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/thread_pool.h>
+#include <algorithms/shortest_paths/contraction_hierarchy.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Hub of a label: rank of the hub vertex in the contraction order and the distance to
+ * (forward labels) or from (backward labels) it
+ */
+struct HubEntry {
+    std::uint32_t hub;
+    float dist;
+};
+
+/**
+ * @brief Label sizes of every vertex, in entries
+ */
+struct HubLabelsReport {
+    std::vector<std::uint32_t> forward_sizes;
+    std::vector<std::uint32_t> backward_sizes;
+    double average_size = 0;
+    std::uint32_t max_size = 0;
+    size_t bytes = 0;
+};
+
+namespace detail {
+
+struct HubLabelsHeader {
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::uint64_t vertices_count;
+    std::uint64_t fingerprint;
+    std::uint64_t forward_entries;
+    std::uint64_t backward_entries;
+};
+
+// File: header, forward offsets[vertices + 1], backward offsets[vertices + 1], forward entries,
+// backward entries, all 8-byte aligned
+constexpr std::uint64_t kHubLabelsMagic = 0x3142414c42554847ull;  // "GHUBLAB1"
+constexpr std::uint64_t kHubLabelsVersion = 1;
+
+// Minimum of forward.dist + backward.dist over common hubs of two labels sorted by hub
+inline float merge_labels(std::span<const HubEntry> forward, std::span<const HubEntry> backward) {
+    float res = std::numeric_limits<float>::infinity();
+    auto lhs = forward.begin();
+    auto rhs = backward.begin();
+    while (lhs != forward.end() && rhs != backward.end()) {
+        if (lhs->hub < rhs->hub) {
+            ++lhs;
+        } else if (rhs->hub < lhs->hub) {
+            ++rhs;
+        } else {
+            res = std::min(res, lhs->dist + rhs->dist);
+            ++lhs;
+            ++rhs;
+        }
+    }
+    return res;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Hub labeling distance oracle: every vertex keeps a forward label of hubs it reaches
+ * with distances and a backward label of hubs reaching it, so that the shortest s-t path passes
+ * through a hub common to the forward label of s and the backward label of t. A query merges
+ * the two labels, sorted by hub, without touching the graph.
+ *
+ * Labels come from a contraction hierarchy, top-down in rank order: the forward label of v is
+ * v itself plus the forward labels of its upward neighbors shifted by the edge weight, the
+ * backward label the same over downward edges. An entry is dropped when the labels already
+ * built give a shorter distance to its hub, which leaves exact distances to the hubs of shortest
+ * paths only.
+ *
+ * Labels are two CSR arrays of 8-byte entries. write() stores them in a file that open() maps
+ * read-only, so processes serving queries share one copy through the page cache. Queries are
+ * const and thread-safe.
+ */
+class HubLabels {
+   public:
+    using Index = std::uint32_t;
+
+    HubLabels() = default;
+    HubLabels(const HubLabels&) = delete;
+    HubLabels& operator=(const HubLabels&) = delete;
+
+    HubLabels(HubLabels&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    HubLabels& operator=(HubLabels&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            header_ = other.header_;
+            forward_offsets_ = std::move(other.forward_offsets_);
+            backward_offsets_ = std::move(other.backward_offsets_);
+            forward_entries_ = std::move(other.forward_entries_);
+            backward_entries_ = std::move(other.backward_entries_);
+            mapping_ = other.mapping_;
+            mapped_bytes_ = other.mapped_bytes_;
+            view_ = other.view_;
+            other.mapping_ = nullptr;
+            other.mapped_bytes_ = 0;
+            other.view_ = {};
+        }
+        return *this;
+    }
+
+    ~HubLabels() {
+        unmap();
+    }
+
+    /**
+     * @brief Build labels from a contraction hierarchy of the graph
+     *
+     * @param graph Compiled graph the hierarchy was built for
+     * @param hierarchy contract_graph(graph)
+     */
+    template <typename Vertex>
+    HubLabels(const CompiledGraph<Vertex>& graph, const ContractionHierarchy& hierarchy) {
+        const size_t count = graph.vertices_count();
+        if (hierarchy.vertices_count() != count) {
+            throw std::runtime_error("Contraction hierarchy does not match the graph vertices count");
+        }
+        header_.magic = detail::kHubLabelsMagic;
+        header_.version = detail::kHubLabelsVersion;
+        header_.vertices_count = count;
+        header_.fingerprint = graph.fingerprint();
+
+        std::vector<Index> by_rank(count);
+        for (Index v = 0; v < count; v++) {
+            by_rank[hierarchy.rank[v]] = v;
+        }
+
+        std::vector<std::vector<HubEntry>> forward(count), backward(count);
+        std::vector<HubEntry> merged;
+        for (Index rank = count; rank-- > 0;) {
+            Index v = by_rank[rank];
+            build_label(rank, forward, backward, merged, hierarchy.up_offsets[v], hierarchy.up_offsets[v + 1],
+                        hierarchy.up_targets, hierarchy.up_weights, by_rank);
+            forward[v] = merged;
+            build_label(rank, backward, forward, merged, hierarchy.down_offsets[v], hierarchy.down_offsets[v + 1],
+                        hierarchy.down_sources, hierarchy.down_weights, by_rank);
+            backward[v] = merged;
+        }
+
+        flatten(forward, forward_offsets_, forward_entries_);
+        flatten(backward, backward_offsets_, backward_entries_);
+        header_.forward_entries = forward_entries_.size();
+        header_.backward_entries = backward_entries_.size();
+        view_ = {forward_offsets_.data(), backward_offsets_.data(), forward_entries_.data(), backward_entries_.data()};
+    }
+
+    /**
+     * @brief Map labels written by write(); the file stays mapped until destruction
+     */
+    static HubLabels open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Can not open hub labels: " + path);
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(detail::HubLabelsHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Not a hub labels file: " + path);
+        }
+        void* mapping = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Can not map hub labels: " + path);
+        }
+
+        HubLabels res;
+        res.mapping_ = mapping;
+        res.mapped_bytes_ = st.st_size;
+        res.header_ = *static_cast<const detail::HubLabelsHeader*>(mapping);
+        const auto& header = res.header_;
+        if (header.magic != detail::kHubLabelsMagic || header.version != detail::kHubLabelsVersion ||
+            file_bytes(header) != res.mapped_bytes_) {
+            throw std::runtime_error("Not a hub labels file: " + path);
+        }
+
+        const char* pos = static_cast<const char*>(mapping) + sizeof(header);
+        res.view_.forward_offsets = take<std::uint64_t>(pos, header.vertices_count + 1);
+        res.view_.backward_offsets = take<std::uint64_t>(pos, header.vertices_count + 1);
+        res.view_.forward_entries = take<HubEntry>(pos, header.forward_entries);
+        res.view_.backward_entries = take<HubEntry>(pos, header.backward_entries);
+        return res;
+    }
+
+    void write(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Can not write hub labels: " + path);
+        }
+        auto write_array = [&out](const auto* data, size_t count) {
+            out.write(reinterpret_cast<const char*>(data), count * sizeof(*data));
+        };
+        write_array(&header_, 1);
+        write_array(view_.forward_offsets, vertices_count() + 1);
+        write_array(view_.backward_offsets, vertices_count() + 1);
+        write_array(view_.forward_entries, header_.forward_entries);
+        write_array(view_.backward_entries, header_.backward_entries);
+        if (!out) {
+            throw std::runtime_error("Can not write hub labels: " + path);
+        }
+    }
+
+    size_t vertices_count() const {
+        return header_.vertices_count;
+    }
+
+    /**
+     * @brief Fingerprint of the compiled graph the labels were built for
+     */
+    std::uint64_t fingerprint() const {
+        return header_.fingerprint;
+    }
+
+    bool is_mapped() const {
+        return mapping_ != nullptr;
+    }
+
+    std::span<const HubEntry> forward_label(Index v) const {
+        return {view_.forward_entries + view_.forward_offsets[v], view_.forward_entries + view_.forward_offsets[v + 1]};
+    }
+
+    std::span<const HubEntry> backward_label(Index v) const {
+        return {view_.backward_entries + view_.backward_offsets[v], view_.backward_entries + view_.backward_offsets[v + 1]};
+    }
+
+    /**
+     * @brief Shortest distance from s to t, infinity if t is unreachable
+     */
+    float distance(Index s, Index t) const {
+        return detail::merge_labels(forward_label(s), backward_label(t));
+    }
+
+    /**
+     * @brief Distances of (source, target) pairs
+     */
+    std::vector<float> distances(const std::vector<std::pair<Index, Index>>& pairs, ThreadPool& pool = ThreadPool::shared()) const {
+        std::vector<float> res(pairs.size());
+        pool.parallel_for(pairs.size(), [&](size_t i, int) {
+            res[i] = distance(pairs[i].first, pairs[i].second);
+        }, 4096, "hub_label_distances");
+        return res;
+    }
+
+    /**
+     * @brief Distances from every source to every target, row-major by source
+     */
+    std::vector<float> distance_table(const std::vector<Index>& sources, const std::vector<Index>& targets, ThreadPool& pool = ThreadPool::shared()) const {
+        std::vector<float> res(sources.size() * targets.size());
+        pool.parallel_for(sources.size(), [&](size_t row, int) {
+            auto forward = forward_label(sources[row]);
+            for (size_t col = 0; col < targets.size(); col++) {
+                res[row * targets.size() + col] = detail::merge_labels(forward, backward_label(targets[col]));
+            }
+        }, 1, "hub_label_table");
+        return res;
+    }
+
+    HubLabelsReport report() const {
+        HubLabelsReport res;
+        const size_t count = vertices_count();
+        res.forward_sizes.resize(count);
+        res.backward_sizes.resize(count);
+        for (Index v = 0; v < count; v++) {
+            res.forward_sizes[v] = forward_label(v).size();
+            res.backward_sizes[v] = backward_label(v).size();
+            res.max_size = std::max({res.max_size, res.forward_sizes[v], res.backward_sizes[v]});
+        }
+        size_t entries = header_.forward_entries + header_.backward_entries;
+        res.average_size = count > 0 ? static_cast<double>(entries) / (2 * count) : 0;
+        res.bytes = file_bytes(header_);
+        return res;
+    }
+
+    /**
+     * @brief Bytes of the labels; mapped labels are page cache, not counted
+     */
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Indexes] += lib::vector_bytes(forward_offsets_) + lib::vector_bytes(backward_offsets_) +
+                                             lib::vector_bytes(forward_entries_) + lib::vector_bytes(backward_entries_);
+        return res;
+    }
+
+   private:
+    struct View {
+        const std::uint64_t* forward_offsets = nullptr;
+        const std::uint64_t* backward_offsets = nullptr;
+        const HubEntry* forward_entries = nullptr;
+        const HubEntry* backward_entries = nullptr;
+    };
+
+    detail::HubLabelsHeader header_{};
+    std::vector<std::uint64_t> forward_offsets_;
+    std::vector<std::uint64_t> backward_offsets_;
+    std::vector<HubEntry> forward_entries_;
+    std::vector<HubEntry> backward_entries_;
+    void* mapping_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    View view_;
+
+    static size_t file_bytes(const detail::HubLabelsHeader& header) {
+        return sizeof(header) + 2 * (header.vertices_count + 1) * sizeof(std::uint64_t) +
+               (header.forward_entries + header.backward_entries) * sizeof(HubEntry);
+    }
+
+    template <typename T>
+    static const T* take(const char*& pos, size_t count) {
+        auto* res = reinterpret_cast<const T*>(pos);
+        pos += count * sizeof(T);
+        return res;
+    }
+
+    void unmap() {
+        if (mapping_ != nullptr) {
+            ::munmap(mapping_, mapped_bytes_);
+            mapping_ = nullptr;
+        }
+    }
+
+    // Label of the vertex with the rank from the labels of its neighbors, into merged; opposite
+    // are the labels of the other direction, used to prune entries with a shorter path via other hubs
+    static void build_label(
+        Index rank,
+        const std::vector<std::vector<HubEntry>>& labels,
+        const std::vector<std::vector<HubEntry>>& opposite,
+        std::vector<HubEntry>& merged,
+        Index first_edge,
+        Index last_edge,
+        const std::vector<Index>& neighbors,
+        const std::vector<float>& weights,
+        const std::vector<Index>& by_rank
+    ) {
+        merged.assign(1, HubEntry{rank, 0});
+        for (Index edge = first_edge; edge < last_edge; edge++) {
+            for (const auto& entry : labels[neighbors[edge]]) {
+                merged.push_back({entry.hub, entry.dist + weights[edge]});
+            }
+        }
+        std::sort(merged.begin(), merged.end(), [](const HubEntry& lhs, const HubEntry& rhs) {
+            return lhs.hub < rhs.hub || (lhs.hub == rhs.hub && lhs.dist < rhs.dist);
+        });
+        merged.erase(std::unique(merged.begin(), merged.end(), [](const HubEntry& lhs, const HubEntry& rhs) {
+            return lhs.hub == rhs.hub;
+        }), merged.end());
+
+        // The opposite label of a hub contains the hub itself, so the merge is at most the entry
+        std::vector<HubEntry> kept;
+        kept.reserve(merged.size());
+        for (const auto& entry : merged) {
+            if (entry.hub == rank || !(detail::merge_labels(merged, opposite[by_rank[entry.hub]]) < entry.dist)) {
+                kept.push_back(entry);
+            }
+        }
+        merged.swap(kept);
+    }
+
+    static void flatten(std::vector<std::vector<HubEntry>>& labels, std::vector<std::uint64_t>& offsets, std::vector<HubEntry>& entries) {
+        offsets.assign(1, 0);
+        for (auto& label : labels) {
+            entries.insert(entries.end(), label.begin(), label.end());
+            offsets.push_back(entries.size());
+            label = {};
+        }
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+namespace algorithms {
+
+enum class LandmarkSelection {
+    // Every next landmark is the vertex farthest from the chosen ones
+    Farthest,
+    // Goldberg-Werneck avoid: landmarks go where the current bounds are the weakest
+    Avoid,
+};
+
+namespace detail {
+
+using TreeSearch = DijkstraSearch<BinaryHeap, ParentLabels>;
+
+// Full Dijkstra in the direction; search keeps the settle order and the parents of the
+// shortest path tree, unreached vertices get infinite distance
+template <typename Vertex>
+void full_dijkstra(
+    const CompiledGraph<Vertex>& graph,
+    std::uint32_t start,
+    SearchDirection direction,
+    TreeSearch& search,
+    std::vector<float>& dist
+) {
+    struct NoVisitor {};
+    NoSearchStats stats;
+    search.run(graph, start, NoVisitor{}, stats, direction);
+    for (std::uint32_t v = 0; v < dist.size(); v++) {
+        dist[v] = search.dist(v);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief ALT preprocessing: distances from and to a few landmark vertices.
+ *
+ * By the triangle inequality d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L) for
+ * every landmark L, which gives A* lower bounds that see ferries, detours and one-ways the
+ * great-circle bound does not. Distances are quantized to 16 bits with a per-landmark step and
+ * stored vertex-major, so a bound reads one cache line per vertex. Rounding errors are subtracted
+ * from the bounds, so they stay lower bounds, but may be inconsistent by a quantization step.
+ */
+template <typename Vertex>
+class Landmarks {
+   public:
+    using Index = std::uint32_t;
+    using Code = std::uint16_t;
+    static constexpr Code kUnreachableCode = std::numeric_limits<Code>::max();
+
+   private:
+    static constexpr Index kInvalid = std::numeric_limits<Index>::max();
+    static constexpr std::uint64_t kFileMagic = 0x31544c41'48505247ull;  // "GRPHALT1"
+
+    size_t vertices_count_ = 0;
+    std::uint64_t fingerprint_ = 0;
+    std::vector<Index> landmarks_;
+    // Distance per quantization step of every landmark
+    std::vector<float> steps_;
+    // Quantized d(L, v) and d(v, L) at [v * landmarks count + L]
+    lib::CountedVector<Code, lib::MemoryCategory::Indexes> from_;
+    lib::CountedVector<Code, lib::MemoryCategory::Indexes> to_;
+
+    Landmarks() = default;
+
+    void add_landmark(Index landmark, const std::vector<float>& from_dist, const std::vector<float>& to_dist) {
+        float max_dist = 0;
+        for (size_t v = 0; v < vertices_count_; v++) {
+            for (float dist : {from_dist[v], to_dist[v]}) {
+                if (std::isfinite(dist)) {
+                    max_dist = std::max(max_dist, dist);
+                }
+            }
+        }
+        float step = max_dist > 0 ? max_dist / (kUnreachableCode - 1) : 1;
+
+        auto quantize = [step](float dist) -> Code {
+            if (!std::isfinite(dist)) {
+                return kUnreachableCode;
+            }
+            return std::min<float>(std::lround(dist / step), kUnreachableCode - 1);
+        };
+
+        // Tables are vertex-major, so every added landmark widens the rows
+        size_t old_count = landmarks_.size();
+        size_t new_count = old_count + 1;
+        decltype(from_) from(vertices_count_ * new_count);
+        decltype(to_) to(vertices_count_ * new_count);
+
+        for (size_t v = 0; v < vertices_count_; v++) {
+            std::copy_n(from_.begin() + v * old_count, old_count, from.begin() + v * new_count);
+            std::copy_n(to_.begin() + v * old_count, old_count, to.begin() + v * new_count);
+            from[v * new_count + old_count] = quantize(from_dist[v]);
+            to[v * new_count + old_count] = quantize(to_dist[v]);
+        }
+
+        from_ = std::move(from);
+        to_ = std::move(to);
+        landmarks_.push_back(landmark);
+        steps_.push_back(step);
+    }
+
+    template <typename T>
+    static void write_value(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    static void read_value(std::istream& in, T& value) {
+        in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    }
+
+    template <typename Vector>
+    static void write_vector(std::ostream& out, const Vector& vec) {
+        write_value<std::uint64_t>(out, vec.size());
+        out.write(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(vec[0]));
+    }
+
+    template <typename Vector>
+    static void read_vector(std::istream& in, Vector& vec) {
+        std::uint64_t size = 0;
+        read_value(in, size);
+        vec.resize(size);
+        in.read(reinterpret_cast<char*>(vec.data()), size * sizeof(vec[0]));
+    }
+
+   public:
+    /**
+     * @brief Select landmarks and compute their distance tables
+     *
+     * @param graph Compiled graph with the transposed adjacency
+     * @param count Number of landmarks, 8-16 is typical
+     * @param selection Landmark selection heuristic
+     * @param seed Seed of the random root vertices
+     */
+    Landmarks(const CompiledGraph<Vertex>& graph, size_t count, LandmarkSelection selection = LandmarkSelection::Avoid, unsigned seed = 0)
+        : vertices_count_(graph.vertices_count()), fingerprint_(graph.fingerprint()) {
+        if (vertices_count_ == 0) {
+            return;
+        }
+
+        graph.check_direction(SearchDirection::Backward);
+
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<Index> vertex_dist(0, vertices_count_ - 1);
+        std::vector<float> from_dist(vertices_count_);
+        std::vector<float> to_dist(vertices_count_);
+        detail::TreeSearch search;
+        std::vector<bool> is_landmark(vertices_count_, false);
+        // Farthest: distance from the closest landmark
+        std::vector<float> min_dist(vertices_count_);
+        // Avoid: shortest path tree from a random root with subtree sizes
+        std::vector<float> root_dist(vertices_count_);
+        std::vector<double> sizes(vertices_count_, 0);
+        std::vector<bool> covered(vertices_count_, false);
+        std::vector<Index> best_child(vertices_count_, kInvalid);
+        size_t attempts = 0;
+
+        count = std::min(count, vertices_count_);
+        while (landmarks_.size() < count && attempts++ < count * 4) {
+            Index landmark = vertex_dist(gen);
+
+            if (selection == LandmarkSelection::Farthest) {
+                if (landmarks_.empty()) {
+                    detail::full_dijkstra(graph, landmark, SearchDirection::Forward, search, min_dist);
+                }
+                for (Index v = 0; v < vertices_count_; v++) {
+                    if (!is_landmark[v] && std::isfinite(min_dist[v]) && (is_landmark[landmark] || min_dist[v] > min_dist[landmark])) {
+                        landmark = v;
+                    }
+                }
+            } else {
+                // Vertex weight is how much the current bound to the root underestimates the distance;
+                // subtrees with a landmark are covered already, so the walk descends into the heaviest other one
+                Index root = landmark;
+                detail::full_dijkstra(graph, root, SearchDirection::Forward, search, root_dist);
+                const auto& settled = search.settled();
+
+                for (auto it = settled.rbegin(); it != settled.rend(); it++) {
+                    Index v = it->first;
+                    covered[v] = covered[v] || is_landmark[v];
+                    sizes[v] = covered[v] ? 0 : sizes[v] + std::max(0.0f, root_dist[v] - lower_bound(root, v));
+
+                    if (v != root) {
+                        Index parent = search.labels().parent(v);
+                        sizes[parent] += sizes[v];
+                        covered[parent] = covered[parent] || covered[v];
+                        if (best_child[parent] == kInvalid || sizes[v] > sizes[best_child[parent]]) {
+                            best_child[parent] = v;
+                        }
+                    }
+                }
+
+                while (best_child[landmark] != kInvalid && sizes[best_child[landmark]] > 0) {
+                    landmark = best_child[landmark];
+                }
+                for (const auto& [v, dist] : settled) {
+                    sizes[v] = 0;
+                    covered[v] = false;
+                    best_child[v] = kInvalid;
+                }
+            }
+
+            if (is_landmark[landmark]) {
+                continue;
+            }
+
+            detail::full_dijkstra(graph, landmark, SearchDirection::Forward, search, from_dist);
+            detail::full_dijkstra(graph, landmark, SearchDirection::Backward, search, to_dist);
+            add_landmark(landmark, from_dist, to_dist);
+            is_landmark[landmark] = true;
+
+            for (size_t v = 0; v < vertices_count_; v++) {
+                min_dist[v] = landmarks_.size() == 1 ? from_dist[v] : std::min(min_dist[v], from_dist[v]);
+            }
+        }
+    }
+
+    size_t size() const {
+        return landmarks_.size();
+    }
+
+    /**
+     * @brief Indices of the landmark vertices
+     */
+    const std::vector<Index>& vertices() const {
+        return landmarks_;
+    }
+
+    /**
+     * @brief Lower bound of the shortest path distance from v to t, zero if landmarks know nothing
+     */
+    float lower_bound(Index v, Index t) const {
+        const size_t count = landmarks_.size();
+        const Code* from_v = from_.data() + v * count;
+        const Code* from_t = from_.data() + t * count;
+        const Code* to_v = to_.data() + v * count;
+        const Code* to_t = to_.data() + t * count;
+        float res = 0;
+
+        for (size_t l = 0; l < count; l++) {
+            // Rounding moves every code by at most half a step, so one step is taken off the difference
+            int diff = 0;
+            if (from_v[l] != kUnreachableCode && from_t[l] != kUnreachableCode) {
+                diff = std::max(diff, int(from_t[l]) - int(from_v[l]) - 1);
+            }
+            if (to_v[l] != kUnreachableCode && to_t[l] != kUnreachableCode) {
+                diff = std::max(diff, int(to_v[l]) - int(to_t[l]) - 1);
+            }
+            res = std::max(res, diff * steps_[l]);
+        }
+        return res;
+    }
+
+    /**
+     * @brief Whether the tables were computed for this graph
+     */
+    bool matches(const CompiledGraph<Vertex>& graph) const {
+        return graph.vertices_count() == vertices_count_ && graph.fingerprint() == fingerprint_;
+    }
+
+    /**
+     * @brief Write the tables in a binary format tied to the graph fingerprint
+     */
+    void save(std::ostream& out) const {
+        write_value(out, kFileMagic);
+        write_value<std::uint64_t>(out, vertices_count_);
+        write_value(out, fingerprint_);
+        write_vector(out, landmarks_);
+        write_vector(out, steps_);
+        write_vector(out, from_);
+        write_vector(out, to_);
+        if (!out) {
+            throw std::runtime_error("Can not write landmarks");
+        }
+    }
+
+    /**
+     * @brief Read tables written by save; throws std::runtime_error if they belong to another graph
+     */
+    static Landmarks load(std::istream& in, const CompiledGraph<Vertex>& graph) {
+        Landmarks res;
+        std::uint64_t magic = 0;
+        std::uint64_t vertices_count = 0;
+
+        read_value(in, magic);
+        if (!in || magic != kFileMagic) {
+            throw std::runtime_error("Not a landmarks file");
+        }
+        read_value(in, vertices_count);
+        read_value(in, res.fingerprint_);
+        res.vertices_count_ = vertices_count;
+        if (!in || !res.matches(graph)) {
+            throw std::runtime_error("Landmarks were computed for another graph");
+        }
+
+        read_vector(in, res.landmarks_);
+        read_vector(in, res.steps_);
+        read_vector(in, res.from_);
+        read_vector(in, res.to_);
+
+        size_t table_size = res.vertices_count_ * res.landmarks_.size();
+        if (!in || res.steps_.size() != res.landmarks_.size() || res.from_.size() != table_size || res.to_.size() != table_size) {
+            throw std::runtime_error("Landmarks file is truncated");
+        }
+        return res;
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Indexes] += lib::vector_bytes(from_) + lib::vector_bytes(to_) +
+                                             lib::vector_bytes(landmarks_) + lib::vector_bytes(steps_);
+        return res;
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/graph_partition.h>
+#include <algorithms/thread_pool.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Metric-independent part of a customizable multilevel overlay (CRP): nested cells and
+ * their boundary vertices, computed once per graph topology.
+ *
+ * The graph is split by geometric_partition into 2^(fanout_bits * levels) cells of level 1; level
+ * l + 1 merges 2^fanout_bits cells of level l, so the cell of v at level l is its level 1 cell id
+ * shifted right by fanout_bits * (l - 1). A boundary vertex of level l has an edge to or from
+ * another cell of that level; boundary vertices of level l + 1 are boundary vertices of level l.
+ * Every cell of every level gets a clique of shortest distances between its boundary vertices,
+ * laid out here and filled by OverlayMetric for a weight vector.
+ */
+template <typename Vertex>
+class MultilevelOverlay {
+   public:
+    using Index = std::uint32_t;
+    static constexpr Index kInvalidIndex = std::numeric_limits<Index>::max();
+
+    /**
+     * The graph needs at least 2^(levels * fanout_bits) vertices, one per level 1 cell: 4096 for the
+     * defaults. Small graphs need fewer levels or a smaller fanout.
+     *
+     * @param graph Compiled graph with coordinates; the overlay keeps a reference to it
+     * @param levels Number of overlay levels
+     * @param fanout_bits Every cell splits into 2^fanout_bits cells of the level below
+     * @param imbalance Allowed deviation of cell sizes, see geometric_partition
+     */
+    explicit MultilevelOverlay(const CompiledGraph<Vertex>& graph, Index levels = 3, Index fanout_bits = 4, double imbalance = 0.05)
+        : graph_(graph), levels_(levels), fanout_bits_(fanout_bits) {
+        if (levels == 0 || fanout_bits == 0 || levels * fanout_bits > 24) {
+            throw std::runtime_error("Overlay needs 1 to 24 cell bits over all levels, got " + std::to_string(levels) + " levels of " + std::to_string(fanout_bits));
+        }
+        const size_t count = graph.vertices_count();
+        if ((size_t(1) << (levels * fanout_bits)) > count) {
+            throw std::runtime_error("Overlay of " + std::to_string(levels) + " levels with fanout_bits " + std::to_string(fanout_bits) +
+                                     " needs 2^" + std::to_string(levels * fanout_bits) + " level 1 cells, more than " +
+                                     std::to_string(count) + " vertices; use fewer levels or fanout_bits");
+        }
+        cell_of_ = geometric_partition(graph, Index(1) << (levels * fanout_bits), imbalance).shard_of;
+
+        // The highest level where a vertex has a neighbor in another cell
+        std::vector<Index> boundary_level(count, 0);
+        for (Index v = 0; v < count; v++) {
+            for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+                Index u = graph.target(edge);
+                Index level = separating_level(v, u);
+                boundary_level[v] = std::max(boundary_level[v], level);
+                boundary_level[u] = std::max(boundary_level[u], level);
+            }
+        }
+
+        levels_data_.resize(levels);
+        for (Index level = 1; level <= levels; level++) {
+            auto& data = levels_data_[level - 1];
+            const Index cells = Index(1) << ((levels - level + 1) * fanout_bits);
+            data.offsets.assign(cells + 1, 0);
+            for (Index v = 0; v < count; v++) {
+                if (boundary_level[v] >= level) {
+                    data.offsets[cell(v, level) + 1]++;
+                }
+            }
+            for (Index c = 0; c < cells; c++) {
+                data.offsets[c + 1] += data.offsets[c];
+            }
+            // Vertices in index order, so every cell's list is sorted
+            data.boundary.resize(data.offsets[cells]);
+            std::vector<Index> fill(data.offsets.begin(), data.offsets.end() - 1);
+            for (Index v = 0; v < count; v++) {
+                if (boundary_level[v] >= level) {
+                    data.boundary[fill[cell(v, level)]++] = v;
+                }
+            }
+
+            data.clique_offsets.assign(cells + 1, 0);
+            for (Index c = 0; c < cells; c++) {
+                size_t size = data.offsets[c + 1] - data.offsets[c];
+                data.clique_offsets[c + 1] = data.clique_offsets[c] + size * size;
+            }
+        }
+    }
+
+    MultilevelOverlay(const MultilevelOverlay&) = delete;
+    MultilevelOverlay& operator=(const MultilevelOverlay&) = delete;
+
+    const CompiledGraph<Vertex>& graph() const {
+        return graph_;
+    }
+
+    Index levels() const {
+        return levels_;
+    }
+
+    Index cells_count(Index level) const {
+        return levels_data_[level - 1].offsets.size() - 1;
+    }
+
+    Index cell(Index v, Index level) const {
+        return cell_of_[v] >> (fanout_bits_ * (level - 1));
+    }
+
+    /**
+     * @brief The highest level at which v and u are in different cells, 0 for the same level 1 cell
+     */
+    Index separating_level(Index v, Index u) const {
+        return (std::bit_width(cell_of_[v] ^ cell_of_[u]) + fanout_bits_ - 1) / fanout_bits_;
+    }
+
+    /**
+     * @brief Boundary vertices of the cell in increasing order
+     */
+    std::span<const Index> boundary(Index level, Index cell) const {
+        const auto& data = levels_data_[level - 1];
+        return {data.boundary.data() + data.offsets[cell], data.boundary.data() + data.offsets[cell + 1]};
+    }
+
+    /**
+     * @brief Position of v in the boundary of its cell at the level, kInvalidIndex for inner vertices
+     */
+    Index boundary_position(Index v, Index level) const {
+        auto vertices = boundary(level, cell(v, level));
+        auto it = std::lower_bound(vertices.begin(), vertices.end(), v);
+        return it != vertices.end() && *it == v ? it - vertices.begin() : kInvalidIndex;
+    }
+
+    size_t boundary_count(Index level) const {
+        return levels_data_[level - 1].boundary.size();
+    }
+
+    /**
+     * @brief Offset of the cell's clique, a row-major boundary x boundary matrix, in the level's distances
+     */
+    size_t clique_offset(Index level, Index cell) const {
+        return levels_data_[level - 1].clique_offsets[cell];
+    }
+
+    size_t clique_size(Index level) const {
+        return levels_data_[level - 1].clique_offsets.back();
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Indexes] += lib::vector_bytes(cell_of_) + lib::vector_bytes(levels_data_);
+        for (const auto& data : levels_data_) {
+            res[lib::MemoryCategory::Topology] += lib::vector_bytes(data.offsets) + lib::vector_bytes(data.boundary) +
+                                                  lib::vector_bytes(data.clique_offsets);
+        }
+        return res;
+    }
+
+   private:
+    struct Level {
+        // Boundary vertices grouped by cell
+        std::vector<Index> offsets;
+        std::vector<Index> boundary;
+        std::vector<size_t> clique_offsets;
+    };
+
+    const CompiledGraph<Vertex>& graph_;
+    Index levels_;
+    Index fanout_bits_;
+    std::vector<Index> cell_of_;
+    std::vector<Level> levels_data_;
+};
+
+template <typename Vertex>
+class OverlayMetric;
+
+/**
+ * @brief Overlay of an OverlayMetric as a graph for DijkstraSearch. A vertex of level l > 0 has
+ * the clique edges of its level l cell and the graph edges leaving that cell; a vertex of level 0
+ * has all its graph edges. Edges carry their weights, read by OverlayWeight.
+ */
+template <typename Vertex>
+class OverlayGraph {
+   public:
+    using Index = std::uint32_t;
+
+    struct EdgeRef {
+        float weight;
+    };
+
+    /**
+     * @brief Query graph of s and t: every vertex takes the highest level whose cells separate it
+     * from both s and t
+     */
+    static OverlayGraph query(const OverlayMetric<Vertex>& metric, Index s, Index t) {
+        return OverlayGraph(metric, s, t, kQueryLevel, 0, 0);
+    }
+
+    /**
+     * @brief Overlay of one level restricted to a cell of the level above, the graph a
+     * customization searches to fill that cell's clique
+     */
+    static OverlayGraph cell(const OverlayMetric<Vertex>& metric, Index level, Index cell) {
+        return OverlayGraph(metric, 0, 0, level, level + 1, cell);
+    }
+
+    size_t vertices_count() const {
+        return overlay_.graph().vertices_count();
+    }
+
+    void check_direction(SearchDirection direction) const {
+        if (direction == SearchDirection::Backward) {
+            throw std::runtime_error("Overlay searches run forward only");
+        }
+    }
+
+    Index level(Index v) const {
+        if (level_ != kQueryLevel) {
+            return level_;
+        }
+        return std::min(overlay_.separating_level(v, s_), overlay_.separating_level(v, t_));
+    }
+
+    /**
+     * @brief Call relax(neighbor, EdgeRef) for overlay edges out of v
+     */
+    template <SearchDirection Direction, typename Relax>
+    void for_each_edge_id(Index v, Relax&& relax) const {
+        const auto& graph = overlay_.graph();
+        const Index v_level = level(v);
+        const Index v_cell = v_level > 0 ? overlay_.cell(v, v_level) : 0;
+
+        if (v_level > 0) {
+            Index position = overlay_.boundary_position(v, v_level);
+            if (position != MultilevelOverlay<Vertex>::kInvalidIndex) {
+                auto boundary = overlay_.boundary(v_level, v_cell);
+                const float* row = metric_.clique(v_level, v_cell) + size_t(position) * boundary.size();
+                for (size_t i = 0; i < boundary.size(); i++) {
+                    if (i != position && row[i] != kNoPath) {
+                        relax(boundary[i], EdgeRef{row[i]});
+                    }
+                }
+            }
+        }
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            Index u = graph.target(edge);
+            if (v_level > 0 && overlay_.cell(u, v_level) == v_cell) {
+                continue;
+            }
+            if (bound_level_ > 0 && overlay_.cell(u, bound_level_) != bound_cell_) {
+                continue;
+            }
+            relax(u, EdgeRef{metric_.weight(edge)});
+        }
+    }
+
+   private:
+    static constexpr Index kQueryLevel = std::numeric_limits<Index>::max();
+    static constexpr float kNoPath = std::numeric_limits<float>::infinity();
+
+    const OverlayMetric<Vertex>& metric_;
+    const MultilevelOverlay<Vertex>& overlay_;
+    Index s_;
+    Index t_;
+    Index level_;
+    // Edges leaving this cell are skipped, bound_level_ 0 keeps all
+    Index bound_level_;
+    Index bound_cell_;
+
+    OverlayGraph(const OverlayMetric<Vertex>& metric, Index s, Index t, Index level, Index bound_level, Index bound_cell)
+        : metric_(metric), overlay_(metric.overlay()), s_(s), t_(t), level_(level), bound_level_(bound_level), bound_cell_(bound_cell) {}
+};
+
+/**
+ * @brief Weight policy of DijkstraSearch for OverlayGraph, edges carry their weight
+ */
+struct OverlayWeight {
+    template <typename Vertex>
+    float operator()(const OverlayGraph<Vertex>&, typename OverlayGraph<Vertex>::EdgeRef edge) const {
+        return edge.weight;
+    }
+};
+
+using OverlayDijkstraSearch = DijkstraSearch<BinaryHeap, DistanceLabels, OverlayWeight>;
+
+/**
+ * @brief Metric of a MultilevelOverlay: edge weights and the cliques computed from them.
+ *
+ * Customization fills the cliques bottom-up. A level 1 clique comes from searches inside the cell
+ * on graph edges; a level l clique from searches inside the cell over the level l - 1 cliques of
+ * its subcells and the graph edges between them, so it touches boundary vertices only. Cells of a
+ * level are independent and run in parallel. New weights need a new customize() only, the
+ * partition and boundaries stay.
+ */
+template <typename Vertex>
+class OverlayMetric {
+   public:
+    using Index = std::uint32_t;
+
+    /**
+     * @brief Metric of the graph's own weights
+     */
+    explicit OverlayMetric(const MultilevelOverlay<Vertex>& overlay, ThreadPool& pool = ThreadPool::shared())
+        : overlay_(overlay) {
+        const auto& graph = overlay.graph();
+        std::vector<float> weights(graph.edges_count());
+        for (Index edge = 0; edge < weights.size(); edge++) {
+            weights[edge] = graph.weight(edge);
+        }
+        customize(std::move(weights), pool);
+    }
+
+    OverlayMetric(const MultilevelOverlay<Vertex>& overlay, std::vector<float> weights, ThreadPool& pool = ThreadPool::shared())
+        : overlay_(overlay) {
+        customize(std::move(weights), pool);
+    }
+
+    OverlayMetric(const OverlayMetric&) = delete;
+    OverlayMetric& operator=(const OverlayMetric&) = delete;
+
+    /**
+     * @brief Replace the weights and recompute all cliques; queries must not run meanwhile
+     *
+     * @param weights Non-negative weight of every edge id of the graph
+     * @param pool Pool running the cells of a level
+     */
+    void customize(std::vector<float> weights, ThreadPool& pool = ThreadPool::shared()) {
+        if (weights.size() != overlay_.graph().edges_count()) {
+            throw std::runtime_error("Metric has " + std::to_string(weights.size()) + " weights for " + std::to_string(overlay_.graph().edges_count()) + " edges");
+        }
+        if (std::any_of(weights.begin(), weights.end(), [](float weight) { return !(weight >= 0); })) {
+            throw std::runtime_error("Metric weights must be non-negative");
+        }
+        weights_ = std::move(weights);
+        cliques_.resize(overlay_.levels());
+
+        std::vector<OverlayDijkstraSearch> searches(pool.size());
+        for (Index level = 1; level <= overlay_.levels(); level++) {
+            cliques_[level - 1].assign(overlay_.clique_size(level), std::numeric_limits<float>::infinity());
+            pool.parallel_for(overlay_.cells_count(level), [&](size_t cell, int worker_id) {
+                customize_cell(level, cell, searches[worker_id]);
+            }, 1, "overlay_customization");
+        }
+    }
+
+    const MultilevelOverlay<Vertex>& overlay() const {
+        return overlay_;
+    }
+
+    float weight(Index edge) const {
+        return weights_[edge];
+    }
+
+    /**
+     * @brief Clique of the cell, row-major by boundary position; infinity for no path inside the cell
+     */
+    const float* clique(Index level, Index cell) const {
+        return cliques_[level - 1].data() + overlay_.clique_offset(level, cell);
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Weights] += lib::vector_bytes(weights_) + lib::vector_bytes(cliques_);
+        for (const auto& clique : cliques_) {
+            res[lib::MemoryCategory::Weights] += lib::vector_bytes(clique);
+        }
+        return res;
+    }
+
+   private:
+    const MultilevelOverlay<Vertex>& overlay_;
+    std::vector<float> weights_;
+    std::vector<std::vector<float>> cliques_;
+
+    void customize_cell(Index level, Index cell, OverlayDijkstraSearch& search) {
+        auto boundary = overlay_.boundary(level, cell);
+        float* clique = cliques_[level - 1].data() + overlay_.clique_offset(level, cell);
+        auto graph = OverlayGraph<Vertex>::cell(*this, level - 1, cell);
+        struct NoVisitor {};
+        NoSearchStats stats;
+
+        for (size_t from = 0; from < boundary.size(); from++) {
+            search.run(graph, boundary[from], NoVisitor{}, stats);
+            for (size_t to = 0; to < boundary.size(); to++) {
+                clique[from * boundary.size() + to] = search.dist(boundary[to]);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Shortest distance from s to t searching the overlay: full graph edges near s and t, cell
+ * cliques of higher levels farther away. Infinity if t is unreachable.
+ */
+template <typename Vertex, typename Stats>
+float overlay_distance(
+    const OverlayMetric<Vertex>& metric,
+    std::uint32_t s,
+    std::uint32_t t,
+    OverlayDijkstraSearch& search,
+    Stats& stats
+) {
+    struct TargetVisitor {
+        std::uint32_t target;
+
+        bool on_settle(std::uint32_t v, float) const {
+            return v != target;
+        }
+    };
+    search.run(OverlayGraph<Vertex>::query(metric, s, t), s, TargetVisitor{t}, stats);
+    return search.dist(t);
+}
+
+template <typename Vertex>
+float overlay_distance(const OverlayMetric<Vertex>& metric, const Vertex& s, const Vertex& t) {
+    const auto& graph = metric.overlay().graph();
+    OverlayDijkstraSearch search;
+    NoSearchStats stats;
+    return overlay_distance(metric, graph.index(s), graph.index(t), search, stats);
+}
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <partitioned_graph.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Weight policy of DijkstraSearch for PartitionedGraph, edges carry their weight
+ */
+struct PartitionedWeight {
+    float operator()(const PartitionedGraph&, PartitionedGraph::EdgeRef edge) const {
+        return edge.weight;
+    }
+};
+
+/**
+ * @brief Dijkstra on a PartitionedGraph; labels live in a hash map, so a search on a continent
+ * graph takes memory for the vertices it reaches only
+ */
+using PartitionedDijkstraSearch = DijkstraSearch<BinaryHeap, SparseLabels, PartitionedWeight>;
+
+/**
+ * @brief single_source_dijkstra on a PartitionedGraph, mapping cells as the frontier reaches them.
+ * Results are in search.settled() as vertices of the partitioned graph.
+ */
+template <typename Cutoff, typename Stats>
+void partitioned_dijkstra(
+    const PartitionedGraph& graph,
+    std::uint32_t start,
+    Cutoff&& cutoff,
+    PartitionedDijkstraSearch& search,
+    Stats& stats,
+    SearchDirection direction = SearchDirection::Forward
+) {
+    CutoffVisitor<std::remove_reference_t<Cutoff>> visitor{cutoff};
+    search.run(graph, start, visitor, stats, direction);
+}
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,407 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/landmarks.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <algorithms/thread_pool.h>
+#include <geo_utils/distance.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+namespace algorithms {
+
+enum class PointToPointHeuristic {
+    // Plain bidirectional Dijkstra
+    None,
+    // Bidirectional A* with great-circle lower bounds, needs vertex coordinates
+    GreatCircle,
+    // A* with ALT landmark lower bounds
+    Landmarks,
+};
+
+namespace detail {
+
+// Visitor of one side of a goal-directed search: queue keys add the potential, new labels are reported
+template <typename Potential, typename OnImprove>
+struct GuidedVisitor {
+    Potential& potential_of;
+    OnImprove& improved;
+
+    float potential(std::uint32_t v) {
+        return potential_of(v);
+    }
+
+    void on_improve(std::uint32_t v, float dist) {
+        improved(v, dist);
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Reusable buffers of point-to-point queries, one per thread
+ */
+struct PointToPointWorkspace {
+    DijkstraSearch<> forward;
+    DijkstraSearch<> backward;
+    // Forward potential per vertex, NaN until computed
+    lib::CountedVector<float, lib::MemoryCategory::Caches> potential;
+    std::vector<std::uint32_t> potential_touched;
+    // Targets of the running one-to-many query: 1 until reached, then 2
+    std::vector<char> is_target;
+};
+
+/**
+ * @brief Shortest path distances between pairs of vertices.
+ *
+ * Runs a forward search from the source and a backward search from the target over incoming
+ * edges, always advancing the side with the smaller queue key, and stops as soon as no path
+ * through unsettled vertices can beat the best meeting point found. With the great-circle
+ * heuristic both sides are A* searches with the average potential
+ * p(v) = (lb(v, target) - lb(source, v)) / 2, where lb is a great-circle lower bound divided by
+ * max_speed, so only vertices around the straight line between the endpoints get settled.
+ * The bound is the chord through the sphere between precomputed unit vectors: it is within
+ * a millimeter of the arc at city distances and costs a square root instead of trigonometry.
+ *
+ * Landmark bounds are much tighter on networks with ferries and detours, but quantization makes
+ * them only admissible, not consistent, so with landmarks the engine runs a forward A* which
+ * reopens vertices when their distance improves and stays exact.
+ *
+ * The bidirectional search walks incoming edges, so the graph needs the transposed adjacency.
+ */
+template <typename Vertex>
+class PointToPointEngine {
+   public:
+    using Index = std::uint32_t;
+    static constexpr float kUnreachable = std::numeric_limits<float>::infinity();
+
+   private:
+    const CompiledGraph<Vertex>& graph_;
+    PointToPointHeuristic heuristic_;
+    double max_speed_;
+    // Vertices on the unit sphere for the great-circle heuristic, empty without it
+    lib::CountedVector<std::array<double, 3>, lib::MemoryCategory::Coordinates> points_;
+    const Landmarks<Vertex>* landmarks_ = nullptr;
+
+    // Potentials are a minimum over the targets, so they only pay off for a few of them
+    static constexpr size_t kMaxPotentialTargets = 32;
+
+    float lower_bound(Index from, Index to) const {
+        if (heuristic_ == PointToPointHeuristic::Landmarks) {
+            return landmarks_->lower_bound(from, to);
+        }
+        return geo_utils::chord_distance(points_[from], points_[to]) / max_speed_;
+    }
+
+    float potential(Index v, Index source, Index target, PointToPointWorkspace& workspace) const {
+        if (heuristic_ == PointToPointHeuristic::None) {
+            return 0;
+        }
+        float& res = workspace.potential[v];
+        if (std::isnan(res)) {
+            res = (lower_bound(v, target) - lower_bound(source, v)) / 2;
+            workspace.potential_touched.push_back(v);
+        }
+        return res;
+    }
+
+    // Lower bound of the distance from v to the closest target, or from it for backward searches
+    float targets_potential(Index v, const std::vector<Index>& targets, SearchDirection direction, PointToPointWorkspace& workspace) const {
+        if (heuristic_ == PointToPointHeuristic::None || targets.size() > kMaxPotentialTargets) {
+            return 0;
+        }
+        float& res = workspace.potential[v];
+        if (std::isnan(res)) {
+            res = kUnreachable;
+            for (auto target : targets) {
+                res = std::min(res, direction == SearchDirection::Forward ? lower_bound(v, target) : lower_bound(target, v));
+            }
+            workspace.potential_touched.push_back(v);
+        }
+        return res;
+    }
+
+    /**
+     * A* from source until distances of all targets are final. The potential only has to
+     * be admissible: a vertex is pushed again whenever its distance improves, and the search stops
+     * once the smallest key is not below the largest target distance, because every key is a
+     * lower bound of any target distance through its vertex.
+     */
+    template <typename Stats>
+    void one_way_search(
+        Index source,
+        const std::vector<Index>& targets,
+        SearchDirection direction,
+        PointToPointWorkspace& workspace,
+        Stats& stats
+    ) const {
+        graph_.check_direction(direction);
+        prepare(workspace);
+        stats.on_start();
+        auto& side = workspace.forward;
+        auto& is_target = workspace.is_target;
+        is_target.resize(graph_.vertices_count(), 0);
+
+        size_t unreached_targets = 0;
+        for (auto target : targets) {
+            if (!is_target[target]) {
+                is_target[target] = 1;
+                unreached_targets++;
+            }
+        }
+
+        float worst_target = kUnreachable;
+        bool target_improved = false;
+
+        auto potential_of = [&](Index v) {
+            return targets_potential(v, targets, direction, workspace);
+        };
+        auto improved = [&](Index u, float) {
+            if (is_target[u]) {
+                unreached_targets -= is_target[u] == 1;
+                is_target[u] = 2;
+                target_improved = true;
+            }
+        };
+        detail::GuidedVisitor<decltype(potential_of), decltype(improved)> visitor{potential_of, improved};
+        const std::pair<Index, float> start{source, 0};
+        side.start(graph_, std::span<const std::pair<Index, float>>(&start, 1), visitor, stats);
+
+        dispatch_direction(direction, [&](auto direction_tag) {
+            while (!side.empty()) {
+                if (unreached_targets == 0 && target_improved) {
+                    worst_target = 0;
+                    for (auto target : targets) {
+                        worst_target = std::max(worst_target, side.dist(target));
+                    }
+                    target_improved = false;
+                }
+                if (side.top_key() >= worst_target) {
+                    break;
+                }
+                side.template step<decltype(direction_tag)::value>(graph_, visitor, stats);
+            }
+        });
+
+        for (auto target : targets) {
+            is_target[target] = 0;
+        }
+        stats.on_finish();
+    }
+
+    // Potentials are cached per query, the search sides reset themselves when started
+    void prepare(PointToPointWorkspace& workspace) const {
+        size_t count = graph_.vertices_count();
+        if (workspace.potential.size() != count) {
+            workspace.potential.assign(count, std::numeric_limits<float>::quiet_NaN());
+        } else {
+            for (auto v : workspace.potential_touched) {
+                workspace.potential[v] = std::numeric_limits<float>::quiet_NaN();
+            }
+        }
+        workspace.potential_touched.clear();
+    }
+
+   public:
+    /**
+     * @brief Engine over the graph; the graph must outlive it
+     *
+     * @param graph Compiled graph
+     * @param max_speed Upper bound of distance in meters per unit of edge weight: 1 for weights in
+     * meters, the top speed in m/s for weights in seconds
+     * @param heuristic Search kind
+     */
+    PointToPointEngine(const CompiledGraph<Vertex>& graph, double max_speed, PointToPointHeuristic heuristic)
+        : graph_(graph), heuristic_(heuristic), max_speed_(max_speed) {
+        graph.check_direction(SearchDirection::Backward);
+        if (!(max_speed > 0)) {
+            throw std::runtime_error("max_speed must be positive");
+        }
+        if (heuristic == PointToPointHeuristic::GreatCircle && !graph.has_coordinates()) {
+            throw std::runtime_error("Great-circle heuristic needs vertex coordinates");
+        }
+        if (heuristic == PointToPointHeuristic::Landmarks) {
+            throw std::runtime_error("Landmark heuristic needs landmarks");
+        }
+
+        if (heuristic == PointToPointHeuristic::GreatCircle) {
+            points_.reserve(graph.vertices_count());
+            for (Index v = 0; v < graph.vertices_count(); v++) {
+                points_.push_back(geo_utils::unit_vector(graph.x(v), graph.y(v)));
+            }
+        }
+    }
+
+    /**
+     * @brief Engine with the great-circle heuristic when the graph has coordinates
+     */
+    explicit PointToPointEngine(const CompiledGraph<Vertex>& graph, double max_speed = 1.0)
+        : PointToPointEngine(
+              graph,
+              max_speed,
+              graph.has_coordinates() ? PointToPointHeuristic::GreatCircle : PointToPointHeuristic::None
+          ) {}
+
+    /**
+     * @brief Engine with ALT bounds; landmarks must be computed for this graph and outlive the engine
+     */
+    PointToPointEngine(const CompiledGraph<Vertex>& graph, const Landmarks<Vertex>& landmarks)
+        : graph_(graph), heuristic_(PointToPointHeuristic::Landmarks), max_speed_(1), landmarks_(&landmarks) {
+        if (!landmarks.matches(graph)) {
+            throw std::runtime_error("Landmarks were computed for another graph");
+        }
+    }
+
+    PointToPointHeuristic heuristic() const {
+        return heuristic_;
+    }
+
+    /**
+     * @brief Shortest path distance from source to target or kUnreachable
+     */
+    template <typename Stats>
+    float distance(Index source, Index target, PointToPointWorkspace& workspace, Stats& stats) const {
+        if (source == target) {
+            return 0;
+        }
+        if (heuristic_ == PointToPointHeuristic::Landmarks) {
+            one_way_search(source, {target}, SearchDirection::Forward, workspace, stats);
+            return workspace.forward.dist(target);
+        }
+
+        prepare(workspace);
+        stats.on_start();
+        auto& forward = workspace.forward;
+        auto& backward = workspace.backward;
+        float best = kUnreachable;
+
+        // Keys of the backward side subtract the potential, so both sides agree on the metric
+        auto forward_potential = [&](Index v) {
+            return potential(v, source, target, workspace);
+        };
+        auto backward_potential = [&](Index v) {
+            return -potential(v, source, target, workspace);
+        };
+        // Sources never meet: source != target, and the other side is not started yet
+        bool started = false;
+        auto forward_improved = [&](Index v, float dist) {
+            if (started) {
+                best = std::min(best, dist + backward.dist(v));
+            }
+        };
+        auto backward_improved = [&](Index v, float dist) {
+            if (started) {
+                best = std::min(best, dist + forward.dist(v));
+            }
+        };
+        detail::GuidedVisitor<decltype(forward_potential), decltype(forward_improved)> forward_visitor{forward_potential, forward_improved};
+        detail::GuidedVisitor<decltype(backward_potential), decltype(backward_improved)> backward_visitor{backward_potential, backward_improved};
+
+        const std::pair<Index, float> forward_start{source, 0};
+        const std::pair<Index, float> backward_start{target, 0};
+        forward.start(graph_, std::span<const std::pair<Index, float>>(&forward_start, 1), forward_visitor, stats);
+        backward.start(graph_, std::span<const std::pair<Index, float>>(&backward_start, 1), backward_visitor, stats);
+        started = true;
+
+        while (!forward.empty() && !backward.empty()) {
+            // Keys of both sides sum to a lower bound of any path through unsettled vertices
+            if (forward.top_key() + backward.top_key() >= best) {
+                break;
+            }
+
+            if (forward.top_key() <= backward.top_key()) {
+                forward.template step<SearchDirection::Forward>(graph_, forward_visitor, stats);
+            } else {
+                backward.template step<SearchDirection::Backward>(graph_, backward_visitor, stats);
+            }
+        }
+
+        stats.on_finish();
+        return best;
+    }
+
+    float distance(const Vertex& source, const Vertex& target) const {
+        PointToPointWorkspace workspace;
+        NoSearchStats stats;
+        return distance(graph_.index(source), graph_.index(target), workspace, stats);
+    }
+
+    /**
+     * @brief One-to-many distances: a single search from source which stops once all targets
+     * are settled, guided by the minimum of the bounds to the targets for small target sets.
+     * Backward gives many-to-one distances from every target to source.
+     *
+     * @return Distance per target, kUnreachable when there is no path
+     */
+    template <typename Stats>
+    std::vector<float> distances_from(
+        Index source,
+        const std::vector<Index>& targets,
+        PointToPointWorkspace& workspace,
+        Stats& stats,
+        SearchDirection direction = SearchDirection::Forward
+    ) const {
+        one_way_search(source, targets, direction, workspace, stats);
+        std::vector<float> res;
+        res.reserve(targets.size());
+        for (auto target : targets) {
+            res.push_back(workspace.forward.dist(target));
+        }
+        return res;
+    }
+
+    std::vector<float> distances_from(
+        const Vertex& source,
+        const std::vector<Vertex>& targets,
+        SearchDirection direction = SearchDirection::Forward
+    ) const {
+        std::vector<Index> target_indices;
+        target_indices.reserve(targets.size());
+        for (const auto& target : targets) {
+            target_indices.push_back(graph_.index(target));
+        }
+        PointToPointWorkspace workspace;
+        NoSearchStats stats;
+        return distances_from(graph_.index(source), target_indices, workspace, stats, direction);
+    }
+
+    /**
+     * @brief Distances for many (source, target) pairs on the thread pool
+     *
+     * @return Distance per pair, kUnreachable when there is no path
+     */
+    std::vector<float> distances(
+        const std::vector<std::pair<Vertex, Vertex>>& pairs,
+        ThreadPool& pool = ThreadPool::shared()
+    ) const {
+        std::vector<std::pair<Index, Index>> index_pairs;
+        index_pairs.reserve(pairs.size());
+        for (const auto& [source, target] : pairs) {
+            index_pairs.push_back({graph_.index(source), graph_.index(target)});
+        }
+
+        std::vector<float> res(pairs.size());
+        std::vector<PointToPointWorkspace> workspaces(pool.size());
+
+        pool.parallel_for(index_pairs.size(), [this, &index_pairs, &res, &workspaces](size_t pair_idx, int worker_id) {
+            NoSearchStats stats;
+            res[pair_idx] = distance(index_pairs[pair_idx].first, index_pairs[pair_idx].second, workspaces[worker_id], stats);
+        }, 16, "point_to_point");
+
+        return res;
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <compressed_graph.h>
+#include <quantized_weights.h>
+#include <algorithms/parallel.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Dial's bucket queue for integer keys of a Dijkstra search.
+ *
+ * Keys in the queue are in [current, current + buckets), so a cyclic array of buckets indexed
+ * by key modulo its size holds one key per bucket. Push and pop are O(1) plus the scan over
+ * empty buckets, which is bounded by the largest edge weight between two pops. Keys have to be
+ * monotone like in Dijkstra: never below the last popped key. The array starts small and grows
+ * to the largest key span seen, about the largest edge weight. Only the span is bounded, not
+ * the keys: an empty queue starts at the first pushed key, so sources may start far from zero.
+ */
+class DialQueue {
+   public:
+    using Index = std::uint32_t;
+    using Key = std::uint32_t;
+    static constexpr size_t kMaxBuckets = size_t(1) << 24;
+
+    void clear() {
+        if (size_ > 0) {
+            for (auto& bucket : buckets_) {
+                bucket.clear();
+            }
+            size_ = 0;
+        }
+        current_ = 0;
+        top_ = 0;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    void push(Key key, Index v) {
+        if (size_ == 0) {
+            current_ = key;
+            top_ = key;
+        }
+        // Before the first pop sources may come in any order, so a key may be below current
+        Key low = std::min(current_, key);
+        Key high = std::max(top_, key);
+        if (high - low >= buckets_.size()) {
+            grow(high - low + 1);
+        }
+        current_ = low;
+        top_ = high;
+        buckets_[key & mask_].push_back(v);
+        size_++;
+    }
+
+    std::pair<Key, Index> pop() {
+        while (buckets_[current_ & mask_].empty()) {
+            current_++;
+        }
+        auto& bucket = buckets_[current_ & mask_];
+        Index v = bucket.back();
+        bucket.pop_back();
+        size_--;
+        return {current_, v};
+    }
+
+    template <typename Func>
+    void for_each_vertex(Func&& func) const {
+        if (size_ == 0) {
+            return;
+        }
+        for (const auto& bucket : buckets_) {
+            for (auto v : bucket) {
+                func(v);
+            }
+        }
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Caches] += lib::vector_bytes(buckets_);
+        for (const auto& bucket : buckets_) {
+            res[lib::MemoryCategory::Caches] += lib::vector_bytes(bucket);
+        }
+        return res;
+    }
+
+   private:
+    std::vector<std::vector<Index>> buckets_;
+    Key mask_ = 0;
+    Key current_ = 0;
+    // Largest queued key
+    Key top_ = 0;
+    size_t size_ = 0;
+
+    void grow(size_t span) {
+        size_t count = std::bit_ceil(std::max(span, buckets_.size() * 2));
+        if (count > kMaxBuckets) {
+            throw std::runtime_error("Key span " + std::to_string(span) + " is too large for DialQueue, use a coarser quantization unit");
+        }
+
+        // Queued keys are in [current_, current_ + old size), every bucket moves to its key's new slot
+        std::vector<std::vector<Index>> buckets(count);
+        for (Key key = current_; key < current_ + buckets_.size(); key++) {
+            buckets[key & (count - 1)] = std::move(buckets_[key & mask_]);
+        }
+        buckets_ = std::move(buckets);
+        mask_ = count - 1;
+    }
+};
+
+/**
+ * @brief Weight policy of DijkstraSearch reading quantized weights, distances are in their units
+ */
+template <typename Int>
+struct QuantizedWeight {
+    const QuantizedWeights<Int>* weights = nullptr;
+
+    template <typename Vertex>
+    std::uint32_t operator()(const CompiledGraph<Vertex>&, std::uint32_t edge) const {
+        return (*weights)[edge];
+    }
+};
+
+/**
+ * @brief Weight policy of DijkstraSearch for CompressedGraph, edges carry their weight in units
+ */
+struct CompressedWeight {
+    template <typename Vertex>
+    std::uint32_t operator()(const CompressedGraph<Vertex>&, typename CompressedGraph<Vertex>::EdgeRef edge) const {
+        return edge.units;
+    }
+};
+
+/**
+ * @brief Cutoff on distances in weight units for searches on quantized weights;
+ * Units is QuantizedWeights or CompressedGraph, which convert units back to weights
+ */
+template <typename Units, typename Cutoff>
+struct QuantizedCutoffVisitor {
+    const Units& units;
+    Cutoff& cutoff;
+
+    bool accept(std::uint32_t dist) {
+        return cutoff(units.to_weight(dist));
+    }
+};
+
+/**
+ * @brief Dijkstra on quantized weights with integer distances in a bucket queue
+ */
+template <typename Int = std::uint16_t>
+using QuantizedDijkstraSearch = DijkstraSearch<DialQueue, SearchLabels<false, std::uint32_t>, QuantizedWeight<Int>>;
+
+/**
+ * @brief Dijkstra on a CompressedGraph, distances are in its weight units
+ */
+using CompressedDijkstraSearch = DijkstraSearch<DialQueue, SearchLabels<false, std::uint32_t>, CompressedWeight>;
+
+/**
+ * @brief single_source_dijkstra on quantized weights; cutoff sees distances converted back
+ * to weights. Results are in search.settled(), in units of the weights.
+ *
+ * @param search Search created with QuantizedWeight{&weights}
+ */
+template <typename Vertex, typename Int, typename Cutoff, typename Stats>
+void quantized_dijkstra(
+    const CompiledGraph<Vertex>& graph,
+    const QuantizedWeights<Int>& weights,
+    std::uint32_t start,
+    Cutoff&& cutoff,
+    QuantizedDijkstraSearch<Int>& search,
+    Stats& stats,
+    SearchDirection direction = SearchDirection::Forward
+) {
+    if (weights.size() != graph.edges_count()) {
+        throw std::runtime_error("Quantized weights do not match the graph edges count");
+    }
+    QuantizedCutoffVisitor<QuantizedWeights<Int>, std::remove_reference_t<Cutoff>> visitor{weights, cutoff};
+    search.run(graph, start, visitor, stats, direction);
+}
+
+/**
+ * @brief Distances of the last search as vertex -> distance in weights, like single_source_dijkstra returns
+ */
+template <typename Vertex, typename Int>
+std::unordered_map<Vertex, float> quantized_to_map(
+    const CompiledGraph<Vertex>& graph,
+    const QuantizedWeights<Int>& weights,
+    const QuantizedDijkstraSearch<Int>& search
+) {
+    std::unordered_map<Vertex, float> ans;
+    ans.reserve(search.settled().size());
+    for (const auto& [v, units] : search.settled()) {
+        ans.emplace(graph.vertex(v), weights.to_weight(units));
+    }
+    return ans;
+}
+
+template <typename Vertex, typename Int, typename Cutoff>
+std::unordered_map<Vertex, float> quantized_dijkstra(
+    const CompiledGraph<Vertex>& graph,
+    const QuantizedWeights<Int>& weights,
+    const Vertex& start,
+    Cutoff&& cutoff,
+    SearchDirection direction = SearchDirection::Forward
+) {
+    QuantizedDijkstraSearch<Int> search(QuantizedWeight<Int>{&weights});
+    NoSearchStats stats;
+    quantized_dijkstra(graph, weights, graph.index(start), cutoff, search, stats, direction);
+    return quantized_to_map(graph, weights, search);
+}
+
+template <typename Vertex, typename Int, typename Cutoff>
+std::vector<std::unordered_map<Vertex, float>> multi_source_quantized_dijkstra(
+    const CompiledGraph<Vertex>& graph,
+    const QuantizedWeights<Int>& weights,
+    const std::vector<Vertex>& starts_vec,
+    const int n_threads,
+    Cutoff&& cutoff_func,
+    SearchDirection direction = SearchDirection::Forward
+) {
+    // One search per thread, reused by all its queries
+    std::vector<QuantizedDijkstraSearch<Int>> searches(n_threads, QuantizedDijkstraSearch<Int>(QuantizedWeight<Int>{&weights}));
+    graph.check_direction(direction);
+
+    auto task = [&graph, &weights, &cutoff_func, &searches, direction](const Vertex& start, int thread_num) {
+        auto& search = searches[thread_num];
+        NoSearchStats stats;
+        quantized_dijkstra(graph, weights, graph.index(start), cutoff_func, search, stats, direction);
+        return quantized_to_map(graph, weights, search);
+    };
+    return run_in_threads(starts_vec, n_threads, task);
+}
+
+/**
+ * @brief single_source_dijkstra on a CompressedGraph; cutoff sees distances converted back to weights.
+ * Results are in search.settled(), in units of the graph weights.
+ */
+template <typename Vertex, typename Cutoff, typename Stats>
+void compressed_dijkstra(
+    const CompressedGraph<Vertex>& graph,
+    std::uint32_t start,
+    Cutoff&& cutoff,
+    CompressedDijkstraSearch& search,
+    Stats& stats,
+    SearchDirection direction = SearchDirection::Forward
+) {
+    QuantizedCutoffVisitor<CompressedGraph<Vertex>, std::remove_reference_t<Cutoff>> visitor{graph, cutoff};
+    search.run(graph, start, visitor, stats, direction);
+}
+
+template <typename Vertex, typename Cutoff>
+std::unordered_map<Vertex, float> compressed_dijkstra(
+    const CompressedGraph<Vertex>& graph,
+    const Vertex& start,
+    Cutoff&& cutoff,
+    SearchDirection direction = SearchDirection::Forward
+) {
+    CompressedDijkstraSearch search;
+    NoSearchStats stats;
+    compressed_dijkstra(graph, graph.index(start), cutoff, search, stats, direction);
+
+    std::unordered_map<Vertex, float> ans;
+    ans.reserve(search.settled().size());
+    for (const auto& [v, units] : search.settled()) {
+        ans.emplace(graph.vertex(v), graph.to_weight(units));
+    }
+    return ans;
+}
+
+}  // namespace algorithms
+}  // namespace graph
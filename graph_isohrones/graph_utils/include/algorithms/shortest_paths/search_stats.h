@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Work counters and timer of a shortest path search.
+ * Searches take a stats collector as a template parameter; with NoSearchStats
+ * all hooks are empty and the instrumentation compiles to nothing.
+ */
+struct SearchStats {
+    std::uint64_t queries = 0;
+    std::uint64_t settled_nodes = 0;
+    std::uint64_t relaxed_edges = 0;
+    std::uint64_t heap_pushes = 0;
+    std::uint64_t stale_pops = 0;
+    std::uint64_t peak_heap_size = 0;
+    double elapsed_seconds = 0;
+
+    void on_start() {
+        queries++;
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    void on_finish() {
+        elapsed_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+    void on_settle() {
+        settled_nodes++;
+    }
+
+    void on_relax() {
+        relaxed_edges++;
+    }
+
+    void on_push(size_t heap_size) {
+        heap_pushes++;
+        peak_heap_size = std::max<std::uint64_t>(peak_heap_size, heap_size);
+    }
+
+    void on_stale_pop() {
+        stale_pops++;
+    }
+
+    /**
+     * @brief Aggregate stats of several searches: counters add up, peak heap size is the max
+     */
+    SearchStats& operator+=(const SearchStats& other) {
+        queries += other.queries;
+        settled_nodes += other.settled_nodes;
+        relaxed_edges += other.relaxed_edges;
+        heap_pushes += other.heap_pushes;
+        stale_pops += other.stale_pops;
+        peak_heap_size = std::max(peak_heap_size, other.peak_heap_size);
+        elapsed_seconds += other.elapsed_seconds;
+        return *this;
+    }
+
+   private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+struct NoSearchStats {
+    void on_start() {}
+    void on_finish() {}
+    void on_settle() {}
+    void on_relax() {}
+    void on_push(size_t) {}
+    void on_stale_pop() {}
+};
+
+/**
+ * @brief Stats of a batch of searches: one entry per query and one per worker thread
+ */
+struct BatchSearchStats {
+    std::vector<SearchStats> per_query;
+    std::vector<SearchStats> per_thread;
+
+    SearchStats total() const {
+        SearchStats res;
+        for (const auto& stats : per_thread) {
+            res += stats;
+        }
+        return res;
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
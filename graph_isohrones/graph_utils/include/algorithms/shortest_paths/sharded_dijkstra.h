@@ -0,0 +1,553 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <algorithms/graph_partition.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+
+namespace graph {
+namespace algorithms {
+
+// Vertex of the whole graph with a distance, the unit of label exchange between processes
+using VertexLabel = std::pair<std::uint32_t, float>;
+
+struct ShardEdge {
+    std::uint32_t from;
+    std::uint32_t to;
+    float weight;
+};
+
+namespace detail {
+
+enum class ShardMessage : std::uint32_t {
+    Load,
+    Search,
+    Shutdown,
+};
+
+// Blocking transfer of whole buffers over a socket; MSG_NOSIGNAL turns a dead peer into an error
+inline void send_all(int fd, const void* data, size_t bytes) {
+    const auto* pos = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t sent = ::send(fd, pos, bytes, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            throw std::runtime_error("Shard connection closed while sending");
+        }
+        pos += sent;
+        bytes -= sent;
+    }
+}
+
+inline void receive_all(int fd, void* data, size_t bytes) {
+    auto* pos = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t received = ::recv(fd, pos, bytes, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            throw std::runtime_error("Shard connection closed while receiving");
+        }
+        pos += received;
+        bytes -= received;
+    }
+}
+
+template <typename T>
+void send_value(int fd, const T& value) {
+    send_all(fd, &value, sizeof(value));
+}
+
+template <typename T>
+T receive_value(int fd) {
+    T value;
+    receive_all(fd, &value, sizeof(value));
+    return value;
+}
+
+template <typename T>
+void send_vector(int fd, const std::vector<T>& vec) {
+    send_value<std::uint64_t>(fd, vec.size());
+    send_all(fd, vec.data(), vec.size() * sizeof(T));
+}
+
+template <typename T>
+void receive_vector(int fd, std::vector<T>& vec) {
+    vec.resize(receive_value<std::uint64_t>(fd));
+    receive_all(fd, vec.data(), vec.size() * sizeof(T));
+}
+
+// Threads of this process, 0 where the system does not list them
+inline size_t process_threads_count() {
+#ifdef __linux__
+    std::error_code error;
+    size_t count = 0;
+    for (std::filesystem::directory_iterator it("/proc/self/task", error), end; !error && it != end; it.increment(error)) {
+        count++;
+    }
+    return error ? 0 : count;
+#else
+    return 0;
+#endif
+}
+
+}  // namespace detail
+
+/**
+ * @brief One shard of a partitioned graph: its vertices and the edges between them, with vertex
+ * ids of the whole graph. Boundary vertices have edges to or from other shards.
+ */
+class GraphShard {
+   public:
+    using Index = std::uint32_t;
+
+    /**
+     * @param vertices Vertices of the shard
+     * @param edges Edges with both ends in the shard
+     * @param boundary Boundary vertices of the shard
+     */
+    GraphShard(const std::vector<Index>& vertices, const std::vector<ShardEdge>& edges, const std::vector<Index>& boundary) {
+        std::unordered_map<Index, std::unordered_map<Index, float>> weights;
+        weights.reserve(vertices.size());
+        for (auto v : vertices) {
+            weights[v];
+        }
+        for (const auto& edge : edges) {
+            weights[edge.from][edge.to] = edge.weight;
+        }
+        graph_ = CompiledGraph<Index>(Graph<Index>(std::move(weights)));
+
+        is_boundary_.assign(graph_.vertices_count(), false);
+        boundary_.reserve(boundary.size());
+        for (auto v : boundary) {
+            boundary_.push_back(graph_.index(v));
+            is_boundary_[boundary_.back()] = true;
+        }
+    }
+
+    /**
+     * @brief Shortest distances between boundary vertices by paths inside the shard,
+     * the shard's part of the overlay graph
+     */
+    std::vector<ShardEdge> boundary_distances() {
+        std::vector<ShardEdge> res;
+        NoSearchStats stats;
+        struct NoVisitor {} visitor;
+        for (auto from : boundary_) {
+            search_.run(graph_, from, visitor, stats);
+            for (auto to : boundary_) {
+                if (to != from && search_.dist(to) != DijkstraSearch<>::kUnreached) {
+                    res.push_back({graph_.vertex(from), graph_.vertex(to), search_.dist(to)});
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief Search inside the shard from sources with initial distances
+     *
+     * @param sources Shard vertices with their distances
+     * @param max_distance Vertices farther than it are not labeled
+     * @param boundary_only Return labels of boundary vertices only
+     */
+    std::vector<VertexLabel> search(const std::vector<VertexLabel>& sources, float max_distance, bool boundary_only) {
+        std::vector<std::pair<Index, float>> local_sources;
+        local_sources.reserve(sources.size());
+        for (const auto& [v, dist] : sources) {
+            local_sources.push_back({graph_.index(v), dist});
+        }
+
+        auto cutoff = [max_distance](float dist) { return dist <= max_distance; };
+        CutoffVisitor<decltype(cutoff)> visitor{cutoff};
+        NoSearchStats stats;
+        search_.run(graph_, std::span<const std::pair<Index, float>>(local_sources), visitor, stats);
+
+        std::vector<VertexLabel> res;
+        for (const auto& [v, dist] : search_.settled()) {
+            if (!boundary_only || is_boundary_[v]) {
+                res.push_back({graph_.vertex(v), dist});
+            }
+        }
+        return res;
+    }
+
+   private:
+    CompiledGraph<Index> graph_;
+    std::vector<Index> boundary_;
+    std::vector<bool> is_boundary_;
+    DijkstraSearch<> search_;
+};
+
+/**
+ * @brief Serve requests of a ShardedDijkstra coordinator on a connected socket until shutdown;
+ * the loop of a shard worker process
+ */
+inline void serve_shard(int fd) {
+    std::unique_ptr<GraphShard> shard;
+    std::vector<GraphShard::Index> vertices, boundary;
+    std::vector<ShardEdge> edges;
+    std::vector<VertexLabel> sources;
+
+    while (true) {
+        auto message = detail::receive_value<detail::ShardMessage>(fd);
+        if (message == detail::ShardMessage::Shutdown) {
+            return;
+        }
+        if (message == detail::ShardMessage::Load) {
+            detail::receive_vector(fd, vertices);
+            detail::receive_vector(fd, edges);
+            detail::receive_vector(fd, boundary);
+            shard = std::make_unique<GraphShard>(vertices, edges, boundary);
+            vertices = {};
+            edges = {};
+            detail::send_vector(fd, shard->boundary_distances());
+        } else {
+            auto boundary_only = detail::receive_value<std::uint8_t>(fd);
+            auto max_distance = detail::receive_value<float>(fd);
+            detail::receive_vector(fd, sources);
+            detail::send_vector(fd, shard->search(sources, max_distance, boundary_only));
+        }
+    }
+}
+
+/**
+ * @brief Worker processes waiting for the shards of a ShardedDijkstra.
+ *
+ * Workers are forked in the constructor and keep a copy-on-write image of the process as it is
+ * at that moment, so create them at startup before loading the graph: every worker then holds
+ * only the shard it is sent later. fork copies only the calling thread, so the constructor
+ * throws if the process already runs other threads, e.g. ThreadPool::shared().
+ */
+class ShardWorkers {
+   public:
+    explicit ShardWorkers(size_t count) {
+        if (count == 0) {
+            throw std::runtime_error("Shard workers count must be positive");
+        }
+        if (detail::process_threads_count() > 1) {
+            throw std::runtime_error("Shard workers must be started before other threads of the process");
+        }
+        try {
+            for (size_t worker = 0; worker < count; worker++) {
+                start_worker();
+            }
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ShardWorkers(ShardWorkers&& other) noexcept
+        : fds_(std::move(other.fds_)), pids_(std::move(other.pids_)) {
+        other.fds_.clear();
+        other.pids_.clear();
+    }
+
+    ShardWorkers(const ShardWorkers&) = delete;
+    ShardWorkers& operator=(const ShardWorkers&) = delete;
+    ShardWorkers& operator=(ShardWorkers&&) = delete;
+
+    ~ShardWorkers() {
+        stop();
+    }
+
+    size_t size() const {
+        return fds_.size();
+    }
+
+    /**
+     * @brief Coordinator end of the socket of the worker
+     */
+    int fd(size_t worker) const {
+        return fds_[worker];
+    }
+
+   private:
+    std::vector<int> fds_;
+    std::vector<pid_t> pids_;
+
+    void start_worker() {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            throw std::runtime_error("Can not create shard worker socket");
+        }
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            throw std::runtime_error("Can not start shard worker process");
+        }
+        if (pid == 0) {
+            // Sockets of the other workers stay with the coordinator, so workers see its exit
+            for (int fd : fds_) {
+                ::close(fd);
+            }
+            ::close(fds[0]);
+            int status = 0;
+            try {
+                serve_shard(fds[1]);
+            } catch (...) {
+                status = 1;
+            }
+            ::_exit(status);
+        }
+        ::close(fds[1]);
+        fds_.push_back(fds[0]);
+        pids_.push_back(pid);
+    }
+
+    void stop() {
+        for (int fd : fds_) {
+            try {
+                detail::send_value(fd, detail::ShardMessage::Shutdown);
+            } catch (const std::runtime_error&) {
+                // The worker is gone already
+            }
+            ::close(fd);
+        }
+        for (pid_t pid : pids_) {
+            ::waitpid(pid, nullptr, 0);
+        }
+        fds_.clear();
+        pids_.clear();
+    }
+};
+
+/**
+ * @brief Single source Dijkstra on a graph split into shards held by worker processes.
+ *
+ * Every worker process owns one shard and computes the distances between its boundary vertices
+ * at startup. The coordinator keeps only the shard of every vertex and the overlay graph: boundary
+ * vertices with those distances and the edges between shards. A query runs in three steps:
+ * the shard of the start labels its boundary vertices, the coordinator searches the overlay from
+ * these labels, then every shard searches from its boundary labels (and the start) in parallel.
+ * A shortest path leaves and enters shards at boundary vertices only, so distances are exact.
+ *
+ * Workers are ShardWorkers processes started before the graph was loaded; they talk to the
+ * coordinator over Unix sockets. Shards are sent to the workers, the whole graph can be freed
+ * after construction. Queries are serialized: concurrent calls wait for each other.
+ */
+class ShardedDijkstra {
+   public:
+    using Index = std::uint32_t;
+
+    /**
+     * @param graph Compiled graph
+     * @param partition Shard of every vertex, e.g. geometric_partition(graph, shards)
+     * @param workers One worker per shard, started before the graph was loaded
+     */
+    template <typename Vertex>
+    ShardedDijkstra(const CompiledGraph<Vertex>& graph, const GraphPartition& partition, ShardWorkers workers)
+        : shard_of_(partition.shard_of), workers_(std::move(workers)), pending_(workers_.size(), 0) {
+        const size_t shards = partition.count();
+        if (shard_of_.size() != graph.vertices_count()) {
+            throw std::runtime_error("Partition does not match the graph vertices count");
+        }
+        if (workers_.size() != shards) {
+            throw std::runtime_error("Got " + std::to_string(workers_.size()) + " shard workers for " + std::to_string(shards) + " shards");
+        }
+
+        std::vector<std::vector<Index>> vertices(shards), boundary(shards);
+        std::vector<std::vector<ShardEdge>> edges(shards);
+        std::vector<bool> is_boundary(graph.vertices_count(), false);
+        std::unordered_map<Index, std::unordered_map<Index, float>> overlay;
+
+        for (Index v = 0; v < graph.vertices_count(); v++) {
+            vertices[shard_of_[v]].push_back(v);
+            for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+                Index u = graph.target(edge);
+                if (shard_of_[u] == shard_of_[v]) {
+                    edges[shard_of_[v]].push_back({v, u, graph.weight(edge)});
+                } else {
+                    is_boundary[v] = true;
+                    is_boundary[u] = true;
+                    add_overlay_edge(overlay, {v, u, graph.weight(edge)});
+                }
+            }
+        }
+        for (Index v = 0; v < graph.vertices_count(); v++) {
+            if (is_boundary[v]) {
+                boundary[shard_of_[v]].push_back(v);
+                overlay[v];
+            }
+        }
+
+        // Workers stopped by the destructor of workers_ if anything throws
+        for (size_t shard = 0; shard < shards; shard++) {
+            int fd = workers_.fd(shard);
+            detail::send_value(fd, detail::ShardMessage::Load);
+            detail::send_vector(fd, vertices[shard]);
+            detail::send_vector(fd, edges[shard]);
+            detail::send_vector(fd, boundary[shard]);
+            edges[shard] = {};
+            vertices[shard] = {};
+        }
+        // Workers compute their boundary distances in parallel
+        std::vector<ShardEdge> boundary_distances;
+        for (size_t shard = 0; shard < shards; shard++) {
+            detail::receive_vector(workers_.fd(shard), boundary_distances);
+            for (const auto& edge : boundary_distances) {
+                add_overlay_edge(overlay, edge);
+            }
+        }
+        overlay_ = CompiledGraph<Index>(Graph<Index>(std::move(overlay)));
+    }
+
+    ShardedDijkstra(const ShardedDijkstra&) = delete;
+    ShardedDijkstra& operator=(const ShardedDijkstra&) = delete;
+
+    size_t shards_count() const {
+        return workers_.size();
+    }
+
+    /**
+     * @brief Overlay graph of boundary vertices; vertex ids are vertex indices of the whole graph
+     */
+    const CompiledGraph<Index>& overlay() const {
+        return overlay_;
+    }
+
+    /**
+     * @brief Distances from start up to max_distance, like single_source_dijkstra on the whole graph
+     *
+     * @param start Vertex index in the whole graph
+     * @param max_distance Vertices farther than it are left out
+     * @return Reached vertex indices of the whole graph with distances, grouped by shard
+     */
+    std::vector<VertexLabel> single_source_dijkstra(Index start, float max_distance) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (broken_) {
+            throw std::runtime_error("Connection to a shard worker is lost");
+        }
+        try {
+            return search(start, max_distance);
+        } catch (...) {
+            // Replies of an interrupted query would be read by the next one
+            drain();
+            throw;
+        }
+    }
+
+   private:
+    std::vector<Index> shard_of_;
+    CompiledGraph<Index> overlay_;
+    DijkstraSearch<> overlay_search_;
+    ShardWorkers workers_;
+    // Replies every worker still owes, and whether a connection is out of sync
+    std::vector<std::uint32_t> pending_;
+    bool broken_ = false;
+    std::mutex mutex_;
+
+    static void add_overlay_edge(std::unordered_map<Index, std::unordered_map<Index, float>>& overlay, const ShardEdge& edge) {
+        auto [it, inserted] = overlay[edge.from].emplace(edge.to, edge.weight);
+        if (!inserted) {
+            it->second = std::min(it->second, edge.weight);
+        }
+    }
+
+    std::vector<VertexLabel> search(Index start, float max_distance) {
+        Index start_shard = shard_of_.at(start);
+        std::vector<VertexLabel> sources = {{start, 0}};
+        request(start_shard, sources, max_distance, true);
+        std::vector<VertexLabel> start_labels;
+        receive(start_shard, start_labels);
+
+        // Boundary distances through the overlay, grouped into the sources of every shard
+        std::vector<std::vector<VertexLabel>> shard_sources(shards_count());
+        shard_sources[start_shard].push_back({start, 0});
+        if (!start_labels.empty()) {
+            std::vector<std::pair<Index, float>> overlay_sources;
+            for (const auto& [v, dist] : start_labels) {
+                overlay_sources.push_back({overlay_.index(v), dist});
+            }
+            auto cutoff = [max_distance](float dist) { return dist <= max_distance; };
+            CutoffVisitor<decltype(cutoff)> visitor{cutoff};
+            NoSearchStats stats;
+            overlay_search_.run(overlay_, std::span<const std::pair<Index, float>>(overlay_sources), visitor, stats);
+            for (const auto& [v, dist] : overlay_search_.settled()) {
+                Index vertex = overlay_.vertex(v);
+                shard_sources[shard_of_[vertex]].push_back({vertex, dist});
+            }
+        }
+
+        // Shards finish the search in parallel
+        for (Index shard = 0; shard < shards_count(); shard++) {
+            if (!shard_sources[shard].empty()) {
+                request(shard, shard_sources[shard], max_distance, false);
+            }
+        }
+        std::vector<VertexLabel> res, shard_res;
+        for (Index shard = 0; shard < shards_count(); shard++) {
+            if (!shard_sources[shard].empty()) {
+                receive(shard, shard_res);
+                res.insert(res.end(), shard_res.begin(), shard_res.end());
+            }
+        }
+        return res;
+    }
+
+    void request(Index shard, const std::vector<VertexLabel>& sources, float max_distance, bool boundary_only) {
+        int fd = workers_.fd(shard);
+        try {
+            detail::send_value(fd, detail::ShardMessage::Search);
+            detail::send_value<std::uint8_t>(fd, boundary_only);
+            detail::send_value(fd, max_distance);
+            detail::send_vector(fd, sources);
+        } catch (...) {
+            // A partly sent request can not be completed
+            broken_ = true;
+            throw;
+        }
+        pending_[shard]++;
+    }
+
+    void receive(Index shard, std::vector<VertexLabel>& labels) {
+        try {
+            detail::receive_vector(workers_.fd(shard), labels);
+        } catch (...) {
+            broken_ = true;
+            throw;
+        }
+        pending_[shard]--;
+    }
+
+    // Read and drop the replies left by an interrupted query
+    void drain() noexcept {
+        std::vector<VertexLabel> labels;
+        for (Index shard = 0; shard < shards_count() && !broken_; shard++) {
+            while (pending_[shard] > 0) {
+                try {
+                    receive(shard, labels);
+                } catch (...) {
+                    break;
+                }
+            }
+        }
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <algorithms/bbox_tree.h>
+#include <algorithms/light_polygon.h>
+#include <algorithms/prepared_polygon.h>
+#include <algorithms/thread_pool.h>
+#include <geo_utils/geohash.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Matching (point, polygon) pairs in columnar form, sorted by point and polygon id
+ */
+struct SpatialJoinResult {
+    std::vector<std::int64_t> point_ids;
+    std::vector<std::int64_t> polygon_ids;
+};
+
+/**
+ * @brief Collection of prepared polygons indexed by an STR bbox tree for point-to-polygon joins.
+ *
+ * Points are processed in batches of consecutive ids on the thread pool. Inside a batch points are
+ * visited in Hilbert order of their coordinates, so consecutive queries hit the same tree nodes and
+ * polygon edges while they are still in cache.
+ */
+class PolygonIndex {
+    std::vector<PreparedMultiPolygon> polygons_;
+    BBoxTree tree_;
+
+    void build_tree() {
+        std::vector<BoundingBox> boxes;
+        boxes.reserve(polygons_.size());
+
+        for (const auto& polygon : polygons_) {
+            boxes.push_back(polygon.bbox);
+        }
+        tree_ = BBoxTree(boxes);
+    }
+
+    /**
+     * @brief Order of batch points along the hilbert curve over the batch bounding box
+     */
+    static std::vector<std::uint32_t> hilbert_order(const double* lon, const double* lat, size_t count) {
+        constexpr std::uint64_t dim = 1ull << 16;
+        double min_x = std::numeric_limits<double>::max();
+        double max_x = std::numeric_limits<double>::lowest();
+        double min_y = std::numeric_limits<double>::max();
+        double max_y = std::numeric_limits<double>::lowest();
+
+        for (size_t i = 0; i < count; i++) {
+            if (std::isfinite(lon[i]) && std::isfinite(lat[i])) {
+                min_x = std::min(min_x, lon[i]);
+                max_x = std::max(max_x, lon[i]);
+                min_y = std::min(min_y, lat[i]);
+                max_y = std::max(max_y, lat[i]);
+            }
+        }
+
+        double scale_x = max_x > min_x ? (dim - 1) / (max_x - min_x) : 0;
+        double scale_y = max_y > min_y ? (dim - 1) / (max_y - min_y) : 0;
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> keys(count);
+
+        for (size_t i = 0; i < count; i++) {
+            std::uint64_t key = 0;
+            if (std::isfinite(lon[i]) && std::isfinite(lat[i])) {
+                auto x = static_cast<std::uint64_t>((lon[i] - min_x) * scale_x);
+                auto y = static_cast<std::uint64_t>((lat[i] - min_y) * scale_y);
+                key = geo_utils::geohash::xy2hash(x, y, dim);
+            }
+            keys[i] = {key, static_cast<std::uint32_t>(i)};
+        }
+
+        std::sort(keys.begin(), keys.end());
+        std::vector<std::uint32_t> order(count);
+
+        for (size_t i = 0; i < count; i++) {
+            order[i] = keys[i].second;
+        }
+
+        return order;
+    }
+
+    static void check_sizes(const std::vector<double>& lon_vec, const std::vector<double>& lat_vec) {
+        if (lon_vec.size() != lat_vec.size()) {
+            throw std::runtime_error("lon_vec and lat_vec must have equal sizes");
+        }
+    }
+
+    /**
+     * @brief Run visit(point_id, polygon_id) for all matches, batch by batch on the pool
+     *
+     * @param on_batch Called with (batch_idx, first point id, points count, visitor) per batch
+     */
+    template <typename OnBatch>
+    void for_each_batch(const double* lon, const double* lat, size_t count, ThreadPool& pool, size_t batch_size, OnBatch&& on_batch) const {
+        if (batch_size == 0) {
+            throw std::runtime_error("batch_size must be positive");
+        }
+
+        size_t batches_count = (count + batch_size - 1) / batch_size;
+
+        pool.parallel_for(batches_count, [&](size_t batch_idx, int worker_id) {
+            size_t begin = batch_idx * batch_size;
+            size_t batch_count = std::min(count, begin + batch_size) - begin;
+            auto order = hilbert_order(lon + begin, lat + begin, batch_count);
+
+            on_batch(batch_idx, begin, batch_count, [&](auto&& visit) {
+                for (auto local_idx : order) {
+                    Point2d point{lon[begin + local_idx], lat[begin + local_idx]};
+
+                    tree_.query(point, [&](std::uint32_t polygon_idx) {
+                        if (polygons_[polygon_idx].contains(point)) {
+                            visit(begin + local_idx, polygon_idx);
+                        }
+                        return false;
+                    });
+                }
+            });
+        });
+    }
+
+   public:
+    static constexpr size_t kDefaultBatchSize = 1 << 14;
+
+    PolygonIndex() = default;
+
+    explicit PolygonIndex(std::vector<PreparedMultiPolygon> polygons)
+        : polygons_(std::move(polygons)) {
+        build_tree();
+    }
+
+    explicit PolygonIndex(const std::vector<LightMultiPolygon>& polygons, ThreadPool& pool = ThreadPool::shared())
+        : polygons_(polygons.size()) {
+        pool.parallel_for(polygons.size(), [this, &polygons](size_t polygon_idx, int worker_id) {
+            polygons_[polygon_idx] = PreparedMultiPolygon(polygons[polygon_idx]);
+        });
+        build_tree();
+    }
+
+    explicit PolygonIndex(const std::vector<const Geometry*>& geos_geometries, ThreadPool& pool = ThreadPool::shared())
+        : polygons_(geos_geometries.size()) {
+        pool.parallel_for(geos_geometries.size(), [this, &geos_geometries](size_t polygon_idx, int worker_id) {
+            polygons_[polygon_idx] = PreparedMultiPolygon(geos_geometries[polygon_idx]);
+        });
+        build_tree();
+    }
+
+    size_t size() const {
+        return polygons_.size();
+    }
+
+    const PreparedMultiPolygon& polygon(size_t polygon_idx) const {
+        return polygons_.at(polygon_idx);
+    }
+
+    /**
+     * @brief All (point, polygon) pairs where the polygon contains the point
+     *
+     * @param lon Longitudes of points
+     * @param lat Latitudes of points
+     * @param count Number of points
+     * @param pool Thread pool to run batches on
+     * @param batch_size Number of points in one batch
+     * @return Matches sorted by point id, then by polygon id
+     */
+    SpatialJoinResult join(
+        const double* lon,
+        const double* lat,
+        size_t count,
+        ThreadPool& pool = ThreadPool::shared(),
+        size_t batch_size = kDefaultBatchSize
+    ) const {
+        std::vector<std::vector<std::pair<std::int64_t, std::int64_t>>> batch_matches((count + batch_size - 1) / std::max<size_t>(batch_size, 1));
+
+        for_each_batch(lon, lat, count, pool, batch_size, [&batch_matches](size_t batch_idx, size_t begin, size_t batch_count, auto&& run) {
+            auto& matches = batch_matches[batch_idx];
+            run([&matches](size_t point_idx, std::uint32_t polygon_idx) {
+                matches.push_back({point_idx, polygon_idx});
+            });
+            std::sort(matches.begin(), matches.end());
+        });
+
+        SpatialJoinResult res;
+        size_t matches_count = 0;
+        for (const auto& matches : batch_matches) {
+            matches_count += matches.size();
+        }
+        res.point_ids.reserve(matches_count);
+        res.polygon_ids.reserve(matches_count);
+
+        // Batches are consecutive point ranges, so concatenation keeps the order
+        for (const auto& matches : batch_matches) {
+            for (const auto& match : matches) {
+                res.point_ids.push_back(match.first);
+                res.polygon_ids.push_back(match.second);
+            }
+        }
+
+        return res;
+    }
+
+    SpatialJoinResult join(
+        const std::vector<double>& lon_vec,
+        const std::vector<double>& lat_vec,
+        ThreadPool& pool = ThreadPool::shared(),
+        size_t batch_size = kDefaultBatchSize
+    ) const {
+        check_sizes(lon_vec, lat_vec);
+        return join(lon_vec.data(), lat_vec.data(), lon_vec.size(), pool, batch_size);
+    }
+
+    /**
+     * @brief Polygon id for every point: the smallest id of polygons containing it or -1
+     *
+     * @param lon Longitudes of points
+     * @param lat Latitudes of points
+     * @param count Number of points
+     * @param res Output buffer of count ids
+     * @param pool Thread pool to run batches on
+     * @param batch_size Number of points in one batch
+     */
+    void assign(
+        const double* lon,
+        const double* lat,
+        size_t count,
+        std::int64_t* res,
+        ThreadPool& pool = ThreadPool::shared(),
+        size_t batch_size = kDefaultBatchSize
+    ) const {
+        std::fill(res, res + count, -1);
+
+        for_each_batch(lon, lat, count, pool, batch_size, [res](size_t batch_idx, size_t begin, size_t batch_count, auto&& run) {
+            run([res](size_t point_idx, std::uint32_t polygon_idx) {
+                if (res[point_idx] < 0 || polygon_idx < res[point_idx]) {
+                    res[point_idx] = polygon_idx;
+                }
+            });
+        });
+    }
+
+    std::vector<std::int64_t> assign(
+        const std::vector<double>& lon_vec,
+        const std::vector<double>& lat_vec,
+        ThreadPool& pool = ThreadPool::shared(),
+        size_t batch_size = kDefaultBatchSize
+    ) const {
+        check_sizes(lon_vec, lat_vec);
+        std::vector<std::int64_t> res(lon_vec.size());
+        assign(lon_vec.data(), lat_vec.data(), lon_vec.size(), res.data(), pool, batch_size);
+        return res;
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
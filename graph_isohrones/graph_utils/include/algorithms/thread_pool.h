@@ -0,0 +1,396 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithms/thread_pool_telemetry.h>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Fixed size pool of worker threads with per-worker queues and work stealing.
+ *
+ * Workers take jobs from the front of their own queue and steal from the back of
+ * the others when it is empty. A job posted from inside a worker of the same pool
+ * runs inline, so nested parallel_for never deadlocks.
+ *
+ * Every worker counts its tasks, steals, busy time and the time tasks waited in queues,
+ * see telemetry(). Per task events for a Chrome trace are recorded between
+ * start_trace() and stop_trace().
+ */
+class ThreadPool {
+    using Job = std::function<void(int)>;
+    using Clock = std::chrono::steady_clock;
+
+    struct QueuedJob {
+        Job job;
+        // Runs after the job is accounted, so waiters see complete telemetry
+        std::function<void()> done;
+        const char* name;
+        Clock::time_point posted;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    // Written only by the owning worker, atomics make snapshots from other threads safe
+    struct alignas(64) WorkerStats {
+        std::atomic<std::uint64_t> tasks{0};
+        std::atomic<std::uint64_t> steals{0};
+        std::atomic<std::int64_t> busy_ns{0};
+        std::atomic<std::int64_t> longest_task_ns{0};
+        std::atomic<std::int64_t> queue_wait_ns{0};
+        std::atomic<std::int64_t> max_queue_wait_ns{0};
+        std::mutex trace_mutex;
+        std::vector<TraceEvent> trace;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::unique_ptr<WorkerStats>> stats_;
+    std::vector<std::thread> workers_;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> next_queue_{0};
+    bool stop_ = false;
+    std::atomic<std::int64_t> telemetry_start_ns_{0};
+    std::atomic<bool> tracing_{false};
+    Clock::time_point trace_start_;
+
+    static ThreadPool*& current_pool() {
+        thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    static int& current_worker() {
+        thread_local int worker_id = -1;
+        return worker_id;
+    }
+
+    static std::int64_t to_ns(Clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
+    static void add(std::atomic<std::int64_t>& counter, std::int64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static void update_max(std::atomic<std::int64_t>& counter, std::int64_t value) {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_pop(int worker_id, QueuedJob& job, bool& stolen) {
+        {
+            WorkerQueue& own = *queues_[worker_id];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.jobs.empty()) {
+                job = std::move(own.jobs.front());
+                own.jobs.pop_front();
+                stolen = false;
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < queues_.size(); i++) {
+            WorkerQueue& victim = *queues_[(worker_id + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.back());
+                victim.jobs.pop_back();
+                stolen = true;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void run_job(int worker_id, QueuedJob& queued, bool stolen) {
+        WorkerStats& stats = *stats_[worker_id];
+        Clock::time_point start = Clock::now();
+        queued.job(worker_id);
+        Clock::time_point finish = Clock::now();
+
+        std::int64_t duration_ns = to_ns(finish - start);
+        std::int64_t wait_ns = to_ns(start - queued.posted);
+        stats.tasks.store(stats.tasks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        stats.steals.store(stats.steals.load(std::memory_order_relaxed) + stolen, std::memory_order_relaxed);
+        add(stats.busy_ns, duration_ns);
+        update_max(stats.longest_task_ns, duration_ns);
+        add(stats.queue_wait_ns, wait_ns);
+        update_max(stats.max_queue_wait_ns, wait_ns);
+
+        if (tracing_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(stats.trace_mutex);
+            stats.trace.push_back(TraceEvent{
+                worker_id,
+                queued.name,
+                to_ns(start - trace_start_) / 1000,
+                std::max<std::int64_t>(duration_ns / 1000, 1)
+            });
+        }
+
+        if (queued.done) {
+            queued.done();
+        }
+    }
+
+    void enqueue(Job job, std::function<void()> done, const char* name) {
+        size_t queue_idx = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(queues_[queue_idx]->mutex);
+            queues_[queue_idx]->jobs.push_back(QueuedJob{std::move(job), std::move(done), name, Clock::now()});
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            pending_.fetch_add(1, std::memory_order_relaxed);
+        }
+        sleep_cv_.notify_one();
+    }
+
+    void worker_loop(int worker_id) {
+        current_pool() = this;
+        current_worker() = worker_id;
+
+        while (true) {
+            QueuedJob job;
+            bool stolen = false;
+
+            if (try_pop(worker_id, job, stolen)) {
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                run_job(worker_id, job, stolen);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this] { return stop_ || pending_.load(std::memory_order_relaxed) > 0; });
+
+            if (stop_ && pending_.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+        }
+    }
+
+   public:
+    explicit ThreadPool(int n_threads) {
+        if (n_threads < 1) {
+            throw std::runtime_error("Thread pool needs at least one thread: " + std::to_string(n_threads));
+        }
+
+        telemetry_start_ns_ = to_ns(Clock::now().time_since_epoch());
+
+        for (int worker_id = 0; worker_id < n_threads; worker_id++) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+            stats_.push_back(std::make_unique<WorkerStats>());
+        }
+
+        for (int worker_id = 0; worker_id < n_threads; worker_id++) {
+            workers_.emplace_back([this, worker_id] { worker_loop(worker_id); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Pool shared by all algorithms, one worker per hardware thread
+     */
+    static ThreadPool& shared() {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    int size() const {
+        return workers_.size();
+    }
+
+    /**
+     * @brief Id of the calling worker of this pool or -1 for outside threads
+     */
+    int worker_id() const {
+        return current_pool() == this ? current_worker() : -1;
+    }
+
+    /**
+     * @brief Post a job; it gets the id of the worker which runs it
+     *
+     * @param job Callable (int worker_id)
+     * @param name Static string naming the job in traces
+     */
+    void post(Job job, const char* name = "job") {
+        if (current_pool() == this) {
+            job(current_worker());
+            return;
+        }
+
+        enqueue(std::move(job), nullptr, name);
+    }
+
+    /**
+     * @brief Run task(idx, worker_id) for every idx in [0, count) and wait for all of them.
+     * Indices are grouped into chunks of grain indices; the first exception is rethrown.
+     *
+     * @param count Number of indices
+     * @param task Callable (size_t idx, int worker_id)
+     * @param grain Number of consecutive indices in one job
+     * @param name Static string naming the jobs in traces
+     */
+    template <typename Task>
+    void parallel_for(size_t count, Task&& task, size_t grain = 1, const char* name = "parallel_for") {
+        if (count == 0) {
+            return;
+        }
+
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks_count = (count + grain - 1) / grain;
+
+        if (current_pool() == this) {
+            for (size_t idx = 0; idx < count; idx++) {
+                task(idx, current_worker());
+            }
+            return;
+        }
+
+        std::mutex done_mutex;
+        std::condition_variable done_cv;
+        size_t remaining = chunks_count;
+        std::exception_ptr error;
+
+        auto chunk_done = [&done_mutex, &done_cv, &remaining] {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (--remaining == 0) {
+                done_cv.notify_one();
+            }
+        };
+
+        for (size_t chunk = 0; chunk < chunks_count; chunk++) {
+            enqueue([&, chunk](int worker_id) {
+                size_t begin = chunk * grain;
+                size_t end = std::min(count, begin + grain);
+
+                try {
+                    for (size_t idx = begin; idx < end; idx++) {
+                        task(idx, worker_id);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(done_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }, chunk_done, name);
+        }
+
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_cv.wait(lock, [&remaining] { return remaining == 0; });
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Per-worker load since the pool start or the last reset_telemetry().
+     * Jobs run inline by nested calls are accounted to the job which made the call.
+     * Idle time is the wall time not spent in jobs, including looking for work.
+     */
+    PoolTelemetry telemetry() const {
+        PoolTelemetry res;
+        std::int64_t now_ns = to_ns(Clock::now().time_since_epoch());
+        res.wall_seconds = (now_ns - telemetry_start_ns_.load(std::memory_order_relaxed)) * 1e-9;
+        res.workers.reserve(stats_.size());
+
+        for (const auto& stats : stats_) {
+            WorkerTelemetry worker;
+            worker.tasks = stats->tasks.load(std::memory_order_relaxed);
+            worker.steals = stats->steals.load(std::memory_order_relaxed);
+            worker.busy_seconds = stats->busy_ns.load(std::memory_order_relaxed) * 1e-9;
+            worker.idle_seconds = std::max(0.0, res.wall_seconds - worker.busy_seconds);
+            worker.longest_task_seconds = stats->longest_task_ns.load(std::memory_order_relaxed) * 1e-9;
+            worker.queue_wait_seconds = stats->queue_wait_ns.load(std::memory_order_relaxed) * 1e-9;
+            worker.max_queue_wait_seconds = stats->max_queue_wait_ns.load(std::memory_order_relaxed) * 1e-9;
+            res.workers.push_back(worker);
+        }
+
+        return res;
+    }
+
+    /**
+     * @brief Zero all counters; call it while the pool is idle to get exact numbers
+     */
+    void reset_telemetry() {
+        for (auto& stats : stats_) {
+            stats->tasks = 0;
+            stats->steals = 0;
+            stats->busy_ns = 0;
+            stats->longest_task_ns = 0;
+            stats->queue_wait_ns = 0;
+            stats->max_queue_wait_ns = 0;
+        }
+        telemetry_start_ns_ = to_ns(Clock::now().time_since_epoch());
+    }
+
+    /**
+     * @brief Start recording an event per job, dropping events of a previous trace.
+     * Must not be called while another thread is tracing the same pool.
+     */
+    void start_trace() {
+        for (auto& stats : stats_) {
+            std::lock_guard<std::mutex> lock(stats->trace_mutex);
+            stats->trace.clear();
+        }
+        trace_start_ = Clock::now();
+        tracing_.store(true);
+    }
+
+    /**
+     * @brief Stop recording and return events of all workers sorted by start time
+     */
+    std::vector<TraceEvent> stop_trace() {
+        tracing_.store(false);
+        std::vector<TraceEvent> res;
+
+        for (auto& stats : stats_) {
+            std::lock_guard<std::mutex> lock(stats->trace_mutex);
+            res.insert(res.end(), stats->trace.begin(), stats->trace.end());
+            stats->trace.clear();
+        }
+
+        std::sort(res.begin(), res.end(), [](const TraceEvent& lhs, const TraceEvent& rhs) {
+            return lhs.start_us < rhs.start_us || (lhs.start_us == rhs.start_us && lhs.worker_id < rhs.worker_id);
+        });
+        return res;
+    }
+};
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace graph {
+namespace algorithms {
+
+/**
+ * @brief Load counters of a single pool worker
+ */
+struct WorkerTelemetry {
+    std::uint64_t tasks = 0;
+    std::uint64_t steals = 0;
+    double busy_seconds = 0;
+    double idle_seconds = 0;
+    double longest_task_seconds = 0;
+    // Time between posting a task and a worker starting it, summed over tasks
+    double queue_wait_seconds = 0;
+    double max_queue_wait_seconds = 0;
+
+    WorkerTelemetry& operator+=(const WorkerTelemetry& other) {
+        tasks += other.tasks;
+        steals += other.steals;
+        busy_seconds += other.busy_seconds;
+        idle_seconds += other.idle_seconds;
+        longest_task_seconds = std::max(longest_task_seconds, other.longest_task_seconds);
+        queue_wait_seconds += other.queue_wait_seconds;
+        max_queue_wait_seconds = std::max(max_queue_wait_seconds, other.max_queue_wait_seconds);
+        return *this;
+    }
+};
+
+/**
+ * @brief Snapshot of pool load since its start or the last telemetry reset
+ */
+struct PoolTelemetry {
+    double wall_seconds = 0;
+    std::vector<WorkerTelemetry> workers;
+
+    WorkerTelemetry total() const {
+        WorkerTelemetry res;
+        for (const auto& worker : workers) {
+            res += worker;
+        }
+        return res;
+    }
+
+    /**
+     * @brief Share of worker time spent running tasks
+     */
+    double utilization() const {
+        if (workers.empty() || wall_seconds <= 0) {
+            return 0;
+        }
+        return total().busy_seconds / (wall_seconds * workers.size());
+    }
+
+    /**
+     * @brief Busy time of the most loaded worker over the mean one; 1 is perfect balance
+     */
+    double imbalance() const {
+        double busy_sum = 0;
+        double busy_max = 0;
+        for (const auto& worker : workers) {
+            busy_sum += worker.busy_seconds;
+            busy_max = std::max(busy_max, worker.busy_seconds);
+        }
+        return busy_sum > 0 ? busy_max * workers.size() / busy_sum : 1;
+    }
+};
+
+/**
+ * @brief Task run by a worker; times are microseconds since the trace start
+ */
+struct TraceEvent {
+    int worker_id;
+    const char* name;
+    std::int64_t start_us;
+    std::int64_t duration_us;
+};
+
+/**
+ * @brief Write events in the Chrome trace event format (chrome://tracing, Perfetto).
+ * Every worker becomes a thread track, every task a complete ("X") event.
+ */
+inline void write_chrome_trace(std::ostream& out, const std::vector<TraceEvent>& events) {
+    out << "{\"traceEvents\":[";
+
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent& event = events[i];
+        out << (i ? "," : "") << "\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0"
+            << ",\"tid\":" << event.worker_id << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us << "}";
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <geo_utils/geohash.h>
+
+namespace graph {
+namespace algorithms {
+
+using VertexOrder = std::vector<std::uint32_t>;
+
+/**
+ * @brief Vertices sorted along the hilbert curve over the graph bounding box, so vertices
+ * close on the map get close indices. Needs vertex coordinates.
+ *
+ * @return Permutation: new index -> old index
+ */
+template <typename Vertex>
+VertexOrder hilbert_order(const CompiledGraph<Vertex>& graph) {
+    constexpr std::uint64_t dim = 1ull << 16;
+    const size_t count = graph.vertices_count();
+
+    if (!graph.has_coordinates()) {
+        throw std::runtime_error("Hilbert order needs vertex coordinates");
+    }
+
+    float min_x = std::numeric_limits<float>::max();
+    float max_x = std::numeric_limits<float>::lowest();
+    float min_y = std::numeric_limits<float>::max();
+    float max_y = std::numeric_limits<float>::lowest();
+
+    for (std::uint32_t v = 0; v < count; v++) {
+        min_x = std::min(min_x, graph.x(v));
+        max_x = std::max(max_x, graph.x(v));
+        min_y = std::min(min_y, graph.y(v));
+        max_y = std::max(max_y, graph.y(v));
+    }
+
+    double scale_x = max_x > min_x ? (dim - 1) / (static_cast<double>(max_x) - min_x) : 0;
+    double scale_y = max_y > min_y ? (dim - 1) / (static_cast<double>(max_y) - min_y) : 0;
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> keys(count);
+
+    for (std::uint32_t v = 0; v < count; v++) {
+        auto x = static_cast<std::uint64_t>((graph.x(v) - min_x) * scale_x);
+        auto y = static_cast<std::uint64_t>((graph.y(v) - min_y) * scale_y);
+        keys[v] = {geo_utils::geohash::xy2hash(x, y, dim), v};
+    }
+
+    std::sort(keys.begin(), keys.end());
+    VertexOrder order(count);
+
+    for (size_t i = 0; i < count; i++) {
+        order[i] = keys[i].second;
+    }
+
+    return order;
+}
+
+/**
+ * @brief Reverse Cuthill-McKee order of the graph with edge directions ignored.
+ * Every connected component is a breadth first search from its lowest degree vertex
+ * visiting neighbours by increasing degree, which keeps neighbours close in the order.
+ * Works without coordinates.
+ *
+ * @return Permutation: new index -> old index
+ */
+template <typename Vertex>
+VertexOrder rcm_order(const CompiledGraph<Vertex>& graph) {
+    const std::uint32_t count = graph.vertices_count();
+
+    // Undirected adjacency in CSR form
+    std::vector<std::uint32_t> offsets(count + 1, 0);
+    for (std::uint32_t v = 0; v < count; v++) {
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            offsets[v + 1]++;
+            offsets[graph.target(edge) + 1]++;
+        }
+    }
+    for (std::uint32_t v = 0; v < count; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    std::vector<std::uint32_t> adjacency(offsets.back());
+    std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::uint32_t v = 0; v < count; v++) {
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            adjacency[fill[v]++] = graph.target(edge);
+            adjacency[fill[graph.target(edge)]++] = v;
+        }
+    }
+
+    auto degree = [&offsets](std::uint32_t v) {
+        return offsets[v + 1] - offsets[v];
+    };
+    auto by_degree = [&degree](std::uint32_t lhs, std::uint32_t rhs) {
+        return std::make_pair(degree(lhs), lhs) < std::make_pair(degree(rhs), rhs);
+    };
+
+    std::vector<std::uint32_t> roots(count);
+    std::iota(roots.begin(), roots.end(), 0);
+    std::sort(roots.begin(), roots.end(), by_degree);
+
+    VertexOrder order;
+    order.reserve(count);
+    std::vector<bool> visited(count, false);
+    std::vector<std::uint32_t> neighbours;
+
+    for (auto root : roots) {
+        if (visited[root]) {
+            continue;
+        }
+
+        visited[root] = true;
+        order.push_back(root);
+
+        // order doubles as the bfs queue
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            std::uint32_t v = order[head];
+            neighbours.clear();
+
+            for (auto i = offsets[v]; i < offsets[v + 1]; i++) {
+                if (!visited[adjacency[i]]) {
+                    visited[adjacency[i]] = true;
+                    neighbours.push_back(adjacency[i]);
+                }
+            }
+
+            std::sort(neighbours.begin(), neighbours.end(), by_degree);
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/**
+ * @brief Hilbert order when vertices have coordinates, reverse Cuthill-McKee otherwise
+ */
+template <typename Vertex>
+VertexOrder locality_order(const CompiledGraph<Vertex>& graph) {
+    return graph.has_coordinates() ? hilbert_order(graph) : rcm_order(graph);
+}
+
+/**
+ * @brief Copy of the graph renumbered by locality_order, so searches touch nearby memory
+ */
+template <typename Vertex>
+CompiledGraph<Vertex> reorder_for_locality(const CompiledGraph<Vertex>& graph) {
+    return graph.permuted(locality_order(graph));
+}
+
+/**
+ * @brief Mean absolute index distance between edge ends; lower means better locality
+ */
+template <typename Vertex>
+double mean_edge_span(const CompiledGraph<Vertex>& graph) {
+    if (graph.edges_count() == 0) {
+        return 0;
+    }
+
+    double span_sum = 0;
+    for (std::uint32_t v = 0; v < graph.vertices_count(); v++) {
+        for (auto edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+            span_sum += v > graph.target(edge) ? v - graph.target(edge) : graph.target(edge) - v;
+        }
+    }
+    return span_sum / graph.edges_count();
+}
+
+}  // namespace algorithms
+}  // namespace graph
@@ -0,0 +1,457 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <graph.h>
+#include <library/memory_accounting.h>
+#include <library/string_pool.h>
+
+namespace graph {
+
+enum class SearchDirection {
+    // Follow edges u -> v: distances from the start vertex
+    Forward,
+    // Follow edges backwards on the transposed graph: distances to the start vertex
+    Backward,
+};
+
+template <SearchDirection Direction>
+using SearchDirectionTag = std::integral_constant<SearchDirection, Direction>;
+
+/**
+ * @brief Call func with the direction as a compile time tag, so searches dispatch on it once
+ * instead of branching on every edge
+ */
+template <typename Func>
+decltype(auto) dispatch_direction(SearchDirection direction, Func&& func) {
+    if (direction == SearchDirection::Forward) {
+        return func(SearchDirectionTag<SearchDirection::Forward>{});
+    }
+    return func(SearchDirectionTag<SearchDirection::Backward>{});
+}
+
+/**
+ * @brief Immutable graph in compressed sparse row form.
+ *
+ * Vertices are renumbered to dense indices [0, vertices_count()). Outgoing edges of vertex v
+ * are [first_edge(v), last_edge(v)) in flat target and weight arrays, and the id dictionary
+ * maps indices back to vertices. Vertices with x and y members (OSMNode) also get coordinate
+ * arrays. Algorithms work with indices, so a search touches a few flat arrays instead of
+ * hash map nodes spread over the heap.
+ *
+ * The transposed adjacency is optional: incoming edges of every vertex as source vertices and
+ * forward edge ids, so both directions read the same weight array.
+ */
+template <typename Vertex>
+class CompiledGraph {
+   public:
+    using Index = std::uint32_t;
+    static constexpr Index kInvalidIndex = std::numeric_limits<Index>::max();
+
+   private:
+    std::shared_ptr<const lib::StringPool> string_pool_;
+    lib::CountedVector<Vertex, lib::MemoryCategory::Ids> vertices_;
+    std::unordered_map<Vertex, Index> index_;
+    lib::CountedVector<Index, lib::MemoryCategory::Topology> offsets_;
+    lib::CountedVector<Index, lib::MemoryCategory::Topology> targets_;
+    lib::CountedVector<float, lib::MemoryCategory::Weights> weights_;
+    lib::CountedVector<float, lib::MemoryCategory::Coordinates> x_;
+    lib::CountedVector<float, lib::MemoryCategory::Coordinates> y_;
+    // Transposed adjacency, empty unless built
+    lib::CountedVector<Index, lib::MemoryCategory::Topology> in_offsets_;
+    lib::CountedVector<Index, lib::MemoryCategory::Topology> in_sources_;
+    lib::CountedVector<Index, lib::MemoryCategory::Topology> in_edges_;
+
+    static constexpr bool kHasCoordinates = requires(const Vertex& vertex) {
+        vertex.x;
+        vertex.y;
+    };
+
+    Index add_vertex(const Vertex& vertex) {
+        auto [it, inserted] = index_.emplace(vertex, static_cast<Index>(vertices_.size()));
+        if (inserted) {
+            if (vertices_.size() >= kInvalidIndex) {
+                throw std::runtime_error("Too many vertices for CompiledGraph");
+            }
+            vertices_.push_back(vertex);
+        }
+        return it->second;
+    }
+
+    void fill_coordinates() {
+        if constexpr (kHasCoordinates) {
+            x_.reserve(vertices_.size());
+            y_.reserve(vertices_.size());
+            for (const auto& vertex : vertices_) {
+                x_.push_back(vertex.x);
+                y_.push_back(vertex.y);
+            }
+        }
+    }
+
+    // Inverse of order, kInvalidIndex for vertices not in it
+    std::vector<Index> new_indices(const std::vector<Index>& order, const char* error) const {
+        std::vector<Index> new_index(vertices_.size(), kInvalidIndex);
+        for (Index new_v = 0; new_v < order.size(); new_v++) {
+            if (order[new_v] >= vertices_.size() || new_index[order[new_v]] != kInvalidIndex) {
+                throw std::runtime_error(error);
+            }
+            new_index[order[new_v]] = new_v;
+        }
+        return new_index;
+    }
+
+    // Vertices of order renumbered by their position with the edges between them
+    CompiledGraph remapped(const std::vector<Index>& order, const std::vector<Index>& new_index) const {
+        CompiledGraph res;
+        res.string_pool_ = string_pool_;
+        res.vertices_.reserve(order.size());
+        res.index_.reserve(order.size());
+        res.offsets_.assign(order.size() + 1, 0);
+        res.targets_.reserve(targets_.size());
+        res.weights_.reserve(weights_.size());
+        std::vector<std::pair<Index, float>> edges;
+
+        for (Index new_v = 0; new_v < order.size(); new_v++) {
+            Index old_v = order[new_v];
+            res.vertices_.push_back(vertices_[old_v]);
+            res.index_.emplace(vertices_[old_v], new_v);
+
+            edges.clear();
+            for (Index edge = first_edge(old_v); edge < last_edge(old_v); edge++) {
+                if (new_index[targets_[edge]] != kInvalidIndex) {
+                    edges.push_back({new_index[targets_[edge]], weights_[edge]});
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+
+            for (const auto& [target, weight] : edges) {
+                res.targets_.push_back(target);
+                res.weights_.push_back(weight);
+            }
+            res.offsets_[new_v + 1] = res.targets_.size();
+        }
+        if (res.targets_.size() < targets_.size()) {
+            res.targets_.shrink_to_fit();
+            res.weights_.shrink_to_fit();
+        }
+
+        if (!x_.empty()) {
+            res.x_.reserve(order.size());
+            res.y_.reserve(order.size());
+            for (auto old_v : order) {
+                res.x_.push_back(x_[old_v]);
+                res.y_.push_back(y_[old_v]);
+            }
+        }
+        if (has_transposed()) {
+            res.build_transposed();
+        }
+
+        return res;
+    }
+
+   public:
+    CompiledGraph() = default;
+    CompiledGraph(const CompiledGraph&) = delete;
+    CompiledGraph(CompiledGraph&&) = default;
+    CompiledGraph& operator=(CompiledGraph&&) = default;
+
+    /**
+     * @brief Compile a hash map graph; vertices are numbered in the map iteration order,
+     * vertices which only appear as edge targets get no outgoing edges
+     *
+     * @param graph Hash map graph
+     * @param with_transposed Also build the transposed adjacency for backward searches
+     */
+    explicit CompiledGraph(const Graph<Vertex>& graph, bool with_transposed = false)
+        : string_pool_(graph.get_string_pool()) {
+        const auto& weights = graph.get_weights();
+        size_t edges_count = 0;
+        vertices_.reserve(weights.size());
+        index_.reserve(weights.size());
+
+        for (const auto& [vertex, neighbors] : weights) {
+            add_vertex(vertex);
+            edges_count += neighbors.size();
+        }
+        for (const auto& [vertex, neighbors] : weights) {
+            for (const auto& [neighbor, weight] : neighbors) {
+                add_vertex(neighbor);
+            }
+        }
+
+        if (edges_count >= kInvalidIndex) {
+            throw std::runtime_error("Too many edges for CompiledGraph");
+        }
+
+        offsets_.assign(vertices_.size() + 1, 0);
+        for (const auto& [vertex, neighbors] : weights) {
+            offsets_[index_.at(vertex) + 1] = neighbors.size();
+        }
+        for (size_t v = 0; v < vertices_.size(); v++) {
+            offsets_[v + 1] += offsets_[v];
+        }
+
+        targets_.resize(edges_count);
+        weights_.resize(edges_count);
+        for (const auto& [vertex, neighbors] : weights) {
+            Index edge = offsets_[index_.at(vertex)];
+            for (const auto& [neighbor, weight] : neighbors) {
+                targets_[edge] = index_.at(neighbor);
+                weights_[edge] = weight;
+                edge++;
+            }
+        }
+
+        fill_coordinates();
+        if (with_transposed) {
+            build_transposed();
+        }
+    }
+
+    /**
+     * @brief Build the transposed adjacency if it is not built yet; not thread safe
+     */
+    void build_transposed() {
+        if (has_transposed()) {
+            return;
+        }
+
+        const size_t count = vertices_.size();
+        in_offsets_.assign(count + 1, 0);
+        for (auto target : targets_) {
+            in_offsets_[target + 1]++;
+        }
+        for (size_t v = 0; v < count; v++) {
+            in_offsets_[v + 1] += in_offsets_[v];
+        }
+
+        in_sources_.resize(targets_.size());
+        in_edges_.resize(targets_.size());
+        std::vector<Index> fill(in_offsets_.begin(), in_offsets_.end() - 1);
+        for (Index v = 0; v < count; v++) {
+            for (Index edge = offsets_[v]; edge < offsets_[v + 1]; edge++) {
+                Index pos = fill[targets_[edge]]++;
+                in_sources_[pos] = v;
+                in_edges_[pos] = edge;
+            }
+        }
+    }
+
+    bool has_transposed() const {
+        return !in_offsets_.empty();
+    }
+
+    std::shared_ptr<const lib::StringPool> get_string_pool() const {
+        return string_pool_;
+    }
+
+    size_t vertices_count() const {
+        return vertices_.size();
+    }
+
+    size_t edges_count() const {
+        return targets_.size();
+    }
+
+    Index first_edge(Index v) const {
+        return offsets_[v];
+    }
+
+    Index last_edge(Index v) const {
+        return offsets_[v + 1];
+    }
+
+    Index out_degree(Index v) const {
+        return offsets_[v + 1] - offsets_[v];
+    }
+
+    Index target(Index edge) const {
+        return targets_[edge];
+    }
+
+    float weight(Index edge) const {
+        return weights_[edge];
+    }
+
+    // Incoming edges of v are [first_in_edge(v), last_in_edge(v)) in the transposed adjacency
+
+    Index first_in_edge(Index v) const {
+        return in_offsets_[v];
+    }
+
+    Index last_in_edge(Index v) const {
+        return in_offsets_[v + 1];
+    }
+
+    Index in_source(Index in_edge) const {
+        return in_sources_[in_edge];
+    }
+
+    float in_weight(Index in_edge) const {
+        return weights_[in_edges_[in_edge]];
+    }
+
+    /**
+     * @brief Call relax(neighbor, edge) for edges out of v, or into v for Backward, where edge
+     * is the forward edge id for weight(); Backward needs the transposed adjacency
+     */
+    template <SearchDirection Direction, typename Relax>
+    void for_each_edge_id(Index v, Relax&& relax) const {
+        if constexpr (Direction == SearchDirection::Forward) {
+            for (Index edge = offsets_[v]; edge < offsets_[v + 1]; edge++) {
+                relax(targets_[edge], edge);
+            }
+        } else {
+            for (Index in_edge = in_offsets_[v]; in_edge < in_offsets_[v + 1]; in_edge++) {
+                relax(in_sources_[in_edge], in_edges_[in_edge]);
+            }
+        }
+    }
+
+    /**
+     * @brief Call relax(neighbor, weight) for edges out of v, or into v for Backward
+     */
+    template <SearchDirection Direction, typename Relax>
+    void for_each_edge(Index v, Relax&& relax) const {
+        for_each_edge_id<Direction>(v, [&](Index u, Index edge) {
+            relax(u, weights_[edge]);
+        });
+    }
+
+    /**
+     * @brief Throws std::runtime_error if a search in the direction can not run on this graph
+     */
+    void check_direction(SearchDirection direction) const {
+        if (direction == SearchDirection::Backward && !has_transposed()) {
+            throw std::runtime_error("Backward search needs the transposed graph, see CompiledGraph::build_transposed");
+        }
+    }
+
+    const Vertex& vertex(Index v) const {
+        return vertices_[v];
+    }
+
+    /**
+     * @brief Index of the vertex; throws std::out_of_range for unknown vertices
+     */
+    Index index(const Vertex& vertex) const {
+        return index_.at(vertex);
+    }
+
+    Index find_index(const Vertex& vertex) const {
+        auto it = index_.find(vertex);
+        return it == index_.end() ? kInvalidIndex : it->second;
+    }
+
+    bool has_coordinates() const {
+        return kHasCoordinates;
+    }
+
+    float x(Index v) const {
+        return x_[v];
+    }
+
+    float y(Index v) const {
+        return y_[v];
+    }
+
+    /**
+     * @brief Hash of vertex ids, topology and weights in index order; data precomputed for
+     * the graph (landmark tables) is checked against it when loaded back
+     */
+    std::uint64_t fingerprint() const {
+        constexpr std::uint64_t kPrime = 1'099'511'628'211ull;
+        std::uint64_t res = 14'695'981'039'346'656'037ull;
+        auto mix = [&res](std::uint64_t value) { res = (res ^ value) * kPrime; };
+
+        mix(vertices_.size());
+        for (const auto& vertex : vertices_) {
+            mix(std::hash<Vertex>{}(vertex));
+        }
+        for (auto offset : offsets_) {
+            mix(offset);
+        }
+        for (auto target : targets_) {
+            mix(target);
+        }
+        for (auto weight : weights_) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &weight, sizeof(bits));
+            mix(bits);
+        }
+        return res;
+    }
+
+    /**
+     * @brief Same graph with vertex order[i] moved to index i.
+     * Topology, weights, coordinates and the id dictionary are permuted together,
+     * outgoing edges of every vertex are sorted by target index. The transposed adjacency
+     * is rebuilt if the graph has it.
+     *
+     * @param order Permutation of [0, vertices_count()): new index -> old index
+     */
+    CompiledGraph permuted(const std::vector<Index>& order) const {
+        if (order.size() != vertices_.size()) {
+            throw std::runtime_error("Vertex order size does not match vertices count: " + std::to_string(order.size()));
+        }
+
+        return remapped(order, new_indices(order, "Vertex order is not a permutation"));
+    }
+
+    /**
+     * @brief Graph induced by a subset of vertices: vertices[i] gets index i and edges to the
+     * vertices left out are dropped. Otherwise works like permuted(), the id dictionary only
+     * keeps the remaining vertices. The string pool is shared with this graph.
+     *
+     * @param vertices Distinct vertices to keep: new index -> old index
+     */
+    CompiledGraph subgraph(const std::vector<Index>& vertices) const {
+        return remapped(vertices, new_indices(vertices, "Subgraph vertices are not distinct"));
+    }
+
+    /**
+     * @brief Bytes by category; flat arrays are exact, the id dictionary is estimated
+     */
+    lib::MemoryReport memory_usage() const {
+        using lib::account_memory;
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Topology] += lib::vector_bytes(offsets_) + lib::vector_bytes(targets_) +
+                                              lib::vector_bytes(in_offsets_) + lib::vector_bytes(in_sources_) +
+                                              lib::vector_bytes(in_edges_);
+        res[lib::MemoryCategory::Weights] += lib::vector_bytes(weights_);
+        res[lib::MemoryCategory::Coordinates] += lib::vector_bytes(x_) + lib::vector_bytes(y_);
+        res[lib::MemoryCategory::Ids] += (vertices_.capacity() - vertices_.size()) * sizeof(Vertex);
+        res[lib::MemoryCategory::Indexes] += lib::hash_buckets_bytes(index_) +
+                                             index_.size() * (lib::kHashNodeOverhead + sizeof(Index));
+
+        for (const auto& vertex : vertices_) {
+            account_memory(vertex, res, true);
+        }
+        // Dictionary keys are copies of the vertices
+        for (const auto& [vertex, v] : index_) {
+            lib::MemoryReport key;
+            account_memory(vertex, key, false);
+            res[lib::MemoryCategory::Indexes] += key.total();
+        }
+        if (string_pool_) {
+            res += string_pool_->memory_usage();
+        }
+
+        return res;
+    }
+};
+
+}  // namespace graph
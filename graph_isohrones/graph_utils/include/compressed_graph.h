@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <quantized_weights.h>
+#include <library/memory_accounting.h>
+#include <library/string_pool.h>
+
+namespace graph {
+
+/**
+ * @brief Read-only graph with a byte-compressed adjacency: a smaller in-memory copy of a
+ * CompiledGraph, which is needed to build it.
+ *
+ * Every vertex has a record of its edges sorted by target: the record byte length, then for every
+ * edge the target gap and the quantized weight, all as LEB128 varints. The first target is
+ * zigzag-coded relative to the vertex itself, so a locality order (hilbert_order, rcm_order) makes
+ * most gaps one or two bytes. Every kBlockSize-th record has a byte offset, records in between are
+ * found by skipping over the record lengths.
+ *
+ * Weights are stored in units of the quantization, searches get integer distances in units.
+ * Edges have no ids; for_each_edge_id passes an EdgeRef carrying the decoded weight, read by the
+ * CompressedWeight policy of DijkstraSearch. The transposed adjacency is compressed the same way
+ * with its own copy of the weights.
+ */
+template <typename Vertex>
+class CompressedGraph {
+   public:
+    using Index = std::uint32_t;
+    static constexpr Index kInvalidIndex = std::numeric_limits<Index>::max();
+    static constexpr Index kBlockSize = 16;
+
+    // Decoded edge: compressed edges have no ids, the weight is read with the target
+    struct EdgeRef {
+        std::uint32_t units;
+    };
+
+   private:
+    struct Adjacency {
+        lib::CountedVector<std::uint8_t, lib::MemoryCategory::Topology> data;
+        lib::CountedVector<std::uint64_t, lib::MemoryCategory::Topology> block_offsets;
+
+        bool empty() const {
+            return block_offsets.empty();
+        }
+
+        size_t bytes() const {
+            return lib::vector_bytes(data) + lib::vector_bytes(block_offsets);
+        }
+    };
+
+    std::shared_ptr<const lib::StringPool> string_pool_;
+    lib::CountedVector<Vertex, lib::MemoryCategory::Ids> vertices_;
+    std::unordered_map<Vertex, Index> index_;
+    Adjacency forward_;
+    // Transposed adjacency, empty unless built
+    Adjacency backward_;
+    size_t edges_count_ = 0;
+    float unit_ = 1;
+
+    template <typename Data>
+    static void write_varint(Data& data, std::uint32_t value) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    static std::uint32_t read_varint(const std::uint8_t*& pos) {
+        std::uint32_t value = *pos++;
+        if (value < 0x80) {
+            return value;
+        }
+        value &= 0x7f;
+        for (int shift = 7;; shift += 7) {
+            std::uint32_t byte = *pos++;
+            value |= (byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    // Signed gaps modulo 2^32, so every gap fits into a uint32_t varint
+    static std::uint32_t zigzag(Index from, Index to) {
+        auto gap = static_cast<std::int32_t>(to - from);
+        return (static_cast<std::uint32_t>(gap) << 1) ^ static_cast<std::uint32_t>(gap >> 31);
+    }
+
+    static Index unzigzag(Index from, std::uint32_t value) {
+        return from + ((value >> 1) ^ (0u - (value & 1)));
+    }
+
+    // edges(v, out) fills (neighbor, units) pairs of v
+    template <typename Edges>
+    static Adjacency encode(size_t vertices_count, Edges&& edges) {
+        Adjacency res;
+        res.block_offsets.reserve((vertices_count + kBlockSize - 1) / kBlockSize);
+        std::vector<std::pair<Index, std::uint32_t>> vertex_edges;
+        std::vector<std::uint8_t> record;
+
+        for (Index v = 0; v < vertices_count; v++) {
+            if (v % kBlockSize == 0) {
+                res.block_offsets.push_back(res.data.size());
+            }
+            vertex_edges.clear();
+            edges(v, vertex_edges);
+            std::sort(vertex_edges.begin(), vertex_edges.end());
+
+            record.clear();
+            Index prev = v;
+            for (size_t i = 0; i < vertex_edges.size(); i++) {
+                const auto& [u, units] = vertex_edges[i];
+                write_varint(record, i == 0 ? zigzag(v, u) : u - prev);
+                write_varint(record, units);
+                prev = u;
+            }
+            write_varint(res.data, record.size());
+            res.data.insert(res.data.end(), record.begin(), record.end());
+        }
+        res.data.shrink_to_fit();
+        return res;
+    }
+
+    static const std::uint8_t* find_record(const Adjacency& adjacency, Index v) {
+        const std::uint8_t* pos = adjacency.data.data() + adjacency.block_offsets[v / kBlockSize];
+        for (Index skip = v % kBlockSize; skip > 0; skip--) {
+            std::uint32_t length = read_varint(pos);
+            pos += length;
+        }
+        return pos;
+    }
+
+    template <typename Relax>
+    static void decode(const Adjacency& adjacency, Index v, Relax&& relax) {
+        const std::uint8_t* pos = find_record(adjacency, v);
+        std::uint32_t length = read_varint(pos);
+        const std::uint8_t* end = pos + length;
+
+        if (pos < end) {
+            Index u = unzigzag(v, read_varint(pos));
+            relax(u, EdgeRef{read_varint(pos)});
+            while (pos < end) {
+                u += read_varint(pos);
+                relax(u, EdgeRef{read_varint(pos)});
+            }
+        }
+    }
+
+   public:
+    CompressedGraph() = default;
+    CompressedGraph(const CompressedGraph&) = delete;
+    CompressedGraph(CompressedGraph&&) = default;
+    CompressedGraph& operator=(CompressedGraph&&) = default;
+
+    /**
+     * @brief Compress a compiled graph with the same vertex indices; reorder it for locality first.
+     * The transposed adjacency is compressed if the graph has it.
+     *
+     * @param graph Compiled graph with non-negative weights
+     * @param quantization Weight unit; weights are stored as uint32_t units
+     */
+    explicit CompressedGraph(const CompiledGraph<Vertex>& graph, Quantization quantization = {})
+        : string_pool_(graph.get_string_pool()), edges_count_(graph.edges_count()), unit_(quantization.unit) {
+        QuantizedWeights<std::uint32_t> weights(graph, quantization);
+        const size_t count = graph.vertices_count();
+
+        vertices_.reserve(count);
+        index_.reserve(count);
+        for (Index v = 0; v < count; v++) {
+            vertices_.push_back(graph.vertex(v));
+            index_.emplace(graph.vertex(v), v);
+        }
+
+        forward_ = encode(count, [&](Index v, auto& edges) {
+            for (Index edge = graph.first_edge(v); edge < graph.last_edge(v); edge++) {
+                edges.push_back({graph.target(edge), weights[edge]});
+            }
+        });
+        if (graph.has_transposed()) {
+            backward_ = encode(count, [&](Index v, auto& edges) {
+                graph.template for_each_edge_id<SearchDirection::Backward>(v, [&](Index u, Index edge) {
+                    edges.push_back({u, weights[edge]});
+                });
+            });
+        }
+    }
+
+    bool has_transposed() const {
+        return !backward_.empty();
+    }
+
+    size_t vertices_count() const {
+        return vertices_.size();
+    }
+
+    size_t edges_count() const {
+        return edges_count_;
+    }
+
+    float unit() const {
+        return unit_;
+    }
+
+    float to_weight(std::uint32_t units) const {
+        return static_cast<float>(static_cast<double>(units) * unit_);
+    }
+
+    /**
+     * @brief Call relax(neighbor, EdgeRef) for edges out of v, or into v for Backward, in
+     * increasing neighbor order; Backward needs the transposed adjacency
+     */
+    template <SearchDirection Direction, typename Relax>
+    void for_each_edge_id(Index v, Relax&& relax) const {
+        decode(Direction == SearchDirection::Forward ? forward_ : backward_, v, relax);
+    }
+
+    /**
+     * @brief Call relax(neighbor, weight) for edges out of v, or into v for Backward
+     */
+    template <SearchDirection Direction, typename Relax>
+    void for_each_edge(Index v, Relax&& relax) const {
+        for_each_edge_id<Direction>(v, [&](Index u, EdgeRef edge) {
+            relax(u, to_weight(edge.units));
+        });
+    }
+
+    /**
+     * @brief Throws std::runtime_error if a search in the direction can not run on this graph
+     */
+    void check_direction(SearchDirection direction) const {
+        if (direction == SearchDirection::Backward && !has_transposed()) {
+            throw std::runtime_error("Backward search needs the transposed graph, compress a graph with it");
+        }
+    }
+
+    const Vertex& vertex(Index v) const {
+        return vertices_[v];
+    }
+
+    /**
+     * @brief Index of the vertex; throws std::out_of_range for unknown vertices
+     */
+    Index index(const Vertex& vertex) const {
+        return index_.at(vertex);
+    }
+
+    Index find_index(const Vertex& vertex) const {
+        auto it = index_.find(vertex);
+        return it == index_.end() ? kInvalidIndex : it->second;
+    }
+
+    /**
+     * @brief Bytes of the compressed adjacencies with weights and skip offsets
+     */
+    size_t adjacency_bytes() const {
+        return forward_.bytes() + backward_.bytes();
+    }
+
+    /**
+     * @brief Bytes by category; weights are inside the topology records
+     */
+    lib::MemoryReport memory_usage() const {
+        using lib::account_memory;
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Topology] += adjacency_bytes();
+        res[lib::MemoryCategory::Ids] += (vertices_.capacity() - vertices_.size()) * sizeof(Vertex);
+        res[lib::MemoryCategory::Indexes] += lib::hash_buckets_bytes(index_) +
+                                             index_.size() * (lib::kHashNodeOverhead + sizeof(Index));
+
+        for (const auto& vertex : vertices_) {
+            account_memory(vertex, res, true);
+        }
+        for (const auto& [vertex, v] : index_) {
+            lib::MemoryReport key;
+            account_memory(vertex, key, false);
+            res[lib::MemoryCategory::Indexes] += key.total();
+        }
+        if (string_pool_) {
+            res += string_pool_->memory_usage();
+        }
+        return res;
+    }
+};
+
+}  // namespace graph
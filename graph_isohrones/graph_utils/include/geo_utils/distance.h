@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
+namespace geo_utils {
+
+// Polar radius of the WGS84 ellipsoid: distances on this sphere never exceed the ellipsoidal ones,
+// so they are safe lower bounds for shortest paths
+constexpr double kEarthMinRadiusMeters = 6'356'752.0;
+constexpr double kDegToRad = std::numbers::pi / 180.0;
+
+/**
+ * @brief Great-circle distance between two points by the haversine formula
+ *
+ * @param lon1 Longitude of the first point in degrees
+ * @param lat1 Latitude of the first point in degrees
+ * @param lon2 Longitude of the second point in degrees
+ * @param lat2 Latitude of the second point in degrees
+ * @param radius Sphere radius in meters
+ * @return Distance in meters
+ */
+inline double great_circle_distance(double lon1, double lat1, double lon2, double lat2, double radius = kEarthMinRadiusMeters) {
+    double sin_dlat = std::sin((lat2 - lat1) * kDegToRad / 2);
+    double sin_dlon = std::sin((lon2 - lon1) * kDegToRad / 2);
+    double a = sin_dlat * sin_dlat + std::cos(lat1 * kDegToRad) * std::cos(lat2 * kDegToRad) * sin_dlon * sin_dlon;
+    return 2 * radius * std::asin(std::sqrt(std::min(1.0, a)));
+}
+
+/**
+ * @brief Point on the unit sphere; the chord between two such points times the radius never
+ * exceeds the great-circle distance and is much cheaper to compute than haversine
+ *
+ * @param lon Longitude in degrees
+ * @param lat Latitude in degrees
+ */
+inline std::array<double, 3> unit_vector(double lon, double lat) {
+    double cos_lat = std::cos(lat * kDegToRad);
+    return {cos_lat * std::cos(lon * kDegToRad), cos_lat * std::sin(lon * kDegToRad), std::sin(lat * kDegToRad)};
+}
+
+/**
+ * @brief Straight line distance through the sphere between points given by unit_vector
+ */
+inline double chord_distance(const std::array<double, 3>& lhs, const std::array<double, 3>& rhs, double radius = kEarthMinRadiusMeters) {
+    double dx = lhs[0] - rhs[0];
+    double dy = lhs[1] - rhs[1];
+    double dz = lhs[2] - rhs[2];
+    return radius * std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+}  // namespace geo_utils
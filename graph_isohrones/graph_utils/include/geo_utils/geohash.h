@@ -1,16 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
-// TODO add decode
-
 namespace geo_utils {
 namespace geohash {
     constexpr double kLatIntervalMin = -90.0;
@@ -19,6 +19,53 @@ namespace geohash {
     constexpr double kLonIntervalMax = 180.0;
     constexpr int kDefaultPrecision = 18;
     constexpr int kDefaultBitsPerChar = 2;
+    // Codes are kept in uint64_t and grid coords in int, so the curve level is limited to 30
+    constexpr int kMaxBits = 60;
+
+    // Custom base64 encoding with integer order preservation via lexicographical (byte) order
+    constexpr char kBase64[] = "0123456789@ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+    constexpr char kBase16[] = "0123456789abcdef";
+    constexpr char kBase4[] = "0123";
+
+    /**
+     * @brief Geohash cell described by its center and half sizes
+     */
+    struct Cell {
+        double lon;
+        double lat;
+        double lon_err;
+        double lat_err;
+
+        double min_lon() const { return lon - lon_err; }
+        double max_lon() const { return lon + lon_err; }
+        double min_lat() const { return lat - lat_err; }
+        double max_lat() const { return lat + lat_err; }
+    };
+
+    /**
+     * @brief Validate precision and bits_per_char and get the level of the hilbert curve
+     *
+     * @param precision The number of characters in a geohash
+     * @param bits_per_char The number of bits per coding character
+     * @return Level of the hilbert curve, i.e. the grid is 2^level x 2^level
+     */
+    inline int code_level(int precision, int bits_per_char) {
+        if (precision <= 0) {
+            throw std::runtime_error("Wrong precision: " + std::to_string(precision));
+        }
+
+        if (bits_per_char != 2 && bits_per_char != 4 && bits_per_char != 6) {
+            throw std::runtime_error("Wrong bits_per_char: " + std::to_string(bits_per_char));
+        }
+
+        if (precision * bits_per_char > kMaxBits) {
+            throw std::runtime_error(
+                "Too many bits: " + std::to_string(precision) + " x " + std::to_string(bits_per_char)
+            );
+        }
+
+        return precision * bits_per_char >> 1;
+    }
 
     /**
      * @brief Rotate and flip a quadrant appropriately
@@ -71,6 +118,31 @@ namespace geohash {
         return d;
     }
 
+    /**
+     * @brief Convert hashcode to (x, y). Inverse of xy2hash.
+     * Based on the implementation here:
+     *    https://en.wikipedia.org/w/index.php?title=Hilbert_curve&oldid=797332503
+     *
+     * @param code Hashcode [0, dim^2)
+     * @param dim Number of coding points each x, y value can take
+     * @return (x, y) point in dim x dim coord system
+     */
+    inline std::pair<std::uint64_t, std::uint64_t> hash2xy(std::uint64_t code, std::uint64_t dim) {
+        std::uint64_t x = 0;
+        std::uint64_t y = 0;
+
+        for (std::uint64_t lvl = 1; lvl < dim; lvl <<= 1) {
+            std::uint64_t rx = 1 & (code >> 1);
+            std::uint64_t ry = 1 & (code ^ rx);
+            auto xy = rotate(lvl, x, y, rx, ry);
+            x = xy.first + lvl * rx;
+            y = xy.second + lvl * ry;
+            code >>= 2;
+        }
+
+        return {x, y};
+    }
+
     /**
      * @brief Convert lon, lat values into a dim x dim-grid coordinate system.
      * 
@@ -105,16 +177,7 @@ namespace geohash {
             throw std::runtime_error("Wrong lon or lat: " + std::to_string(lon) + " " + std::to_string(lat));
         }
 
-        if (precision <= 0) {
-            throw std::runtime_error("Wrong precision: " + std::to_string(precision));
-        }
-
-        if (bits_per_char != 2 && bits_per_char != 4 && bits_per_char != 6) {
-            throw std::runtime_error("Wrong bits_per_char: " + std::to_string(bits_per_char));
-        }
-
-        int bits = precision * bits_per_char;
-        int level = bits >> 1;
+        int level = code_level(precision, bits_per_char);
         std::uint64_t dim = 1ull << level;
 
         auto xy = coord2int(lon, lat, dim);
@@ -123,15 +186,30 @@ namespace geohash {
         return code;
     }
 
+    /**
+     * @brief Write code as precision characters of the given alphabet, most significant first
+     */
+    inline std::string encode_int_with(std::uint64_t code, int precision, int bits_per_char, const char* alphabet) {
+        std::string str_code(precision, alphabet[0]);
+        std::uint64_t mask = (1ull << bits_per_char) - 1;
+
+        while (code && precision > 0) {
+            str_code[precision - 1] = alphabet[code & mask];
+            precision--;
+            code >>= bits_per_char;
+        }
+
+        return str_code;
+    }
+
     inline std::string encode_int64(std::uint64_t code, int precision) {
-        // TODO
-        throw std::runtime_error("Not implemented");
+        return encode_int_with(code, precision, 6, kBase64);
     }
 
     inline std::string encode_int16(std::uint64_t code, int precision) {
-        // TODO
-        throw std::runtime_error("Not implemented");
+        return encode_int_with(code, precision, 4, kBase16);
     }
+
     inline std::string encode_int4(std::uint64_t code, int precision) {
         std::string str_code(precision, '0');
 
@@ -178,5 +256,260 @@ namespace geohash {
 
         return str_code;
     }
+
+    /**
+     * @brief Get the value of a single coding character
+     *
+     * @param c Coding character
+     * @param bits_per_char The number of bits per coding character
+     * @return Value in [0, 2^bits_per_char)
+     */
+    inline std::uint64_t char_to_int(char c, int bits_per_char) {
+        int value = -1;
+
+        if (c >= '0' && c <= '9') {
+            value = c - '0';
+        } else if (bits_per_char == 4 && c >= 'a' && c <= 'f') {
+            value = c - 'a' + 10;
+        } else if (bits_per_char == 6) {
+            if (c == '@') {
+                value = 10;
+            } else if (c >= 'A' && c <= 'Z') {
+                value = c - 'A' + 11;
+            } else if (c == '_') {
+                value = 37;
+            } else if (c >= 'a' && c <= 'z') {
+                value = c - 'a' + 38;
+            }
+        }
+
+        if (value < 0 || value >= (1 << bits_per_char)) {
+            throw std::runtime_error("Wrong geohash character: " + std::string(1, c));
+        }
+
+        return value;
+    }
+
+    /**
+     * @brief Convert string representation to uint64_t code. Inverse of code_to_string.
+     *
+     * @param str_code Geohash code as a string
+     * @param bits_per_char The number of bits per coding character
+     * @return Geohash code in bits representation
+     */
+    inline std::uint64_t string_to_code(const std::string& str_code, int bits_per_char) {
+        code_level(str_code.size(), bits_per_char);
+        std::uint64_t code = 0;
+
+        for (char c : str_code) {
+            code = (code << bits_per_char) | char_to_int(c, bits_per_char);
+        }
+
+        return code;
+    }
+
+    /**
+     * @brief Decode uint64_t code to the cell it covers
+     *
+     * @param code Geohash code
+     * @param precision The number of characters in a geohash
+     * @param bits_per_char The number of bits per coding character
+     * @return Cell center and half sizes
+     */
+    inline Cell decode_int_exactly(std::uint64_t code, int precision = kDefaultPrecision, int bits_per_char = kDefaultBitsPerChar) {
+        int level = code_level(precision, bits_per_char);
+        std::uint64_t dim = 1ull << level;
+
+        if (code >= dim * dim) {
+            throw std::runtime_error("Code is out of range: " + std::to_string(code));
+        }
+
+        auto xy = hash2xy(code, dim);
+        double lon_err = 180.0 / dim;
+        double lat_err = 90.0 / dim;
+        double lon = xy.first * 360.0 / dim + kLonIntervalMin + lon_err;
+        double lat = xy.second * 180.0 / dim + kLatIntervalMin + lat_err;
+
+        return Cell{lon, lat, lon_err, lat_err};
+    }
+
+    /**
+     * @brief Decode string code to the cell it covers
+     *
+     * @param str_code Geohash code as a string; its length is the precision
+     * @param bits_per_char The number of bits per coding character
+     * @return Cell center and half sizes
+     */
+    inline Cell decode_exactly(const std::string& str_code, int bits_per_char = kDefaultBitsPerChar) {
+        std::uint64_t code = string_to_code(str_code, bits_per_char);
+        return decode_int_exactly(code, str_code.size(), bits_per_char);
+    }
+
+    /**
+     * @brief Decode string code to lon/lat of the cell center
+     *
+     * @param str_code Geohash code as a string; its length is the precision
+     * @param bits_per_char The number of bits per coding character
+     * @return Pair of lon, lat
+     */
+    inline std::pair<double, double> decode(const std::string& str_code, int bits_per_char = kDefaultBitsPerChar) {
+        Cell cell = decode_exactly(str_code, bits_per_char);
+        return {cell.lon, cell.lat};
+    }
+
+    /**
+     * @brief Get codes of the neighbouring cells.
+     * Order is north, north-east, east, south-east, south, south-west, west, north-west.
+     * East/west neighbours wrap around the globe, north/south ones are skipped at the poles.
+     *
+     * @param code Geohash code
+     * @param precision The number of characters in a geohash
+     * @param bits_per_char The number of bits per coding character
+     * @return Pairs of direction name and neighbour code
+     */
+    inline std::vector<std::pair<std::string, std::uint64_t>> neighbours_int(
+        std::uint64_t code,
+        int precision = kDefaultPrecision,
+        int bits_per_char = kDefaultBitsPerChar
+    ) {
+        static const char* const names[] = {
+            "north", "north-east", "east", "south-east", "south", "south-west", "west", "north-west"
+        };
+        static const int dx[] = {0, 1, 1, 1, 0, -1, -1, -1};
+        static const int dy[] = {1, 1, 0, -1, -1, -1, 0, 1};
+
+        int level = code_level(precision, bits_per_char);
+        std::uint64_t dim = 1ull << level;
+        auto xy = hash2xy(code, dim);
+        std::vector<std::pair<std::string, std::uint64_t>> res;
+
+        for (int i = 0; i < 8; i++) {
+            if ((dy[i] > 0 && xy.second + 1 >= dim) || (dy[i] < 0 && xy.second == 0)) {
+                continue;
+            }
+
+            std::uint64_t x = (xy.first + dim + dx[i]) % dim;
+            std::uint64_t y = xy.second + dy[i];
+            res.push_back({names[i], xy2hash(x, y, dim)});
+        }
+
+        return res;
+    }
+
+    /**
+     * @brief Get codes of the neighbouring cells
+     *
+     * @param str_code Geohash code as a string; its length is the precision
+     * @param bits_per_char The number of bits per coding character
+     * @return Map from direction name to neighbour code
+     */
+    inline std::map<std::string, std::string> neighbours(const std::string& str_code, int bits_per_char = kDefaultBitsPerChar) {
+        int precision = str_code.size();
+        std::uint64_t code = string_to_code(str_code, bits_per_char);
+        std::map<std::string, std::string> res;
+
+        for (auto& neighbour : neighbours_int(code, precision, bits_per_char)) {
+            res[neighbour.first] = code_to_string(neighbour.second, bits_per_char, precision);
+        }
+
+        return res;
+    }
+
+    namespace detail {
+        inline void cover_ranges(
+            std::uint64_t prefix,
+            int prefix_level,
+            int level,
+            std::uint64_t x_min,
+            std::uint64_t x_max,
+            std::uint64_t y_min,
+            std::uint64_t y_max,
+            std::vector<std::pair<std::uint64_t, std::uint64_t>>& ranges
+        ) {
+            // Cell of the prefix in the target level grid
+            int shift = level - prefix_level;
+            auto xy = hash2xy(prefix, 1ull << prefix_level);
+            std::uint64_t cell_x_min = xy.first << shift;
+            std::uint64_t cell_y_min = xy.second << shift;
+            std::uint64_t cell_x_max = cell_x_min + (1ull << shift) - 1;
+            std::uint64_t cell_y_max = cell_y_min + (1ull << shift) - 1;
+
+            if (cell_x_min > x_max || cell_x_max < x_min || cell_y_min > y_max || cell_y_max < y_min) {
+                return;
+            }
+
+            if (x_min <= cell_x_min && cell_x_max <= x_max && y_min <= cell_y_min && cell_y_max <= y_max) {
+                std::uint64_t first = prefix << (2 * shift);
+                std::uint64_t last = first + (1ull << (2 * shift)) - 1;
+
+                if (!ranges.empty() && ranges.back().second + 1 == first) {
+                    ranges.back().second = last;
+                } else {
+                    ranges.push_back({first, last});
+                }
+                return;
+            }
+
+            // Children of a hilbert cell are contiguous, so visiting them in code order keeps ranges sorted
+            for (std::uint64_t child = 0; child < 4; child++) {
+                cover_ranges(prefix << 2 | child, prefix_level + 1, level, x_min, x_max, y_min, y_max, ranges);
+            }
+        }
+    }
+
+    /**
+     * @brief Cover a bounding box with the minimal set of contiguous code ranges.
+     * Every cell intersecting the box gets into exactly one range. If min_lon > max_lon
+     * the box is treated as crossing the antimeridian.
+     *
+     * @param min_lon Minimal longitude of the box
+     * @param min_lat Minimal latitude of the box
+     * @param max_lon Maximal longitude of the box
+     * @param max_lat Maximal latitude of the box
+     * @param precision The number of characters in a geohash
+     * @param bits_per_char The number of bits per coding character
+     * @return Sorted inclusive [first, last] code ranges
+     */
+    inline std::vector<std::pair<std::uint64_t, std::uint64_t>> bbox_ranges(
+        double min_lon,
+        double min_lat,
+        double max_lon,
+        double max_lat,
+        int precision = kDefaultPrecision,
+        int bits_per_char = kDefaultBitsPerChar
+    ) {
+        if (min_lon < kLonIntervalMin || max_lon > kLonIntervalMax || min_lat < kLatIntervalMin || max_lat > kLatIntervalMax || min_lat > max_lat) {
+            throw std::runtime_error(
+                "Wrong bbox: " + std::to_string(min_lon) + " " + std::to_string(min_lat) + " " +
+                std::to_string(max_lon) + " " + std::to_string(max_lat)
+            );
+        }
+
+        int level = code_level(precision, bits_per_char);
+        std::uint64_t dim = 1ull << level;
+        auto min_xy = coord2int(min_lon, min_lat, dim);
+        auto max_xy = coord2int(max_lon, max_lat, dim);
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges;
+
+        if (min_lon <= max_lon) {
+            detail::cover_ranges(0, 0, level, min_xy.first, max_xy.first, min_xy.second, max_xy.second, ranges);
+            return ranges;
+        }
+
+        detail::cover_ranges(0, 0, level, min_xy.first, dim - 1, min_xy.second, max_xy.second, ranges);
+        detail::cover_ranges(0, 0, level, 0, max_xy.first, min_xy.second, max_xy.second, ranges);
+        std::sort(ranges.begin(), ranges.end());
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> merged;
+
+        for (auto& range : ranges) {
+            if (!merged.empty() && merged.back().second + 1 >= range.first) {
+                merged.back().second = std::max(merged.back().second, range.second);
+            } else {
+                merged.push_back(range);
+            }
+        }
+
+        return merged;
+    }
 }
 }
\ No newline at end of file
@@ -2,13 +2,14 @@
 #include <cstddef>
 #include <functional>
 #include <graph.h>
-#include <library/const_string.h>
+#include <library/memory_accounting.h>
+#include <library/string_pool.h>
 #include <string>
 
 namespace osm {
 
 struct OSMNode {
-  lib::const_string node_id;
+  lib::pooled_string node_id;
   float x;
   float y;
 
@@ -17,12 +18,18 @@ struct OSMNode {
   }
 };
 
+// Id chars live in the string pool, which the graph accounts as a whole
+inline void account_memory(const OSMNode &node, lib::MemoryReport &report, bool /*owner*/) {
+  report[lib::MemoryCategory::Ids] += sizeof(node.node_id);
+  report[lib::MemoryCategory::Coordinates] += sizeof(node.x) + sizeof(node.y);
+}
+
 using OSMGraph = graph::Graph<OSMNode>;
 
 } // namespace osm
 
 template <> struct std::hash<osm::OSMNode> {
   std::size_t operator()(const osm::OSMNode &node) const {
-    return std::hash<lib::const_string>{}(node.node_id);
+    return node.node_id.hash();
   }
 };
\ No newline at end of file
@@ -1,22 +1,65 @@
 #pragma once
 
+#include <memory>
 #include <unordered_map>
+#include <library/memory_accounting.h>
+#include <library/string_pool.h>
 
 namespace graph {
 template <typename Vertex>
 class Graph {
     using WeightsMap = std::unordered_map<Vertex, std::unordered_map<Vertex, float>>;
+    // Backs pooled string ids of vertices, declared first to be destroyed last
+    std::shared_ptr<const lib::StringPool> string_pool_;
     WeightsMap weights_;
 
    public:
     Graph() = default;
     Graph(const Graph&) = delete;
     Graph(Graph&&) = default;
+    Graph& operator=(Graph&&) = default;
     explicit Graph(WeightsMap&& weights_map)
         : weights_(std::move(weights_map)){};
+    Graph(WeightsMap&& weights_map, std::shared_ptr<const lib::StringPool> string_pool)
+        : string_pool_(std::move(string_pool)), weights_(std::move(weights_map)){};
 
     const std::unordered_map<Vertex, float>& get_neighbors(const Vertex& v) const {
         return this->weights_.at(v);
     }
+
+    const WeightsMap& get_weights() const {
+        return this->weights_;
+    }
+
+    const std::shared_ptr<const lib::StringPool>& get_string_pool() const {
+        return this->string_pool_;
+    }
+
+    /**
+     * @brief Estimated bytes of the graph by category: hash table structure is topology,
+     * edge lengths are weights, vertex keys are ids and coordinates
+     */
+    lib::MemoryReport memory_usage() const {
+        using lib::account_memory;
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Topology] += lib::hash_buckets_bytes(weights_);
+        if (string_pool_) {
+            res += string_pool_->memory_usage();
+        }
+
+        for (const auto& [vertex, neighbors] : weights_) {
+            // Keys of the outer map own the vertex ids, neighbor keys are copies
+            account_memory(vertex, res, true);
+            res[lib::MemoryCategory::Topology] += lib::kHashNodeOverhead + sizeof(neighbors) + lib::hash_buckets_bytes(neighbors);
+
+            for (const auto& [neighbor, weight] : neighbors) {
+                account_memory(neighbor, res, false);
+                res[lib::MemoryCategory::Topology] += lib::kHashNodeOverhead;
+                res[lib::MemoryCategory::Weights] += sizeof(weight);
+            }
+        }
+
+        return res;
+    }
 };
 }  // namespace graph
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <geo_utils/osm_graph.h>
 #include <graphmlpp.hpp>
+#include <library/string_pool.h>
+#include <memory>
 
 
 namespace io {
@@ -10,14 +12,16 @@ inline osm::OSMGraph load_graphml(std::istream &ifs) {
   std::unordered_map<osm::OSMNode, std::unordered_map<osm::OSMNode, float>>
       edges;
   std::unordered_map<nonstd::string_view, osm::OSMNode> nodes;
+  // All node ids of the graph in a few arenas, freed together with the graph
+  auto string_pool = std::make_shared<lib::StringPool>();
 
   gmlpp::Loader loader;
   loader.ReadStream(ifs);
 
   loader.Visit(
-      [&nodes](const gmlpp::Loader::ElementView &node) {
+      [&nodes, &string_pool](const gmlpp::Loader::ElementView &node) {
         // TODO: parse node to OSMNode
-        osm::OSMNode osm_node{node["id"].data(), node.Extract<float>("x"), node.Extract<float>("y")};
+        osm::OSMNode osm_node{string_pool->intern(node["id"]), node.Extract<float>("x"), node.Extract<float>("y")};
         nodes.insert({node["id"], osm_node});
       },
       [&edges, &nodes](const gmlpp::Loader::ElementView &edge) {
@@ -28,7 +32,7 @@ inline osm::OSMGraph load_graphml(std::istream &ifs) {
 
         edges[nodes.at(start_id)][nodes.at(end_id)] = length;
       });
-  return osm::OSMGraph(std::move(edges));
+  return osm::OSMGraph(std::move(edges), std::move(string_pool));
 }
 
 } // namespace io
\ No newline at end of file
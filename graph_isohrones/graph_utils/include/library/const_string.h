@@ -3,6 +3,7 @@
 #include <atomic>
 #include <cstring>
 #include <cstdint>
+#include <library/memory_accounting.h>
 #include <nonstd/string_view.hpp>
 
 namespace lib {
@@ -11,7 +12,7 @@ struct const_string {
 
   const_string(const char *str) {
     size_ = std::strlen(str);
-    char *ptr = new char[size_ + 1 + sizeof(std::atomic<int>)];
+    char *ptr = Allocator().allocate(heap_size());
     str_ = ptr;
     std::memcpy(ptr + sizeof(std::atomic<int>), str, size_ + 1);
 
@@ -52,16 +53,23 @@ struct const_string {
 
   constexpr std::size_t size() const { return size_; }
 
+  // Bytes of the shared buffer: refcount, chars and the terminating zero
+  constexpr std::size_t heap_size() const {
+    return size_ + 1 + sizeof(std::atomic<int>);
+  }
+
   constexpr char operator[](std::size_t i) const { return c_str()[i]; }
 
 private:
+  using Allocator = CountingAllocator<char, MemoryCategory::Ids>;
+
   void destroy() {
     if (counter().load(std::memory_order_relaxed) < 0) {
       return;
     }
     auto cnt = counter().fetch_sub(1, std::memory_order_relaxed);
     if (cnt == 1) {
-      delete[] str_;
+      Allocator().deallocate(const_cast<char *>(str_), heap_size());
     }
   }
 
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lib {
+
+enum class MemoryCategory : std::size_t {
+  Topology,
+  Weights,
+  Ids,
+  Coordinates,
+  Indexes,
+  Caches,
+  Results,
+};
+
+constexpr std::size_t kMemoryCategoriesCount = 7;
+
+inline const char *memory_category_name(MemoryCategory category) {
+  static constexpr const char *names[kMemoryCategoriesCount] = {
+      "topology", "weights", "ids", "coordinates", "indexes", "caches", "results"};
+  return names[static_cast<std::size_t>(category)];
+}
+
+/**
+ * @brief Bytes by memory category
+ */
+struct MemoryReport {
+  std::array<std::size_t, kMemoryCategoriesCount> bytes{};
+
+  std::size_t &operator[](MemoryCategory category) {
+    return bytes[static_cast<std::size_t>(category)];
+  }
+
+  std::size_t operator[](MemoryCategory category) const {
+    return bytes[static_cast<std::size_t>(category)];
+  }
+
+  std::size_t total() const {
+    std::size_t res = 0;
+    for (auto category_bytes : bytes) {
+      res += category_bytes;
+    }
+    return res;
+  }
+
+  MemoryReport &operator+=(const MemoryReport &other) {
+    for (std::size_t i = 0; i < kMemoryCategoriesCount; ++i) {
+      bytes[i] += other.bytes[i];
+    }
+    return *this;
+  }
+};
+
+/**
+ * @brief Process wide live and peak bytes of allocations made through CountingAllocator
+ */
+class MemoryCounters {
+  struct alignas(64) Counter {
+    std::atomic<std::size_t> current{0};
+    std::atomic<std::size_t> peak{0};
+    std::atomic<std::size_t> allocations{0};
+  };
+
+  std::array<Counter, kMemoryCategoriesCount> counters_;
+
+public:
+  static MemoryCounters &global() {
+    static MemoryCounters counters;
+    return counters;
+  }
+
+  void allocated(MemoryCategory category, std::size_t bytes) {
+    Counter &counter = counters_[static_cast<std::size_t>(category)];
+    std::size_t current =
+        counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    std::size_t peak = counter.peak.load(std::memory_order_relaxed);
+    while (current > peak &&
+           !counter.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+  }
+
+  void deallocated(MemoryCategory category, std::size_t bytes) {
+    counters_[static_cast<std::size_t>(category)].current.fetch_sub(
+        bytes, std::memory_order_relaxed);
+  }
+
+  MemoryReport current() const {
+    MemoryReport res;
+    for (std::size_t i = 0; i < kMemoryCategoriesCount; ++i) {
+      res.bytes[i] = counters_[i].current.load(std::memory_order_relaxed);
+    }
+    return res;
+  }
+
+  MemoryReport peak() const {
+    MemoryReport res;
+    for (std::size_t i = 0; i < kMemoryCategoriesCount; ++i) {
+      res.bytes[i] = counters_[i].peak.load(std::memory_order_relaxed);
+    }
+    return res;
+  }
+
+  std::size_t allocations(MemoryCategory category) const {
+    return counters_[static_cast<std::size_t>(category)].allocations.load(
+        std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Standard allocator which reports its bytes to MemoryCounters::global() under Category
+ */
+template <typename T, MemoryCategory Category>
+struct CountingAllocator {
+  using value_type = T;
+
+  template <typename U> struct rebind {
+    using other = CountingAllocator<U, Category>;
+  };
+
+  CountingAllocator() noexcept = default;
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U, Category> &) noexcept {}
+
+  T *allocate(std::size_t n) {
+    T *ptr = static_cast<T *>(::operator new(n * sizeof(T)));
+    MemoryCounters::global().allocated(Category, n * sizeof(T));
+    return ptr;
+  }
+
+  void deallocate(T *ptr, std::size_t n) noexcept {
+    MemoryCounters::global().deallocated(Category, n * sizeof(T));
+    ::operator delete(ptr);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U, Category> &) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const CountingAllocator<U, Category> &) const noexcept {
+    return false;
+  }
+};
+
+template <typename T, MemoryCategory Category>
+using CountedVector = std::vector<T, CountingAllocator<T, Category>>;
+
+// Sizes of standard containers are estimated from the libstdc++ layout: a hash node
+// holds the next pointer, the value and the cached hash, buckets are pointers.
+// Allocator overhead is not included.
+
+constexpr std::size_t kHashNodeOverhead = sizeof(void *) + sizeof(std::size_t);
+
+template <typename T, typename Allocator>
+std::size_t vector_bytes(const std::vector<T, Allocator> &vec) {
+  return vec.capacity() * sizeof(T);
+}
+
+template <typename Map> std::size_t hash_buckets_bytes(const Map &map) {
+  return map.bucket_count() * sizeof(void *);
+}
+
+/**
+ * @brief Bytes of a vertex id stored in a container.
+ * Ids sharing a refcounted buffer add its bytes only for the copy marked as owner,
+ * so every buffer is accounted once.
+ */
+template <typename Vertex>
+void account_memory(const Vertex & /*vertex*/, MemoryReport &report, bool /*owner*/) {
+  static_assert(std::is_trivially_copyable<Vertex>::value,
+                "Vertex with heap storage needs its own account_memory overload");
+  report[MemoryCategory::Ids] += sizeof(Vertex);
+}
+
+inline void account_memory(const std::string &vertex, MemoryReport &report, bool /*owner*/) {
+  report[MemoryCategory::Ids] += sizeof(std::string);
+  // Every copy owns its buffer, short strings live inside the object
+  if (vertex.capacity() > std::string().capacity()) {
+    report[MemoryCategory::Ids] += vertex.capacity() + 1;
+  }
+}
+
+/**
+ * @brief Bytes of a shortest paths result: vertex -> distance
+ */
+template <typename Vertex>
+MemoryReport memory_usage(const std::unordered_map<Vertex, float> &result) {
+  MemoryReport ids;
+  for (const auto &[vertex, dist] : result) {
+    account_memory(vertex, ids, false);
+  }
+
+  MemoryReport res;
+  res[MemoryCategory::Results] = hash_buckets_bytes(result) +
+                                 result.size() * (kHashNodeOverhead + sizeof(float)) +
+                                 ids.total();
+  return res;
+}
+
+template <typename Vertex>
+MemoryReport memory_usage(const std::vector<std::unordered_map<Vertex, float>> &results) {
+  MemoryReport res;
+  res[MemoryCategory::Results] = vector_bytes(results);
+  for (const auto &result : results) {
+    res += memory_usage(result);
+  }
+  return res;
+}
+
+} // namespace lib
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <library/memory_accounting.h>
+#include <nonstd/string_view.hpp>
+
+namespace lib {
+
+class StringPool;
+
+/**
+ * @brief Handle of a string stored in a StringPool.
+ *
+ * A single pointer to the pool entry, so it is trivially copyable and copies cost nothing.
+ * Length and hash are stored in the entry, so hashing is a load and unequal strings are
+ * mostly told apart without touching their chars. The pool must outlive its handles.
+ */
+struct pooled_string {
+  // Empty string, does not touch any pool
+  pooled_string();
+
+  // Interns the string into StringPool::global(); use a graph owned pool for bulk loading
+  explicit pooled_string(const char *str);
+
+  operator nonstd::string_view() const {
+    return nonstd::string_view(c_str(), size());
+  }
+
+  const char *c_str() const {
+    return reinterpret_cast<const char *>(header_ + 1);
+  }
+
+  std::size_t size() const { return header_->size; }
+
+  std::size_t hash() const { return header_->hash; }
+
+  char operator[](std::size_t i) const { return c_str()[i]; }
+
+  friend bool operator==(const pooled_string &lhs, const pooled_string &rhs) {
+    if (lhs.header_ == rhs.header_) {
+      return true;
+    }
+    // Strings of one pool are unique, so only handles of different pools get to memcmp
+    return lhs.header_->hash == rhs.header_->hash &&
+           lhs.header_->size == rhs.header_->size &&
+           std::memcmp(lhs.c_str(), rhs.c_str(), lhs.size()) == 0;
+  }
+
+  friend bool operator!=(const pooled_string &lhs, const pooled_string &rhs) {
+    return !(lhs == rhs);
+  }
+
+private:
+  friend class StringPool;
+
+  // Chars follow the header in the arena, zero terminated
+  struct alignas(8) Header {
+    std::size_t hash;
+    std::uint32_t size;
+  };
+
+  explicit pooled_string(const Header *header) : header_(header) {}
+
+  const Header *header_;
+};
+
+/**
+ * @brief Interning string storage for vertex ids.
+ *
+ * Strings are copied one after another into large arenas together with their hash and length,
+ * so a million ids take a few allocations instead of a million. Every distinct string is stored
+ * once. The pool frees all arenas at once in the destructor, so handles must not outlive it.
+ * Interning is thread safe.
+ */
+class StringPool {
+  using Header = pooled_string::Header;
+  using Allocator = CountingAllocator<char, MemoryCategory::Ids>;
+
+  struct Arena {
+    char *data;
+    std::size_t size;
+  };
+
+  std::size_t arena_size_;
+  std::vector<Arena> arenas_;
+  char *cursor_ = nullptr;
+  char *arena_end_ = nullptr;
+  // Open addressing table of entries with linear probing, size is a power of two
+  CountedVector<const Header *, MemoryCategory::Indexes> table_;
+  std::size_t size_ = 0;
+  mutable std::mutex mutex_;
+
+  static std::size_t entry_bytes(std::size_t str_size) {
+    std::size_t bytes = sizeof(Header) + str_size + 1;
+    return (bytes + alignof(Header) - 1) / alignof(Header) * alignof(Header);
+  }
+
+  static bool equals(const Header *header, nonstd::string_view str, std::size_t hash) {
+    return header->hash == hash && header->size == str.size() &&
+           std::memcmp(header + 1, str.data(), str.size()) == 0;
+  }
+
+  const Header *store(nonstd::string_view str, std::size_t hash) {
+    std::size_t bytes = entry_bytes(str.size());
+
+    if (cursor_ == nullptr || static_cast<std::size_t>(arena_end_ - cursor_) < bytes) {
+      std::size_t size = std::max(arena_size_, bytes);
+      arenas_.push_back(Arena{Allocator().allocate(size), size});
+      cursor_ = arenas_.back().data;
+      arena_end_ = cursor_ + size;
+    }
+
+    auto *header = new (cursor_) Header{hash, static_cast<std::uint32_t>(str.size())};
+    char *chars = reinterpret_cast<char *>(header + 1);
+    std::memcpy(chars, str.data(), str.size());
+    chars[str.size()] = '\0';
+    cursor_ += bytes;
+    return header;
+  }
+
+  void grow() {
+    decltype(table_) table(std::max<std::size_t>(64, table_.size() * 2), nullptr);
+    std::size_t mask = table.size() - 1;
+
+    for (const Header *header : table_) {
+      if (header != nullptr) {
+        std::size_t slot = header->hash & mask;
+        while (table[slot] != nullptr) {
+          slot = (slot + 1) & mask;
+        }
+        table[slot] = header;
+      }
+    }
+    table_ = std::move(table);
+  }
+
+public:
+  static constexpr std::size_t kDefaultArenaSize = 1 << 20;
+
+  explicit StringPool(std::size_t arena_size = kDefaultArenaSize)
+      : arena_size_(arena_size) {
+    if (arena_size == 0) {
+      throw std::runtime_error("arena_size must be positive");
+    }
+  }
+
+  StringPool(const StringPool &) = delete;
+  StringPool &operator=(const StringPool &) = delete;
+
+  ~StringPool() {
+    for (const auto &arena : arenas_) {
+      Allocator().deallocate(arena.data, arena.size);
+    }
+  }
+
+  /**
+   * @brief Pool for ids created outside of a graph, lives until the program exits
+   */
+  static StringPool &global() {
+    static StringPool pool;
+    return pool;
+  }
+
+  /**
+   * @brief Handle of the stored copy of str; equal strings get the same handle
+   */
+  pooled_string intern(nonstd::string_view str) {
+    if (str.size() > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error("String is too long for the pool");
+    }
+
+    std::size_t hash = std::hash<nonstd::string_view>{}(str);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if ((size_ + 1) * 2 > table_.size()) {
+      grow();
+    }
+
+    std::size_t mask = table_.size() - 1;
+    std::size_t slot = hash & mask;
+
+    while (table_[slot] != nullptr) {
+      if (equals(table_[slot], str, hash)) {
+        return pooled_string(table_[slot]);
+      }
+      slot = (slot + 1) & mask;
+    }
+
+    table_[slot] = store(str, hash);
+    size_++;
+    return pooled_string(table_[slot]);
+  }
+
+  /**
+   * @brief Number of distinct strings
+   */
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+  }
+
+  std::size_t arenas_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return arenas_.size();
+  }
+
+  /**
+   * @brief Arenas are accounted as ids, the dedup table as an index
+   */
+  MemoryReport memory_usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    MemoryReport res;
+    for (const auto &arena : arenas_) {
+      res[MemoryCategory::Ids] += arena.size;
+    }
+    res[MemoryCategory::Indexes] += vector_bytes(table_);
+    return res;
+  }
+};
+
+inline pooled_string::pooled_string() {
+  static const struct {
+    Header header;
+    char chars[1];
+  } empty{{std::hash<nonstd::string_view>{}(nonstd::string_view("", 0)), 0}, {'\0'}};
+  header_ = &empty.header;
+}
+
+inline pooled_string::pooled_string(const char *str)
+    : pooled_string(StringPool::global().intern(str)) {}
+
+} // namespace lib
+
+template <> struct std::hash<lib::pooled_string> {
+  std::size_t operator()(const lib::pooled_string &str) const { return str.hash(); }
+};
@@ -0,0 +1,536 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <algorithms/vertex_order.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+
+namespace detail {
+
+struct PartitionedHeader {
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::uint64_t vertices_count;
+    std::uint64_t edges_count;
+    std::uint64_t cell_vertices;
+    std::uint64_t cells_count;
+    std::uint64_t has_transposed;
+    std::uint64_t fingerprint;
+    std::uint64_t directory_offset;
+    std::uint64_t boundary_offset;
+    std::uint64_t boundary_count;
+    std::uint64_t partitioned_index_offset;
+};
+
+// Cell payload: offsets[vertices + 1], targets[edges], weights[edges], x[vertices], y[vertices],
+// original[vertices], then the same adjacency arrays of the transposed graph
+struct PartitionedCell {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+    std::uint32_t vertices;
+    std::uint32_t edges;
+    std::uint32_t in_edges;
+    std::uint32_t reserved;
+};
+
+constexpr std::uint64_t kPartitionedMagic = 0x31475049534f4947ull;  // "GIOSIPG1"
+constexpr std::uint64_t kPartitionedVersion = 1;
+constexpr std::uint64_t kPartitionedAlignment = 4096;
+
+}  // namespace detail
+
+/**
+ * @brief Write a compiled graph in the partitioned on-disk format read by PartitionedGraph.
+ *
+ * Vertices are renumbered along the hilbert curve and cut into cells of cell_vertices consecutive
+ * vertices, so every cell is a compact piece of the map. Every cell stores its outgoing edges (and
+ * incoming ones if the graph has the transposed adjacency) with global targets, the coordinates
+ * and the index of every vertex in the compiled graph; cells start at page boundaries. The file
+ * ends with the boundary vertex table: vertices of every cell with an edge to or from another cell,
+ * and the partitioned index of every compiled graph vertex.
+ *
+ * @param graph Compiled graph with coordinates
+ * @param path Output file
+ * @param cell_vertices Vertices per cell; a cell takes about (12 + 8 * degree) bytes per vertex
+ */
+template <typename Vertex>
+void write_partitioned_graph(const CompiledGraph<Vertex>& graph, const std::string& path, std::uint32_t cell_vertices = 1 << 14) {
+    using Index = std::uint32_t;
+    if (cell_vertices == 0) {
+        throw std::runtime_error("Partitioned graph cells need at least one vertex");
+    }
+
+    auto order = algorithms::hilbert_order(graph);
+    std::vector<Index> new_index(order.size());
+    for (Index v = 0; v < order.size(); v++) {
+        new_index[order[v]] = v;
+    }
+
+    const size_t count = graph.vertices_count();
+    const size_t cells_count = (count + cell_vertices - 1) / cell_vertices;
+    const bool transposed = graph.has_transposed();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Can not write partitioned graph: " + path);
+    }
+
+    auto write_array = [&out](const auto& vec) {
+        out.write(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(vec[0]));
+    };
+    auto pad = [&out]() {
+        auto pos = static_cast<std::uint64_t>(out.tellp());
+        auto padded = (pos + detail::kPartitionedAlignment - 1) / detail::kPartitionedAlignment * detail::kPartitionedAlignment;
+        std::vector<char> zeros(padded - pos, 0);
+        out.write(zeros.data(), zeros.size());
+        return padded;
+    };
+
+    // Header page is written last
+    std::vector<char> header_page(detail::kPartitionedAlignment, 0);
+    out.write(header_page.data(), header_page.size());
+
+    std::vector<detail::PartitionedCell> directory(cells_count);
+    std::vector<std::uint64_t> boundary_offsets(cells_count + 1, 0);
+    std::vector<Index> boundary;
+    std::vector<Index> offsets, targets, in_offsets, in_sources, original;
+    std::vector<float> weights, xs, ys, in_weights;
+
+    for (size_t cell = 0; cell < cells_count; cell++) {
+        Index first = cell * cell_vertices;
+        Index last = std::min<size_t>(count, first + cell_vertices);
+        offsets.assign(1, 0);
+        in_offsets.assign(1, 0);
+        targets.clear();
+        weights.clear();
+        in_sources.clear();
+        in_weights.clear();
+        xs.clear();
+        ys.clear();
+        original.clear();
+
+        for (Index v = first; v < last; v++) {
+            Index old_v = order[v];
+            bool is_boundary = false;
+            for (Index edge = graph.first_edge(old_v); edge < graph.last_edge(old_v); edge++) {
+                Index u = new_index[graph.target(edge)];
+                targets.push_back(u);
+                weights.push_back(graph.weight(edge));
+                is_boundary |= u < first || u >= last;
+            }
+            offsets.push_back(targets.size());
+
+            if (transposed) {
+                graph.template for_each_edge_id<SearchDirection::Backward>(old_v, [&](Index source, Index edge) {
+                    Index u = new_index[source];
+                    in_sources.push_back(u);
+                    in_weights.push_back(graph.weight(edge));
+                    is_boundary |= u < first || u >= last;
+                });
+                in_offsets.push_back(in_sources.size());
+            }
+
+            xs.push_back(graph.x(old_v));
+            ys.push_back(graph.y(old_v));
+            original.push_back(old_v);
+            if (is_boundary) {
+                boundary.push_back(v);
+            }
+        }
+        boundary_offsets[cell + 1] = boundary.size();
+
+        auto& entry = directory[cell];
+        entry.offset = pad();
+        entry.vertices = last - first;
+        entry.edges = targets.size();
+        entry.in_edges = in_sources.size();
+        write_array(offsets);
+        write_array(targets);
+        write_array(weights);
+        write_array(xs);
+        write_array(ys);
+        write_array(original);
+        if (transposed) {
+            write_array(in_offsets);
+            write_array(in_sources);
+            write_array(in_weights);
+        }
+        entry.bytes = static_cast<std::uint64_t>(out.tellp()) - entry.offset;
+    }
+
+    detail::PartitionedHeader header{};
+    header.magic = detail::kPartitionedMagic;
+    header.version = detail::kPartitionedVersion;
+    header.vertices_count = count;
+    header.edges_count = graph.edges_count();
+    header.cell_vertices = cell_vertices;
+    header.cells_count = cells_count;
+    header.has_transposed = transposed;
+    header.fingerprint = graph.fingerprint();
+    header.directory_offset = pad();
+    write_array(directory);
+    header.boundary_offset = out.tellp();
+    header.boundary_count = boundary.size();
+    write_array(boundary_offsets);
+    write_array(boundary);
+    header.partitioned_index_offset = out.tellp();
+    write_array(new_index);
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) {
+        throw std::runtime_error("Can not write partitioned graph: " + path);
+    }
+}
+
+/**
+ * @brief Graph written by write_partitioned_graph, searched without loading it into memory.
+ *
+ * Opening reads only the header, the cell directory and the boundary table. Cells are mapped
+ * with mmap when a search first touches one of their vertices and unmapped least recently used
+ * first once the mapped cells exceed the memory budget, so memory follows the part of the graph
+ * the searches reach. Vertices are the hilbert positions of the file; partitioned_index() and
+ * original_index() map them to and from the compiled graph, x() and y() give coordinates for
+ * isochrone geometry.
+ *
+ * Cell mappings are a cache inside the object: searches through a const reference still update
+ * it, so one PartitionedGraph must not be shared between threads. Open one per thread, mapped
+ * pages of the same file are shared by the OS.
+ */
+class PartitionedGraph {
+   public:
+    using Index = std::uint32_t;
+    static constexpr Index kInvalidIndex = std::numeric_limits<Index>::max();
+
+    // Edge as read from a cell; cells have no global edge ids
+    struct EdgeRef {
+        float weight;
+    };
+
+   private:
+    struct CellView {
+        const std::uint32_t* offsets;
+        const std::uint32_t* targets;
+        const float* weights;
+        const float* x;
+        const float* y;
+        const std::uint32_t* original;
+        const std::uint32_t* in_offsets;
+        const std::uint32_t* in_sources;
+        const float* in_weights;
+    };
+
+    struct CellSlot {
+        void* mapping = nullptr;
+        size_t mapped_bytes = 0;
+        std::uint64_t last_used = 0;
+        CellView view{};
+    };
+
+    int fd_ = -1;
+    std::string path_;
+    detail::PartitionedHeader header_{};
+    std::vector<detail::PartitionedCell> directory_;
+    std::vector<std::uint64_t> boundary_offsets_;
+    std::vector<Index> boundary_;
+    size_t page_size_ = 0;
+    size_t memory_budget_ = 0;
+
+    mutable std::vector<CellSlot> slots_;
+    mutable std::vector<Index> loaded_;
+    mutable size_t resident_bytes_ = 0;
+    mutable std::uint64_t tick_ = 0;
+    mutable std::uint64_t cell_loads_ = 0;
+    mutable std::uint64_t evictions_ = 0;
+
+    void read_at(void* data, size_t bytes, std::uint64_t offset) const {
+        auto* pos = static_cast<char*>(data);
+        while (bytes > 0) {
+            ssize_t read = ::pread(fd_, pos, bytes, offset);
+            if (read <= 0) {
+                throw std::runtime_error("Can not read partitioned graph: " + path_);
+            }
+            pos += read;
+            bytes -= read;
+            offset += read;
+        }
+    }
+
+    template <typename T>
+    static const T* take(const char*& pos, size_t count) {
+        auto* res = reinterpret_cast<const T*>(pos);
+        pos += count * sizeof(T);
+        return res;
+    }
+
+    void unmap(Index cell) const {
+        auto& slot = slots_[cell];
+        ::munmap(slot.mapping, slot.mapped_bytes);
+        resident_bytes_ -= slot.mapped_bytes;
+        slot.mapping = nullptr;
+        slot.mapped_bytes = 0;
+        evictions_++;
+    }
+
+    void evict_for(size_t bytes) const {
+        while (!loaded_.empty() && resident_bytes_ + bytes > memory_budget_) {
+            auto coldest = std::min_element(loaded_.begin(), loaded_.end(), [this](Index lhs, Index rhs) {
+                return slots_[lhs].last_used < slots_[rhs].last_used;
+            });
+            unmap(*coldest);
+            *coldest = loaded_.back();
+            loaded_.pop_back();
+        }
+    }
+
+    const CellView& load(Index cell) const {
+        auto& slot = slots_[cell];
+        slot.last_used = ++tick_;
+        if (slot.mapping != nullptr) {
+            return slot.view;
+        }
+
+        const auto& entry = directory_[cell];
+        // Map from the page containing the cell start, cells are aligned for the common page size
+        std::uint64_t map_offset = entry.offset / page_size_ * page_size_;
+        size_t bytes = entry.offset - map_offset + entry.bytes;
+        evict_for(bytes);
+
+        void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd_, map_offset);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Can not map partitioned graph cell " + std::to_string(cell) + ": " + path_);
+        }
+        slot.mapping = mapping;
+        slot.mapped_bytes = bytes;
+        resident_bytes_ += bytes;
+        loaded_.push_back(cell);
+        cell_loads_++;
+
+        const char* pos = static_cast<const char*>(mapping) + (entry.offset - map_offset);
+        auto& view = slot.view;
+        view.offsets = take<std::uint32_t>(pos, entry.vertices + 1);
+        view.targets = take<std::uint32_t>(pos, entry.edges);
+        view.weights = take<float>(pos, entry.edges);
+        view.x = take<float>(pos, entry.vertices);
+        view.y = take<float>(pos, entry.vertices);
+        view.original = take<std::uint32_t>(pos, entry.vertices);
+        if (header_.has_transposed) {
+            view.in_offsets = take<std::uint32_t>(pos, entry.vertices + 1);
+            view.in_sources = take<std::uint32_t>(pos, entry.in_edges);
+            view.in_weights = take<float>(pos, entry.in_edges);
+        }
+        return view;
+    }
+
+    void close() {
+        for (auto cell : loaded_) {
+            ::munmap(slots_[cell].mapping, slots_[cell].mapped_bytes);
+        }
+        loaded_.clear();
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+   public:
+    /**
+     * @param path File written by write_partitioned_graph
+     * @param memory_budget Bytes of mapped cells kept before the least recently used are unmapped;
+     * a cell is always mapped while it is read, so a budget below one cell keeps one cell
+     */
+    explicit PartitionedGraph(const std::string& path, size_t memory_budget = size_t(1) << 30)
+        : path_(path), page_size_(::sysconf(_SC_PAGESIZE)), memory_budget_(memory_budget) {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::runtime_error("Can not open partitioned graph: " + path);
+        }
+
+        try {
+            read_at(&header_, sizeof(header_), 0);
+            if (header_.magic != detail::kPartitionedMagic || header_.version != detail::kPartitionedVersion) {
+                throw std::runtime_error("Not a partitioned graph file: " + path);
+            }
+            directory_.resize(header_.cells_count);
+            read_at(directory_.data(), directory_.size() * sizeof(directory_[0]), header_.directory_offset);
+            boundary_offsets_.resize(header_.cells_count + 1);
+            read_at(boundary_offsets_.data(), boundary_offsets_.size() * sizeof(std::uint64_t), header_.boundary_offset);
+            boundary_.resize(header_.boundary_count);
+            read_at(boundary_.data(), boundary_.size() * sizeof(Index),
+                    header_.boundary_offset + boundary_offsets_.size() * sizeof(std::uint64_t));
+        } catch (...) {
+            close();
+            throw;
+        }
+        slots_.resize(header_.cells_count);
+    }
+
+    PartitionedGraph(const PartitionedGraph&) = delete;
+    PartitionedGraph& operator=(const PartitionedGraph&) = delete;
+
+    ~PartitionedGraph() {
+        close();
+    }
+
+    size_t vertices_count() const {
+        return header_.vertices_count;
+    }
+
+    size_t edges_count() const {
+        return header_.edges_count;
+    }
+
+    bool has_transposed() const {
+        return header_.has_transposed;
+    }
+
+    /**
+     * @brief Fingerprint of the compiled graph the file was written from
+     */
+    std::uint64_t fingerprint() const {
+        return header_.fingerprint;
+    }
+
+    size_t cells_count() const {
+        return header_.cells_count;
+    }
+
+    Index cell_of(Index v) const {
+        return v / header_.cell_vertices;
+    }
+
+    /**
+     * @brief Vertices of the cell with edges to or from other cells
+     */
+    std::span<const Index> boundary_vertices(Index cell) const {
+        return std::span<const Index>(boundary_.data() + boundary_offsets_[cell], boundary_.data() + boundary_offsets_[cell + 1]);
+    }
+
+    /**
+     * @brief Call relax(neighbor, EdgeRef) for edges out of v, or into v for Backward, mapping
+     * the cell of v if needed; Backward needs a file with the transposed adjacency
+     */
+    template <SearchDirection Direction, typename Relax>
+    void for_each_edge_id(Index v, Relax&& relax) const {
+        const auto& cell = load(cell_of(v));
+        Index local = v % header_.cell_vertices;
+        if constexpr (Direction == SearchDirection::Forward) {
+            for (Index edge = cell.offsets[local]; edge < cell.offsets[local + 1]; edge++) {
+                relax(cell.targets[edge], EdgeRef{cell.weights[edge]});
+            }
+        } else {
+            for (Index edge = cell.in_offsets[local]; edge < cell.in_offsets[local + 1]; edge++) {
+                relax(cell.in_sources[edge], EdgeRef{cell.in_weights[edge]});
+            }
+        }
+    }
+
+    /**
+     * @brief Call relax(neighbor, weight) for edges out of v, or into v for Backward
+     */
+    template <SearchDirection Direction, typename Relax>
+    void for_each_edge(Index v, Relax&& relax) const {
+        for_each_edge_id<Direction>(v, [&](Index u, EdgeRef edge) {
+            relax(u, edge.weight);
+        });
+    }
+
+    /**
+     * @brief Throws std::runtime_error if a search in the direction can not run on this graph
+     */
+    void check_direction(SearchDirection direction) const {
+        if (direction == SearchDirection::Backward && !has_transposed()) {
+            throw std::runtime_error("Backward search needs the transposed graph, write a graph with it");
+        }
+    }
+
+    /**
+     * @brief Vertex of a compiled graph vertex index, read from the file without mapping cells
+     */
+    Index partitioned_index(Index original) const {
+        if (original >= vertices_count()) {
+            throw std::out_of_range("Vertex index out of range: " + std::to_string(original));
+        }
+        Index res = kInvalidIndex;
+        read_at(&res, sizeof(res), header_.partitioned_index_offset + original * sizeof(Index));
+        return res;
+    }
+
+    /**
+     * @brief Index of the vertex in the compiled graph the file was written from
+     */
+    Index original_index(Index v) const {
+        return load(cell_of(v)).original[v % header_.cell_vertices];
+    }
+
+    float x(Index v) const {
+        return load(cell_of(v)).x[v % header_.cell_vertices];
+    }
+
+    float y(Index v) const {
+        return load(cell_of(v)).y[v % header_.cell_vertices];
+    }
+
+    /**
+     * @brief Bytes of cells mapped now
+     */
+    size_t resident_bytes() const {
+        return resident_bytes_;
+    }
+
+    size_t loaded_cells_count() const {
+        return loaded_.size();
+    }
+
+    /**
+     * @brief Cells mapped since the graph was opened
+     */
+    std::uint64_t cell_loads() const {
+        return cell_loads_;
+    }
+
+    /**
+     * @brief Cells unmapped since the graph was opened, by the budget or evict_all()
+     */
+    std::uint64_t evictions() const {
+        return evictions_;
+    }
+
+    /**
+     * @brief Unmap all cells
+     */
+    void evict_all() {
+        while (!loaded_.empty()) {
+            unmap(loaded_.back());
+            loaded_.pop_back();
+        }
+    }
+
+    /**
+     * @brief Bytes by category: mapped cells as topology, the directory and boundary table as indexes
+     */
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Topology] += resident_bytes_;
+        res[lib::MemoryCategory::Indexes] += lib::vector_bytes(directory_) + lib::vector_bytes(boundary_offsets_) +
+                                             lib::vector_bytes(boundary_) + lib::vector_bytes(slots_) +
+                                             lib::vector_bytes(loaded_);
+        return res;
+    }
+};
+
+}  // namespace graph
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <compiled_graph.h>
+#include <library/memory_accounting.h>
+
+namespace graph {
+
+enum class QuantizationOverflow {
+    // Weights above the largest integer are an error
+    Throw,
+    // Weights above the largest integer are clamped to it, distances through them get shorter
+    Saturate,
+};
+
+/**
+ * @brief Integer units of quantized weights: a weight becomes round(weight / unit) units,
+ * e.g. unit 0.1 keeps travel times in seconds with decisecond resolution
+ */
+struct Quantization {
+    float unit = 1;
+    QuantizationOverflow overflow = QuantizationOverflow::Throw;
+};
+
+/**
+ * @brief Edge weights of a CompiledGraph as integers in a fixed unit, indexed by forward edge id
+ * like the float weights, so both directions read them.
+ *
+ * uint16_t halves the weight bandwidth of a search compared to float and integer keys allow
+ * bucket queues (DialQueue). Rounding changes a distance over k edges by at most k * unit / 2.
+ * Search distances are uint32_t units, searches must stay below 2^32 units.
+ */
+template <typename Int = std::uint16_t>
+class QuantizedWeights {
+    static_assert(std::is_unsigned_v<Int> && sizeof(Int) <= sizeof(std::uint32_t), "Quantized weights are uint8_t, uint16_t or uint32_t");
+
+   public:
+    using Index = std::uint32_t;
+    static constexpr Int kMaxWeight = std::numeric_limits<Int>::max();
+
+   private:
+    lib::CountedVector<Int, lib::MemoryCategory::Weights> weights_;
+    Quantization quantization_;
+    Int max_weight_ = 0;
+    size_t saturated_count_ = 0;
+
+   public:
+    QuantizedWeights() = default;
+    QuantizedWeights(const QuantizedWeights&) = delete;
+    QuantizedWeights(QuantizedWeights&&) = default;
+
+    /**
+     * @param graph Compiled graph with non-negative weights
+     * @param quantization Unit and overflow handling
+     */
+    template <typename Vertex>
+    explicit QuantizedWeights(const CompiledGraph<Vertex>& graph, Quantization quantization = {})
+        : quantization_(quantization) {
+        if (!(quantization.unit > 0) || !std::isfinite(quantization.unit)) {
+            throw std::runtime_error("Quantization unit must be positive: " + std::to_string(quantization.unit));
+        }
+
+        weights_.resize(graph.edges_count());
+        for (Index edge = 0; edge < graph.edges_count(); edge++) {
+            float weight = graph.weight(edge);
+            if (!(weight >= 0)) {
+                throw std::runtime_error("Can not quantize negative weight: " + std::to_string(weight));
+            }
+
+            double units = std::round(static_cast<double>(weight) / quantization.unit);
+            if (units > kMaxWeight) {
+                if (quantization.overflow == QuantizationOverflow::Throw) {
+                    throw std::runtime_error("Weight " + std::to_string(weight) + " does not fit into " +
+                                             std::to_string(kMaxWeight) + " units of " +
+                                             std::to_string(quantization.unit));
+                }
+                units = kMaxWeight;
+                saturated_count_++;
+            }
+            weights_[edge] = static_cast<Int>(units);
+            max_weight_ = std::max(max_weight_, weights_[edge]);
+        }
+    }
+
+    Int operator[](Index edge) const {
+        return weights_[edge];
+    }
+
+    size_t size() const {
+        return weights_.size();
+    }
+
+    float unit() const {
+        return quantization_.unit;
+    }
+
+    Int max_weight() const {
+        return max_weight_;
+    }
+
+    /**
+     * @brief Number of weights clamped by QuantizationOverflow::Saturate
+     */
+    size_t saturated_count() const {
+        return saturated_count_;
+    }
+
+    float to_weight(std::uint32_t units) const {
+        return static_cast<float>(static_cast<double>(units) * quantization_.unit);
+    }
+
+    lib::MemoryReport memory_usage() const {
+        lib::MemoryReport res;
+        res[lib::MemoryCategory::Weights] += lib::vector_bytes(weights_);
+        return res;
+    }
+};
+
+}  // namespace graph
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <compiled_graph.h>
+#include <graph.h>
+
+namespace graph {
+
+/**
+ * @brief Graph with chains of degree-2 vertices merged into single edges.
+ *
+ * A vertex is a chain vertex if it only passes traffic through: one incoming and one outgoing
+ * edge from and to different vertices (one-way street), or edges to and from the same two
+ * vertices (two-way street). Chains between the remaining vertices become edges with the summed
+ * weight, so distances between remaining vertices do not change up to float rounding. Every chain
+ * keeps its intermediate vertices with their distances from the chain start for interpolation
+ * along the edge and to expand search results back to all vertices.
+ *
+ * Searches have to start from remaining vertices, pass vertices used as sources in keep.
+ * Rings made of chain vertices only keep one of their vertices.
+ */
+template <typename Vertex>
+class SimplifiedGraph {
+   public:
+    struct Chain {
+        Vertex head;
+        Vertex tail;
+        float weight;
+        // Intermediate vertices in [first, last) of chain_vertices and chain_offsets
+        std::uint32_t first;
+        std::uint32_t last;
+    };
+
+   private:
+    using Index = typename CompiledGraph<Vertex>::Index;
+
+    Graph<Vertex> graph_;
+    size_t original_vertices_count_ = 0;
+    std::vector<Chain> chains_;
+    std::vector<Vertex> chain_vertices_;
+    std::vector<float> chain_offsets_;
+    // Chains starting at a vertex are consecutive in chains_
+    std::unordered_map<Vertex, std::pair<std::uint32_t, std::uint32_t>> chains_by_head_;
+
+    static bool is_chain_vertex(const CompiledGraph<Vertex>& graph, Index v) {
+        Index in_degree = graph.last_in_edge(v) - graph.first_in_edge(v);
+        Index out_degree = graph.out_degree(v);
+
+        if (in_degree == 1 && out_degree == 1) {
+            Index source = graph.in_source(graph.first_in_edge(v));
+            Index target = graph.target(graph.first_edge(v));
+            return source != target && source != v && target != v;
+        }
+        if (in_degree == 2 && out_degree == 2) {
+            Index first = graph.target(graph.first_edge(v));
+            Index second = graph.target(graph.first_edge(v) + 1);
+            Index first_source = graph.in_source(graph.first_in_edge(v));
+            Index second_source = graph.in_source(graph.first_in_edge(v) + 1);
+            bool same_neighbors = (first == first_source && second == second_source) ||
+                                  (first == second_source && second == first_source);
+            return same_neighbors && first != v && second != v;
+        }
+        return false;
+    }
+
+    // Next vertex of a chain entered from prev; two-way chain vertices go on to the other neighbor
+    static Index chain_next(const CompiledGraph<Vertex>& graph, Index v, Index prev) {
+        Index next = graph.target(graph.first_edge(v));
+        if (graph.out_degree(v) == 2 && next == prev) {
+            next = graph.target(graph.first_edge(v) + 1);
+        }
+        return next;
+    }
+
+   public:
+    SimplifiedGraph() = default;
+    SimplifiedGraph(const SimplifiedGraph&) = delete;
+    SimplifiedGraph(SimplifiedGraph&&) = default;
+
+    /**
+     * @param graph Original graph
+     * @param keep Vertices which must stay in the simplified graph, e.g. search sources
+     */
+    explicit SimplifiedGraph(const Graph<Vertex>& graph, const std::unordered_set<Vertex>& keep = {}) {
+        CompiledGraph<Vertex> compiled(graph, true);
+        const size_t count = compiled.vertices_count();
+        original_vertices_count_ = count;
+
+        std::vector<bool> kept(count);
+        for (Index v = 0; v < count; v++) {
+            kept[v] = !is_chain_vertex(compiled, v) || keep.contains(compiled.vertex(v));
+        }
+
+        std::unordered_map<Vertex, std::unordered_map<Vertex, float>> weights;
+        std::vector<bool> visited(count, false);
+
+        auto add_edge = [&weights](const Vertex& from, const Vertex& to, float weight) {
+            auto [it, inserted] = weights[from].emplace(to, weight);
+            if (!inserted) {
+                it->second = std::min(it->second, weight);
+            }
+        };
+
+        auto contract_from = [&](Index head) {
+            const Vertex& head_vertex = compiled.vertex(head);
+            auto first_chain = static_cast<std::uint32_t>(chains_.size());
+            weights[head_vertex];
+
+            for (auto edge = compiled.first_edge(head); edge < compiled.last_edge(head); edge++) {
+                Index v = compiled.target(edge);
+                if (kept[v]) {
+                    add_edge(head_vertex, compiled.vertex(v), compiled.weight(edge));
+                    continue;
+                }
+
+                // Offsets are summed in double so long chains do not drift from the edge sums
+                double offset = compiled.weight(edge);
+                Index prev = head;
+                Chain chain{head_vertex, head_vertex, 0, static_cast<std::uint32_t>(chain_vertices_.size()), 0};
+
+                while (!kept[v]) {
+                    visited[v] = true;
+                    chain_vertices_.push_back(compiled.vertex(v));
+                    chain_offsets_.push_back(offset);
+
+                    Index next = chain_next(compiled, v, prev);
+                    for (auto next_edge = compiled.first_edge(v); next_edge < compiled.last_edge(v); next_edge++) {
+                        if (compiled.target(next_edge) == next) {
+                            offset += compiled.weight(next_edge);
+                        }
+                    }
+                    prev = v;
+                    v = next;
+                }
+
+                chain.tail = compiled.vertex(v);
+                chain.weight = offset;
+                chain.last = chain_vertices_.size();
+                chains_.push_back(chain);
+                if (v != head) {
+                    add_edge(head_vertex, chain.tail, chain.weight);
+                }
+            }
+
+            if (chains_.size() > first_chain) {
+                chains_by_head_.emplace(head_vertex, std::make_pair(first_chain, static_cast<std::uint32_t>(chains_.size())));
+            }
+        };
+
+        for (Index v = 0; v < count; v++) {
+            if (kept[v]) {
+                contract_from(v);
+            }
+        }
+        // Rings of chain vertices are not reachable from kept vertices, one vertex of every ring stays
+        for (Index v = 0; v < count; v++) {
+            if (!kept[v] && !visited[v]) {
+                kept[v] = true;
+                contract_from(v);
+            }
+        }
+
+        graph_ = Graph<Vertex>(std::move(weights), graph.get_string_pool());
+    }
+
+    /**
+     * @brief Simplified graph for searches; compile it for the fast engines
+     */
+    const Graph<Vertex>& graph() const {
+        return graph_;
+    }
+
+    size_t original_vertices_count() const {
+        return original_vertices_count_;
+    }
+
+    size_t vertices_count() const {
+        return graph_.get_weights().size();
+    }
+
+    bool contains(const Vertex& vertex) const {
+        return graph_.get_weights().contains(vertex);
+    }
+
+    const std::vector<Chain>& chains() const {
+        return chains_;
+    }
+
+    /**
+     * @brief Chains starting at the vertex, empty for vertices without them
+     */
+    std::span<const Chain> chains_from(const Vertex& vertex) const {
+        auto it = chains_by_head_.find(vertex);
+        if (it == chains_by_head_.end()) {
+            return {};
+        }
+        return std::span<const Chain>(chains_.data() + it->second.first, chains_.data() + it->second.second);
+    }
+
+    /**
+     * @brief Intermediate vertices of the chain from head to tail
+     */
+    std::span<const Vertex> chain_vertices(const Chain& chain) const {
+        return std::span<const Vertex>(chain_vertices_.data() + chain.first, chain_vertices_.data() + chain.last);
+    }
+
+    /**
+     * @brief Distances of the intermediate vertices from the chain head, increasing
+     */
+    std::span<const float> chain_offsets(const Chain& chain) const {
+        return std::span<const float>(chain_offsets_.data() + chain.first, chain_offsets_.data() + chain.last);
+    }
+
+    /**
+     * @brief Add intermediate chain vertices to the result of a search on the simplified graph.
+     * A vertex gets the distance through the nearest reached chain head; like in the search,
+     * vertices whose distance does not pass cutoff are left out.
+     *
+     * @param dists Distances from a forward search on graph()
+     * @param cutoff Cutoff of the search
+     * @return Distances of the original vertices
+     */
+    template <typename Cutoff>
+    std::unordered_map<Vertex, float> expand(const std::unordered_map<Vertex, float>& dists, Cutoff&& cutoff) const {
+        std::unordered_map<Vertex, float> res(dists);
+
+        for (const auto& [head, dist] : dists) {
+            for (const auto& chain : chains_from(head)) {
+                auto vertices = chain_vertices(chain);
+                auto offsets = chain_offsets(chain);
+
+                for (size_t i = 0; i < vertices.size(); i++) {
+                    float chain_dist = dist + offsets[i];
+                    if (!cutoff(chain_dist)) {
+                        break;
+                    }
+                    auto [it, inserted] = res.emplace(vertices[i], chain_dist);
+                    if (!inserted) {
+                        it->second = std::min(it->second, chain_dist);
+                    }
+                }
+            }
+        }
+        return res;
+    }
+};
+
+}  // namespace graph
@@ -1,36 +1,319 @@
 #include <cstddef>
+#include <fstream>
+#include <limits>
+#include <memory>
 #include <numeric>
+#include <optional>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <algorithms/connected_components.h>
+#include <algorithms/query_scheduler.h>
+#include <algorithms/shortest_paths/async_dijkstra.h>
 #include <algorithms/shortest_paths/dijkstra_algorithm.h>
+#include <algorithms/shortest_paths/distance_matrix.h>
+#include <algorithms/shortest_paths/landmarks.h>
+#include <algorithms/shortest_paths/point_to_point.h>
+#include <algorithms/shortest_paths/quantized_dijkstra.h>
+#include <algorithms/shortest_paths/search_stats.h>
 #include <geo_utils/geohash.h>
+#include <library/memory_accounting.h>
 #include <unordered_map>
 #include <string>
 #include <vector>
 #include <graph.h>
+#include <compiled_graph.h>
+#include <quantized_weights.h>
+#include <simplified_graph.h>
+#include <unordered_set>
 #include <iostream>
 #include <algorithms/parallel.h>
+#include <algorithms/spatial_join.h>
+#include <algorithms/thread_pool.h>
+#include <algorithms/thread_pool_telemetry.h>
+#include <geos/geom/GeometryFactory.h>
+#include <geos/io/WKTReader.h>
+
+namespace py = pybind11;
 
 using WeightsMap = std::unordered_map<std::string, std::unordered_map<std::string, float>>;
 using SingleSourceDijkstraReturn = std::unordered_map<std::string, float>;
 using MultiSourceDijkstraReturn = std::vector<std::unordered_map<std::string, float>>;
 
-SingleSourceDijkstraReturn single_source_dijkstra(WeightsMap weights, std::string start, float dist_cutoff) {
+SingleSourceDijkstraReturn single_source_dijkstra(WeightsMap weights, std::string start, float dist_cutoff, bool reverse) {
     graph::Graph<std::string> graph(std::move(weights));
     auto cutoff_func = [dist_cutoff](float dist) {
         return dist <= dist_cutoff;
     };
+    if (reverse) {
+        graph::CompiledGraph<std::string> compiled(graph, true);
+        return graph::algorithms::single_source_dijkstra(compiled, start, cutoff_func, graph::SearchDirection::Backward);
+    }
     return graph::algorithms::single_source_dijkstra(graph, start, cutoff_func);
 }
 
-MultiSourceDijkstraReturn multi_source_dijkstra(WeightsMap weights, std::vector<std::string> start_vec, float dist_cutoff, int n_threads) {
+MultiSourceDijkstraReturn multi_source_dijkstra(WeightsMap weights, std::vector<std::string> start_vec, float dist_cutoff, int n_threads, bool reverse, float unit) {
     graph::Graph<std::string> graph(std::move(weights));
     auto cutoff_func = [dist_cutoff](float dist) {
         return dist <= dist_cutoff;
     };
+    if (unit > 0) {
+        graph::CompiledGraph<std::string> compiled(graph, reverse);
+        graph::QuantizedWeights<std::uint16_t> quantized(compiled, {unit});
+        auto direction = reverse ? graph::SearchDirection::Backward : graph::SearchDirection::Forward;
+        return graph::algorithms::multi_source_quantized_dijkstra(compiled, quantized, start_vec, n_threads, cutoff_func, direction);
+    }
+    if (reverse) {
+        graph::CompiledGraph<std::string> compiled(graph, true);
+        return graph::algorithms::multi_source_dijkstra(compiled, start_vec, n_threads, cutoff_func, graph::SearchDirection::Backward);
+    }
     return graph::algorithms::multi_source_dijkstra(graph, start_vec, n_threads, cutoff_func);
 }
 
+std::vector<float> point_to_point_distances(
+    WeightsMap weights,
+    const std::vector<std::pair<std::string, std::string>>& pairs,
+    int n_threads
+) {
+    graph::Graph<std::string> graph(std::move(weights));
+    graph::CompiledGraph<std::string> compiled(graph, true);
+    graph::algorithms::ThreadPool pool(n_threads);
+    py::gil_scoped_release release;
+
+    graph::algorithms::PointToPointEngine<std::string> engine(compiled);
+    return engine.distances(pairs, pool);
+}
+
+py::array_t<float> distance_matrix(
+    WeightsMap weights,
+    const std::vector<std::string>& sources,
+    const std::vector<std::string>& targets,
+    int n_threads,
+    float max_distance,
+    bool reverse
+) {
+    graph::Graph<std::string> graph(std::move(weights));
+    graph::CompiledGraph<std::string> compiled(graph, reverse);
+    auto to_indices = [&compiled](const std::vector<std::string>& vertices) {
+        std::vector<std::uint32_t> res;
+        res.reserve(vertices.size());
+        for (const auto& vertex : vertices) {
+            res.push_back(compiled.index(vertex));
+        }
+        return res;
+    };
+    auto source_indices = to_indices(sources);
+    auto target_indices = to_indices(targets);
+
+    // Rows are written straight into the numpy buffer
+    py::array_t<float> res({static_cast<py::ssize_t>(sources.size()), static_cast<py::ssize_t>(targets.size())});
+    float* res_ptr = res.mutable_data();
+    {
+        py::gil_scoped_release release;
+        graph::algorithms::ThreadPool pool(n_threads);
+        auto direction = reverse ? graph::SearchDirection::Backward : graph::SearchDirection::Forward;
+        graph::algorithms::distance_matrix(compiled, source_indices, target_indices, res_ptr, max_distance, direction, pool);
+    }
+    return res;
+}
+
+graph::algorithms::Components string_graph_components(
+    const graph::CompiledGraph<std::string>& compiled,
+    bool strong,
+    int n_threads
+) {
+    py::gil_scoped_release release;
+    graph::algorithms::ThreadPool pool(n_threads);
+    auto connectivity = strong ? graph::algorithms::Connectivity::Strong : graph::algorithms::Connectivity::Weak;
+    return graph::algorithms::connected_components(compiled, connectivity, pool);
+}
+
+py::tuple connected_components(WeightsMap weights, bool strong, int n_threads) {
+    graph::Graph<std::string> graph(std::move(weights));
+    graph::CompiledGraph<std::string> compiled(graph, strong);
+    auto components = string_graph_components(compiled, strong, n_threads);
+
+    std::unordered_map<std::string, std::uint32_t> component_of;
+    component_of.reserve(compiled.vertices_count());
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+        component_of.emplace(compiled.vertex(v), components.component_of[v]);
+    }
+    py::list stats;
+    for (const auto& component : components.stats) {
+        py::dict item;
+        item["vertices"] = component.vertices;
+        item["edges"] = component.edges;
+        stats.append(item);
+    }
+    return py::make_tuple(component_of, stats);
+}
+
+WeightsMap prune_components(WeightsMap weights, size_t min_size, bool strong, int n_threads) {
+    graph::Graph<std::string> graph(std::move(weights));
+    graph::CompiledGraph<std::string> compiled(graph, strong);
+    auto components = string_graph_components(compiled, strong, n_threads);
+    auto pruned = min_size == 0 ? graph::algorithms::keep_largest_component(compiled, components)
+                                : graph::algorithms::keep_components(compiled, components, min_size);
+
+    WeightsMap res;
+    res.reserve(pruned.vertices_count());
+    for (std::uint32_t v = 0; v < pruned.vertices_count(); v++) {
+        auto& neighbors = res[pruned.vertex(v)];
+        for (auto edge = pruned.first_edge(v); edge < pruned.last_edge(v); edge++) {
+            neighbors.emplace(pruned.vertex(pruned.target(edge)), pruned.weight(edge));
+        }
+    }
+    return res;
+}
+
+py::tuple simplify_graph(WeightsMap weights, const std::vector<std::string>& keep) {
+    graph::Graph<std::string> graph(std::move(weights));
+    graph::SimplifiedGraph<std::string> simplified(graph, std::unordered_set<std::string>(keep.begin(), keep.end()));
+
+    py::list chains;
+    for (const auto& chain : simplified.chains()) {
+        auto vertices = simplified.chain_vertices(chain);
+        auto offsets = simplified.chain_offsets(chain);
+        chains.append(py::make_tuple(
+            chain.head,
+            chain.tail,
+            chain.weight,
+            std::vector<std::string>(vertices.begin(), vertices.end()),
+            std::vector<float>(offsets.begin(), offsets.end())
+        ));
+    }
+    return py::make_tuple(simplified.graph().get_weights(), chains);
+}
+
+py::dict search_stats_to_dict(const graph::algorithms::SearchStats& stats) {
+    py::dict res;
+    res["queries"] = stats.queries;
+    res["settled_nodes"] = stats.settled_nodes;
+    res["relaxed_edges"] = stats.relaxed_edges;
+    res["heap_pushes"] = stats.heap_pushes;
+    res["stale_pops"] = stats.stale_pops;
+    res["peak_heap_size"] = stats.peak_heap_size;
+    res["elapsed_seconds"] = stats.elapsed_seconds;
+    return res;
+}
+
+py::list search_stats_to_list(const std::vector<graph::algorithms::SearchStats>& stats_vec) {
+    py::list res;
+    for (const auto& stats : stats_vec) {
+        res.append(search_stats_to_dict(stats));
+    }
+    return res;
+}
+
+py::tuple single_source_dijkstra_with_stats(WeightsMap weights, std::string start, float dist_cutoff) {
+    graph::Graph<std::string> graph(std::move(weights));
+    auto cutoff_func = [dist_cutoff](float dist) {
+        return dist <= dist_cutoff;
+    };
+    graph::algorithms::SearchStats stats;
+    auto res = graph::algorithms::single_source_dijkstra(graph, start, cutoff_func, stats);
+    return py::make_tuple(res, search_stats_to_dict(stats));
+}
+
+py::tuple multi_source_dijkstra_with_stats(WeightsMap weights, std::vector<std::string> start_vec, float dist_cutoff, int n_threads) {
+    graph::Graph<std::string> graph(std::move(weights));
+    auto cutoff_func = [dist_cutoff](float dist) {
+        return dist <= dist_cutoff;
+    };
+    graph::algorithms::BatchSearchStats stats;
+    auto res = graph::algorithms::multi_source_dijkstra(graph, start_vec, n_threads, cutoff_func, stats);
+    return py::make_tuple(res, search_stats_to_list(stats.per_query), search_stats_to_list(stats.per_thread));
+}
+
+py::dict pool_telemetry_to_dict(const graph::algorithms::PoolTelemetry& telemetry) {
+    py::list workers;
+    for (const auto& worker : telemetry.workers) {
+        py::dict worker_dict;
+        worker_dict["tasks"] = worker.tasks;
+        worker_dict["steals"] = worker.steals;
+        worker_dict["busy_seconds"] = worker.busy_seconds;
+        worker_dict["idle_seconds"] = worker.idle_seconds;
+        worker_dict["longest_task_seconds"] = worker.longest_task_seconds;
+        worker_dict["queue_wait_seconds"] = worker.queue_wait_seconds;
+        worker_dict["max_queue_wait_seconds"] = worker.max_queue_wait_seconds;
+        workers.append(worker_dict);
+    }
+
+    py::dict res;
+    res["wall_seconds"] = telemetry.wall_seconds;
+    res["utilization"] = telemetry.utilization();
+    res["imbalance"] = telemetry.imbalance();
+    res["workers"] = workers;
+    return res;
+}
+
+void write_trace_file(const std::string& trace_path, const std::vector<graph::algorithms::TraceEvent>& trace) {
+    std::ofstream out(trace_path);
+    if (!out) {
+        throw std::runtime_error("Can not open trace file: " + trace_path);
+    }
+    graph::algorithms::write_chrome_trace(out, trace);
+}
+
+py::tuple multi_source_dijkstra_with_telemetry(
+    WeightsMap weights,
+    std::vector<std::string> start_vec,
+    float dist_cutoff,
+    int n_threads,
+    const std::string& trace_path
+) {
+    graph::Graph<std::string> graph(std::move(weights));
+    auto cutoff_func = [dist_cutoff](float dist) {
+        return dist <= dist_cutoff;
+    };
+    graph::algorithms::PoolTelemetry telemetry;
+    std::vector<graph::algorithms::TraceEvent> trace;
+    auto res = graph::algorithms::multi_source_dijkstra(graph, start_vec, n_threads, cutoff_func, telemetry, trace);
+
+    if (!trace_path.empty()) {
+        write_trace_file(trace_path, trace);
+    }
+    return py::make_tuple(res, pool_telemetry_to_dict(telemetry));
+}
+
+py::dict shared_pool_telemetry() {
+    return pool_telemetry_to_dict(graph::algorithms::ThreadPool::shared().telemetry());
+}
+
+void reset_shared_pool_telemetry() {
+    graph::algorithms::ThreadPool::shared().reset_telemetry();
+}
+
+void start_shared_pool_trace() {
+    graph::algorithms::ThreadPool::shared().start_trace();
+}
+
+void stop_shared_pool_trace(const std::string& trace_path) {
+    write_trace_file(trace_path, graph::algorithms::ThreadPool::shared().stop_trace());
+}
+
+py::dict memory_report_to_dict(const lib::MemoryReport& report) {
+    py::dict res;
+    for (size_t category = 0; category < lib::kMemoryCategoriesCount; category++) {
+        res[lib::memory_category_name(static_cast<lib::MemoryCategory>(category))] = report.bytes[category];
+    }
+    res["total"] = report.total();
+    return res;
+}
+
+py::dict graph_memory_usage(WeightsMap weights) {
+    graph::Graph<std::string> graph(std::move(weights));
+    return memory_report_to_dict(graph.memory_usage());
+}
+
+py::dict allocator_memory_usage() {
+    const auto& counters = lib::MemoryCounters::global();
+    py::dict res;
+    res["current"] = memory_report_to_dict(counters.current());
+    res["peak"] = memory_report_to_dict(counters.peak());
+    return res;
+}
+
 std::vector<std::string> ghash_encode(std::vector<double>& lon_vec, std::vector<double>& lat_vec, int n_threads = 1) {
     std::vector<size_t> point_idx_vec(lon_vec.size());
     auto task = [&lat_vec, &lon_vec](size_t point_idx, int thread_num) {
@@ -45,12 +328,197 @@ std::vector<std::string> ghash_encode(std::vector<double>& lon_vec, std::vector<
     return res;
 }
 
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Hand the vector over to numpy without copying
+template <typename T>
+py::array_t<T> to_numpy(std::vector<T>&& vec) {
+    auto* data = new std::vector<T>(std::move(vec));
+    py::capsule owner(data, [](void* ptr) { delete reinterpret_cast<std::vector<T>*>(ptr); });
+    return py::array_t<T>(data->size(), data->data(), owner);
+}
+
+void check_points(const DoubleArray& lon_arr, const DoubleArray& lat_arr) {
+    if (lon_arr.ndim() != 1 || lat_arr.ndim() != 1 || lon_arr.size() != lat_arr.size()) {
+        throw std::runtime_error("lon and lat must be 1d arrays of equal size");
+    }
+}
+
+graph::algorithms::PolygonIndex make_polygon_index(const std::vector<std::string>& polygons_wkt) {
+    auto geometry_factory = geos::geom::GeometryFactory::create();
+    geos::io::WKTReader wkt_reader(*geometry_factory);
+    std::vector<graph::algorithms::PreparedMultiPolygon> polygons;
+    polygons.reserve(polygons_wkt.size());
+
+    for (const auto& wkt : polygons_wkt) {
+        auto geometry = wkt_reader.read(wkt);
+        polygons.emplace_back(geometry.get());
+    }
+
+    return graph::algorithms::PolygonIndex(std::move(polygons));
+}
+
+py::tuple polygon_index_join(const graph::algorithms::PolygonIndex& index, DoubleArray lon_arr, DoubleArray lat_arr) {
+    check_points(lon_arr, lat_arr);
+    graph::algorithms::SpatialJoinResult res;
+    {
+        py::gil_scoped_release release;
+        res = index.join(lon_arr.data(), lat_arr.data(), lon_arr.size());
+    }
+    return py::make_tuple(to_numpy(std::move(res.point_ids)), to_numpy(std::move(res.polygon_ids)));
+}
+
+py::array_t<std::int64_t> polygon_index_assign(const graph::algorithms::PolygonIndex& index, DoubleArray lon_arr, DoubleArray lat_arr) {
+    check_points(lon_arr, lat_arr);
+    py::array_t<std::int64_t> res(lon_arr.size());
+    std::int64_t* res_ptr = res.mutable_data();
+    {
+        py::gil_scoped_release release;
+        index.assign(lon_arr.data(), lat_arr.data(), lon_arr.size(), res_ptr);
+    }
+    return res;
+}
+
+// Graph and query engine kept between submissions; results come back as concurrent.futures.Future
+class AsyncDijkstraService {
+   public:
+    AsyncDijkstraService(WeightsMap weights, int n_threads)
+        : compiled_(graph::Graph<std::string>(std::move(weights)), true) {
+        if (n_threads > 0) {
+            pool_ = std::make_unique<graph::algorithms::ThreadPool>(n_threads);
+        }
+        engine_ = std::make_unique<graph::algorithms::AsyncDijkstra<std::string>>(
+            compiled_, pool_ ? *pool_ : graph::algorithms::ThreadPool::shared()
+        );
+    }
+
+    ~AsyncDijkstraService() {
+        // Finishing queries take the GIL to resolve their futures
+        py::gil_scoped_release release;
+        engine_.reset();
+        pool_.reset();
+    }
+
+    py::object submit(const std::string& start, float dist_cutoff, int priority, bool reverse) {
+        py::object future = py::module_::import("concurrent.futures").attr("Future")();
+        // The last reference may go in a worker thread, it is dropped under the GIL
+        std::shared_ptr<py::object> shared_future(new py::object(future), [](py::object* ptr) {
+            py::gil_scoped_acquire acquire;
+            delete ptr;
+        });
+
+        auto on_done = [shared_future](const graph::algorithms::QueryFuture<SingleSourceDijkstraReturn>& query) {
+            py::gil_scoped_acquire acquire;
+            auto& result = *shared_future;
+            try {
+                // Cancelled from Python
+                if (result.attr("done")().cast<bool>()) {
+                    return;
+                }
+                try {
+                    result.attr("set_result")(py::cast(query.get()));
+                } catch (const graph::algorithms::QueryCancelled&) {
+                    result.attr("cancel")();
+                } catch (const std::exception& e) {
+                    result.attr("set_exception")(py::module_::import("builtins").attr("RuntimeError")(e.what()));
+                }
+            } catch (py::error_already_set& e) {
+                e.discard_as_unraisable("AsyncDijkstra result");
+            }
+        };
+
+        auto direction = reverse ? graph::SearchDirection::Backward : graph::SearchDirection::Forward;
+        auto query = engine_->submit(start, dist_cutoff, priority, direction, on_done);
+        future.attr("add_done_callback")(py::cpp_function([query](py::object done) {
+            if (done.attr("cancelled")().cast<bool>()) {
+                query.cancel();
+            }
+        }));
+        return future;
+    }
+
+    py::list submit_batch(const std::vector<std::string>& start_vec, float dist_cutoff, int priority, bool reverse) {
+        for (const auto& start : start_vec) {
+            compiled_.index(start);
+        }
+        py::list res;
+        for (const auto& start : start_vec) {
+            res.append(submit(start, dist_cutoff, priority, reverse));
+        }
+        return res;
+    }
+
+    size_t queued() const {
+        return engine_->queued();
+    }
+
+   private:
+    graph::CompiledGraph<std::string> compiled_;
+    std::unique_ptr<graph::algorithms::ThreadPool> pool_;
+    std::unique_ptr<graph::algorithms::AsyncDijkstra<std::string>> engine_;
+};
+
+// Graph and ALT landmarks kept between point to point queries, so landmarks are computed or loaded once
+class PointToPointService {
+   public:
+    explicit PointToPointService(WeightsMap weights)
+        : compiled_(graph::Graph<std::string>(std::move(weights)), true) {}
+
+    void build_landmarks(size_t count) {
+        py::gil_scoped_release release;
+        landmarks_.emplace(compiled_, count);
+    }
+
+    void save_landmarks(const std::string& path) const {
+        if (!landmarks_) {
+            throw std::runtime_error("No landmarks to save");
+        }
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Can not open landmarks file: " + path);
+        }
+        landmarks_->save(out);
+    }
+
+    void load_landmarks(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Can not open landmarks file: " + path);
+        }
+        landmarks_ = graph::algorithms::Landmarks<std::string>::load(in, compiled_);
+    }
+
+    size_t landmarks_count() const {
+        return landmarks_ ? landmarks_->size() : 0;
+    }
+
+    std::vector<float> distances(const std::vector<std::pair<std::string, std::string>>& pairs, int n_threads) const {
+        graph::algorithms::ThreadPool pool(n_threads);
+        py::gil_scoped_release release;
+
+        if (landmarks_) {
+            graph::algorithms::PointToPointEngine<std::string> engine(compiled_, *landmarks_);
+            return engine.distances(pairs, pool);
+        }
+        graph::algorithms::PointToPointEngine<std::string> engine(compiled_);
+        return engine.distances(pairs, pool);
+    }
+
+   private:
+    graph::CompiledGraph<std::string> compiled_;
+    std::optional<graph::algorithms::Landmarks<std::string>> landmarks_;
+};
+
 PYBIND11_MODULE(graph_utils, graph_utils) {
     graph_utils.doc() = "Graph utils";
 
     graph_utils.def(
         "single_source_dijkstra",
         &single_source_dijkstra,
+        py::arg("weights"),
+        py::arg("start"),
+        py::arg("dist_cutoff"),
+        py::arg("reverse") = false,
         "Single source dijkstra\n"
         "Parameters\n"
         "\tweights: Dict[str, Dict[str, float]]\n"
@@ -59,6 +527,8 @@ PYBIND11_MODULE(graph_utils, graph_utils) {
         "\t\tStart vertex id\n"
         "\tdist_cutoff: float\n"
         "\t\tMax dijkstra depth distance cutoff in meters\n"
+        "\treverse: bool\n"
+        "\t\tFollow edges backwards: distances to start instead of from it\n"
         "Return\n"
         "\tDict[str, float]\n"
         "\t\tDict of all visited vertices and corresponding shortest paths\n"
@@ -66,6 +536,12 @@ PYBIND11_MODULE(graph_utils, graph_utils) {
     graph_utils.def(
         "multi_source_dijkstra",
         &multi_source_dijkstra,
+        py::arg("weights"),
+        py::arg("start_vec"),
+        py::arg("dist_cutoff"),
+        py::arg("n_threads"),
+        py::arg("reverse") = false,
+        py::arg("unit") = 0.0f,
         "Multi source dijkstra\n"
         "Parameters\n"
         "\tweights: Dict[str, Dict[str, float]]\n"
@@ -76,12 +552,372 @@ PYBIND11_MODULE(graph_utils, graph_utils) {
         "\t\tMax dijkstra depth distance cutoff in meters\n"
         "\tn_threads: int\n"
         "\t\tNumber of parallel running threads\n"
+        "\treverse: bool\n"
+        "\t\tFollow edges backwards: distances to start vertices instead of from them\n"
+        "\tunit: float\n"
+        "\t\tIf positive, round weights to 16-bit multiples of unit and search with integer distances;\n"
+        "\t\tweights above 65535 units raise an error\n"
         "Return\n"
         "\tDict[str, float]\n"
         "\t\tList of dicts of all visited vertices and corresponding shortest paths for all given start vertices\n"
     );
+    graph_utils.def(
+        "point_to_point_distances",
+        &point_to_point_distances,
+        py::arg("weights"),
+        py::arg("pairs"),
+        py::arg("n_threads"),
+        "Shortest path distances between pairs of vertices by bidirectional dijkstra;\n"
+        "PointToPoint keeps the graph and ALT landmarks between calls\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "\tpairs: List[Tuple[str, str]]\n"
+        "\t\tList of (source, target) vertices ids\n"
+        "\tn_threads: int\n"
+        "\t\tNumber of parallel running threads\n"
+        "Return\n"
+        "\tList[float]\n"
+        "\t\tDistance for every pair, inf if the target is unreachable\n"
+    );
+    graph_utils.def(
+        "distance_matrix",
+        &distance_matrix,
+        py::arg("weights"),
+        py::arg("sources"),
+        py::arg("targets"),
+        py::arg("n_threads"),
+        py::arg("max_distance") = std::numeric_limits<float>::infinity(),
+        py::arg("reverse") = false,
+        "Many-to-many shortest path distances\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "\tsources: List[str]\n"
+        "\t\tRow vertices ids\n"
+        "\ttargets: List[str]\n"
+        "\t\tColumn vertices ids\n"
+        "\tn_threads: int\n"
+        "\t\tNumber of parallel running threads\n"
+        "\tmax_distance: float\n"
+        "\t\tPairs farther than this are left unreachable\n"
+        "\treverse: bool\n"
+        "\t\tDistances from targets to sources instead of from sources to targets\n"
+        "Return\n"
+        "\tnp.ndarray\n"
+        "\t\tfloat32 matrix of shape (len(sources), len(targets)), inf for unreachable pairs\n"
+    );
+    graph_utils.def(
+        "single_source_dijkstra_with_stats",
+        &single_source_dijkstra_with_stats,
+        "Single source dijkstra with search statistics\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "\tstart: str\n"
+        "\t\tStart vertex id\n"
+        "\tdist_cutoff: float\n"
+        "\t\tMax dijkstra depth distance cutoff in meters\n"
+        "Return\n"
+        "\tTuple[Dict[str, float], Dict[str, float]]\n"
+        "\t\tShortest paths as in single_source_dijkstra and search stats: queries, settled_nodes,\n"
+        "\t\trelaxed_edges, heap_pushes, stale_pops, peak_heap_size, elapsed_seconds\n"
+    );
+    graph_utils.def(
+        "multi_source_dijkstra_with_stats",
+        &multi_source_dijkstra_with_stats,
+        "Multi source dijkstra with search statistics\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "\tstart_vec: List[str]\n"
+        "\t\tList of start vertices ids\n"
+        "\tdist_cutoff: float\n"
+        "\t\tMax dijkstra depth distance cutoff in meters\n"
+        "\tn_threads: int\n"
+        "\t\tNumber of parallel running threads\n"
+        "Return\n"
+        "\tTuple[List[Dict[str, float]], List[Dict[str, float]], List[Dict[str, float]]]\n"
+        "\t\tShortest paths as in multi_source_dijkstra, stats per query and stats per thread\n"
+    );
+    graph_utils.def(
+        "multi_source_dijkstra_with_telemetry",
+        &multi_source_dijkstra_with_telemetry,
+        py::arg("weights"),
+        py::arg("start_vec"),
+        py::arg("dist_cutoff"),
+        py::arg("n_threads"),
+        py::arg("trace_path") = "",
+        "Multi source dijkstra with thread load telemetry\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "\tstart_vec: List[str]\n"
+        "\t\tList of start vertices ids\n"
+        "\tdist_cutoff: float\n"
+        "\t\tMax dijkstra depth distance cutoff in meters\n"
+        "\tn_threads: int\n"
+        "\t\tNumber of parallel running threads\n"
+        "\ttrace_path: str\n"
+        "\t\tIf not empty, Chrome trace JSON of the run is written there\n"
+        "Return\n"
+        "\tTuple[List[Dict[str, float]], Dict[str, Any]]\n"
+        "\t\tShortest paths as in multi_source_dijkstra and telemetry: wall_seconds, utilization,\n"
+        "\t\timbalance and workers, a list of tasks, steals, busy_seconds, idle_seconds,\n"
+        "\t\tlongest_task_seconds, queue_wait_seconds, max_queue_wait_seconds per thread\n"
+    );
+    graph_utils.def(
+        "thread_pool_telemetry",
+        &shared_pool_telemetry,
+        "Load telemetry of the shared thread pool since its start or the last reset\n"
+        "Return\n"
+        "\tDict[str, Any]\n"
+        "\t\tSame fields as in multi_source_dijkstra_with_telemetry\n"
+    );
+    graph_utils.def(
+        "reset_thread_pool_telemetry",
+        &reset_shared_pool_telemetry,
+        "Zero load telemetry of the shared thread pool\n"
+    );
+    graph_utils.def(
+        "start_thread_pool_trace",
+        &start_shared_pool_trace,
+        "Start recording jobs of the shared thread pool\n"
+    );
+    graph_utils.def(
+        "stop_thread_pool_trace",
+        &stop_shared_pool_trace,
+        py::arg("trace_path"),
+        "Stop recording jobs of the shared thread pool and write them as Chrome trace JSON\n"
+        "Parameters\n"
+        "\ttrace_path: str\n"
+        "\t\tOutput file, open it in chrome://tracing or Perfetto\n"
+    );
+    graph_utils.def(
+        "connected_components",
+        &connected_components,
+        py::arg("weights"),
+        py::arg("strong") = true,
+        py::arg("n_threads") = 1,
+        "Connected components of the graph\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "\tstrong: bool\n"
+        "\t\tStrongly connected components if True, weakly connected otherwise\n"
+        "\tn_threads: int\n"
+        "\t\tNumber of parallel running threads\n"
+        "Return\n"
+        "\tTuple[Dict[str, int], List[Dict[str, int]]]\n"
+        "\t\tComponent of every vertex and vertices and edges of every component;\n"
+        "\t\tcomponents are numbered by decreasing size\n"
+    );
+    graph_utils.def(
+        "prune_components",
+        &prune_components,
+        py::arg("weights"),
+        py::arg("min_size") = 0,
+        py::arg("strong") = true,
+        py::arg("n_threads") = 1,
+        "Graph without small disconnected fragments\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "\tmin_size: int\n"
+        "\t\tKeep components with at least this many vertices; 0 keeps only the largest one\n"
+        "\tstrong: bool\n"
+        "\t\tStrongly connected components if True, weakly connected otherwise\n"
+        "\tn_threads: int\n"
+        "\t\tNumber of parallel running threads\n"
+        "Return\n"
+        "\tDict[str, Dict[str, float]]\n"
+        "\t\tEdge weights of the remaining vertices\n"
+    );
+    graph_utils.def(
+        "simplify_graph",
+        &simplify_graph,
+        py::arg("weights"),
+        py::arg("keep") = std::vector<std::string>(),
+        "Merge chains of degree-2 vertices into single edges\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "\tkeep: List[str]\n"
+        "\t\tVertices which must stay, e.g. search sources\n"
+        "Return\n"
+        "\tTuple[Dict[str, Dict[str, float]], List[Tuple[str, str, float, List[str], List[float]]]]\n"
+        "\t\tSimplified edge weights and chains: head, tail, weight, intermediate vertices\n"
+        "\t\tand their distances from the head\n"
+    );
+    graph_utils.def(
+        "graph_memory_usage",
+        &graph_memory_usage,
+        "Estimated memory footprint of the graph built from weights\n"
+        "Parameters\n"
+        "\tweights: Dict[str, Dict[str, float]]\n"
+        "\t\tGraph edge u -> v edge weights\n"
+        "Return\n"
+        "\tDict[str, int]\n"
+        "\t\tBytes by category: topology, weights, ids, coordinates, indexes, caches, results and total\n"
+    );
+    graph_utils.def(
+        "allocator_memory_usage",
+        &allocator_memory_usage,
+        "Live and peak bytes of library allocations by category\n"
+        "Return\n"
+        "\tDict[str, Dict[str, int]]\n"
+        "\t\tcurrent and peak bytes with the same categories as in graph_memory_usage\n"
+    );
     graph_utils.def(
         "ghash_encode",
         &ghash_encode
     );
+    py::class_<graph::algorithms::PolygonIndex>(graph_utils, "PolygonIndex")
+        .def(
+            py::init(&make_polygon_index),
+            py::arg("polygons_wkt"),
+            "Index of polygons for point-to-polygon spatial joins\n"
+            "Parameters\n"
+            "\tpolygons_wkt: List[str]\n"
+            "\t\tPolygons or multipolygons in WKT; polygon id is the position in the list\n"
+        )
+        .def("__len__", &graph::algorithms::PolygonIndex::size)
+        .def(
+            "join",
+            &polygon_index_join,
+            py::arg("lon"),
+            py::arg("lat"),
+            "All (point, polygon) pairs where the polygon contains the point\n"
+            "Parameters\n"
+            "\tlon: np.ndarray[float64]\n"
+            "\t\tPoint longitudes\n"
+            "\tlat: np.ndarray[float64]\n"
+            "\t\tPoint latitudes\n"
+            "Return\n"
+            "\tTuple[np.ndarray[int64], np.ndarray[int64]]\n"
+            "\t\tPoint ids and polygon ids of matches sorted by point id\n"
+        )
+        .def(
+            "assign",
+            &polygon_index_assign,
+            py::arg("lon"),
+            py::arg("lat"),
+            "Polygon id for every point\n"
+            "Parameters\n"
+            "\tlon: np.ndarray[float64]\n"
+            "\t\tPoint longitudes\n"
+            "\tlat: np.ndarray[float64]\n"
+            "\t\tPoint latitudes\n"
+            "Return\n"
+            "\tnp.ndarray[int64]\n"
+            "\t\tSmallest id of polygons containing the point or -1\n"
+        );
+    py::class_<AsyncDijkstraService>(graph_utils, "AsyncDijkstra")
+        .def(
+            py::init<WeightsMap, int>(),
+            py::arg("weights"),
+            py::arg("n_threads") = 0,
+            "Isochrone queries returning futures instead of blocking\n"
+            "Parameters\n"
+            "\tweights: Dict[str, Dict[str, float]]\n"
+            "\t\tGraph edge u -> v edge weights\n"
+            "\tn_threads: int\n"
+            "\t\tThreads of an own pool; 0 runs queries on the shared thread pool\n"
+        )
+        .def(
+            "submit",
+            &AsyncDijkstraService::submit,
+            py::arg("start"),
+            py::arg("dist_cutoff"),
+            py::arg("priority") = 0,
+            py::arg("reverse") = false,
+            "Queue single source dijkstra\n"
+            "Parameters\n"
+            "\tstart: str\n"
+            "\t\tStart vertex id\n"
+            "\tdist_cutoff: float\n"
+            "\t\tMax dijkstra depth distance cutoff in meters\n"
+            "\tpriority: int\n"
+            "\t\tQueued queries with higher priority run first\n"
+            "\treverse: bool\n"
+            "\t\tFollow edges backwards: distances to start instead of from it\n"
+            "Return\n"
+            "\tconcurrent.futures.Future\n"
+            "\t\tFuture of the Dict[str, float] single_source_dijkstra returns; use asyncio.wrap_future\n"
+            "\t\tto await it. cancel() stops the query if it has not finished\n"
+        )
+        .def(
+            "submit_batch",
+            &AsyncDijkstraService::submit_batch,
+            py::arg("start_vec"),
+            py::arg("dist_cutoff"),
+            py::arg("priority") = 0,
+            py::arg("reverse") = false,
+            "Queue single source dijkstra for every start vertex\n"
+            "Parameters\n"
+            "\tstart_vec: List[str]\n"
+            "\t\tList of start vertices ids\n"
+            "\tdist_cutoff: float\n"
+            "\t\tMax dijkstra depth distance cutoff in meters\n"
+            "\tpriority: int\n"
+            "\t\tQueued queries with higher priority run first\n"
+            "\treverse: bool\n"
+            "\t\tFollow edges backwards: distances to start vertices instead of from them\n"
+            "Return\n"
+            "\tList[concurrent.futures.Future]\n"
+            "\t\tFuture for every start vertex as in submit\n"
+        )
+        .def("queued", &AsyncDijkstraService::queued, "Number of queries waiting for a thread\n");
+    py::class_<PointToPointService>(graph_utils, "PointToPoint")
+        .def(
+            py::init<WeightsMap>(),
+            py::arg("weights"),
+            "Point to point queries on a graph compiled once\n"
+            "Parameters\n"
+            "\tweights: Dict[str, Dict[str, float]]\n"
+            "\t\tGraph edge u -> v edge weights\n"
+        )
+        .def(
+            "build_landmarks",
+            &PointToPointService::build_landmarks,
+            py::arg("count"),
+            "Select ALT landmarks and compute their distance tables; later queries use them\n"
+            "Parameters\n"
+            "\tcount: int\n"
+            "\t\tNumber of landmarks, 8-16 is typical\n"
+        )
+        .def(
+            "save_landmarks",
+            &PointToPointService::save_landmarks,
+            py::arg("path"),
+            "Write the landmark tables to a file, they are tied to this graph\n"
+            "Parameters\n"
+            "\tpath: str\n"
+            "\t\tFile path\n"
+        )
+        .def(
+            "load_landmarks",
+            &PointToPointService::load_landmarks,
+            py::arg("path"),
+            "Read landmark tables written by save_landmarks; raises RuntimeError if they belong to another graph\n"
+            "Parameters\n"
+            "\tpath: str\n"
+            "\t\tFile path\n"
+        )
+        .def("landmarks_count", &PointToPointService::landmarks_count, "Number of landmarks, 0 if there are none\n")
+        .def(
+            "distances",
+            &PointToPointService::distances,
+            py::arg("pairs"),
+            py::arg("n_threads"),
+            "Shortest path distances between pairs of vertices by bidirectional dijkstra, or ALT if there are landmarks\n"
+            "Parameters\n"
+            "\tpairs: List[Tuple[str, str]]\n"
+            "\t\tList of (source, target) vertices ids\n"
+            "\tn_threads: int\n"
+            "\t\tNumber of parallel running threads\n"
+            "Return\n"
+            "\tList[float]\n"
+            "\t\tDistance for every pair, inf if the target is unreachable\n"
+        );
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <geo_utils/osm_graph.h>
+#include <library/string_pool.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+using GraphWeights = std::unordered_map<int, std::unordered_map<int, float>>;
+
+namespace fixtures {
+
+/**
+ * @brief Random graph where every vertex gets edges_per_node edges to random vertices
+ *
+ * @param weight_dist Distribution the weights are drawn from
+ */
+template <typename WeightDist>
+GraphWeights make_random_weights(int nodes_count, int edges_per_node, unsigned seed, WeightDist weight_dist) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> node_dist(0, nodes_count - 1);
+    GraphWeights weights;
+
+    for (int node = 0; node < nodes_count; node++) {
+        weights[node];
+        for (int i = 0; i < edges_per_node; i++) {
+            weights[node][node_dist(gen)] = weight_dist(gen);
+        }
+    }
+    return weights;
+}
+
+/** @brief Random graph with weights in [1, max_weight) */
+inline GraphWeights make_random_weights(int nodes_count, int edges_per_node, unsigned seed, float max_weight = 100) {
+    return make_random_weights(nodes_count, edges_per_node, seed, std::uniform_real_distribution<float>(1, max_weight));
+}
+
+/**
+ * @brief Random graph with weights in [0, max_weight] which are multiples of 0.5
+ *
+ * Such weights are exact in units of 0.5, so float distances stay exact.
+ */
+inline GraphWeights make_half_unit_weights(int nodes_count, int edges_per_node, unsigned seed, int max_weight) {
+    std::uniform_int_distribution<int> half_units(0, 2 * max_weight);
+    return make_random_weights(nodes_count, edges_per_node, seed, [&](std::mt19937& gen) {
+        return half_units(gen) * 0.5f;
+    });
+}
+
+/**
+ * @brief side x side grid of streets, every tenth of them one-way
+ *
+ * @param weight_dist Distribution the weights are drawn from, the two directions of a street get their own weights
+ */
+template <typename WeightDist>
+GraphWeights make_directed_grid(int side, unsigned seed, WeightDist weight_dist) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> one_way_dist(0, 9);
+    GraphWeights weights;
+
+    auto add_street = [&](int from, int to) {
+        weights[from][to] = weight_dist(gen);
+        if (one_way_dist(gen) != 0) {
+            weights[to][from] = weight_dist(gen);
+        }
+    };
+
+    for (int node = 0; node < side * side; node++) {
+        weights[node];
+        if (node % side + 1 < side) {
+            add_street(node, node + 1);
+        }
+        if (node + side < side * side) {
+            add_street(node, node + side);
+        }
+    }
+    return weights;
+}
+
+/** @brief side x side grid of streets with integer weights, every tenth of them one-way */
+inline osm::OSMGraph make_grid(int side, const std::shared_ptr<lib::StringPool>& string_pool, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> weight_dist(1, 20);
+    std::uniform_int_distribution<int> one_way_dist(0, 9);
+    std::unordered_map<osm::OSMNode, std::unordered_map<osm::OSMNode, float>> weights;
+
+    auto node = [&](int row, int col) {
+        return osm::OSMNode{string_pool->intern(std::to_string(row * side + col)), 37.0f + col * 0.001f, 55.0f + row * 0.001f};
+    };
+    auto add_street = [&](const osm::OSMNode& from, const osm::OSMNode& to) {
+        float weight = weight_dist(gen);
+        weights[from][to] = weight;
+        if (one_way_dist(gen) != 0) {
+            weights[to][from] = weight;
+        }
+    };
+    for (int row = 0; row < side; row++) {
+        for (int col = 0; col < side; col++) {
+            weights[node(row, col)];
+            if (col + 1 < side) {
+                add_street(node(row, col), node(row, col + 1));
+            }
+            if (row + 1 < side) {
+                add_street(node(row, col), node(row + 1, col));
+            }
+        }
+    }
+    return osm::OSMGraph(std::move(weights), string_pool);
+}
+
+}  // namespace fixtures
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <compiled_graph.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/dijkstra_algorithm.h>
+#include <geo_utils/osm_graph.h>
+#include <graph.h>
+#include <graph_fixtures.h>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+TEST(test_compiled_graph, structure) {
+    // Vertex 4 is only an edge target
+    GraphWeights weights = {
+        {1, {{2, 3}, {3, 1}}},
+        {2, {{4, 2}}},
+        {3, {}}
+    };
+    graph::Graph<int> graph(std::move(weights));
+    graph::CompiledGraph<int> compiled(graph);
+
+    ASSERT_EQ(compiled.vertices_count(), 4);
+    ASSERT_EQ(compiled.edges_count(), 3);
+    ASSERT_FALSE(compiled.has_coordinates());
+    ASSERT_EQ(compiled.out_degree(compiled.index(1)), 2);
+    ASSERT_EQ(compiled.out_degree(compiled.index(4)), 0);
+    ASSERT_EQ(compiled.find_index(5), graph::CompiledGraph<int>::kInvalidIndex);
+    ASSERT_THROW(compiled.index(5), std::out_of_range);
+
+    auto v = compiled.index(2);
+    ASSERT_EQ(compiled.vertex(v), 2);
+    ASSERT_EQ(compiled.vertex(compiled.target(compiled.first_edge(v))), 4);
+    ASSERT_EQ(compiled.weight(compiled.first_edge(v)), 2);
+}
+
+TEST(test_compiled_graph, dijkstra_matches_graph) {
+    const float dist_thr = 150;
+    auto cutoff = [dist_thr](float dist) { return dist <= dist_thr; };
+    graph::Graph<int> graph(fixtures::make_random_weights(2'000, 3, 42));
+    graph::CompiledGraph<int> compiled(graph);
+
+    std::vector<int> starts = {0, 17, 512, 1999};
+    auto true_results = graph::algorithms::multi_source_dijkstra(graph, starts, 2, cutoff);
+    auto results = graph::algorithms::multi_source_dijkstra(compiled, starts, 2, cutoff);
+
+    for (size_t i = 0; i < starts.size(); i++) {
+        ASSERT_EQ(results[i].size(), true_results[i].size());
+        for (const auto& [vertex, dist] : true_results[i]) {
+            ASSERT_FLOAT_EQ(results[i].at(vertex), dist) << vertex;
+        }
+    }
+
+    // Workspace reuse gives the same result as a fresh one
+    graph::algorithms::DijkstraWorkspace workspace;
+    graph::algorithms::NoSearchStats stats;
+    graph::algorithms::single_source_dijkstra(compiled, compiled.index(17), cutoff, workspace, stats);
+    graph::algorithms::single_source_dijkstra(compiled, compiled.index(0), cutoff, workspace, stats);
+    ASSERT_EQ(graph::algorithms::reached_to_map(compiled, workspace), true_results[0]);
+}
+
+TEST(test_compiled_graph, permuted) {
+    auto cutoff = [](float dist) { return dist <= 200; };
+    graph::Graph<int> graph(fixtures::make_random_weights(500, 3, 7));
+    graph::CompiledGraph<int> compiled(graph);
+
+    std::vector<std::uint32_t> order(compiled.vertices_count());
+    for (std::uint32_t v = 0; v < order.size(); v++) {
+        order[v] = order.size() - 1 - v;
+    }
+    auto permuted = compiled.permuted(order);
+
+    ASSERT_EQ(permuted.vertices_count(), compiled.vertices_count());
+    ASSERT_EQ(permuted.edges_count(), compiled.edges_count());
+    ASSERT_EQ(permuted.vertex(0), compiled.vertex(order[0]));
+    ASSERT_EQ(permuted.index(compiled.vertex(order[0])), 0);
+    ASSERT_EQ(
+        graph::algorithms::single_source_dijkstra(permuted, 10, cutoff),
+        graph::algorithms::single_source_dijkstra(compiled, 10, cutoff)
+    );
+
+    ASSERT_THROW(compiled.permuted({0, 1}), std::runtime_error);
+    order[0] = order[1];
+    ASSERT_THROW(compiled.permuted(order), std::runtime_error);
+}
+
+TEST(test_compiled_graph, reverse_isochrones) {
+    auto cutoff = [](float dist) { return dist <= 150; };
+    GraphWeights weights = fixtures::make_random_weights(1'000, 3, 11);
+    GraphWeights reversed_weights;
+    for (const auto& [vertex, neighbors] : weights) {
+        reversed_weights[vertex];
+        for (const auto& [neighbor, weight] : neighbors) {
+            reversed_weights[neighbor][vertex] = weight;
+        }
+    }
+
+    graph::Graph<int> graph(std::move(weights));
+    graph::Graph<int> reversed(std::move(reversed_weights));
+    graph::CompiledGraph<int> compiled(graph);
+
+    ASSERT_FALSE(compiled.has_transposed());
+    ASSERT_THROW(graph::algorithms::single_source_dijkstra(compiled, 5, cutoff, graph::SearchDirection::Backward), std::runtime_error);
+
+    compiled.build_transposed();
+    ASSERT_TRUE(compiled.has_transposed());
+    std::vector<int> starts = {5, 123, 999};
+    auto true_results = graph::algorithms::multi_source_dijkstra(reversed, starts, 2, cutoff);
+    auto results = graph::algorithms::multi_source_dijkstra(compiled, starts, 2, cutoff, graph::SearchDirection::Backward);
+
+    for (size_t i = 0; i < starts.size(); i++) {
+        ASSERT_EQ(results[i].size(), true_results[i].size());
+        for (const auto& [vertex, dist] : true_results[i]) {
+            ASSERT_FLOAT_EQ(results[i].at(vertex), dist) << vertex;
+        }
+    }
+
+    // Permuting keeps the transposed adjacency
+    std::vector<std::uint32_t> order(compiled.vertices_count());
+    for (std::uint32_t v = 0; v < order.size(); v++) {
+        order[v] = (v * 7) % order.size();
+    }
+    auto permuted = compiled.permuted(order);
+    ASSERT_TRUE(permuted.has_transposed());
+    ASSERT_EQ(
+        graph::algorithms::single_source_dijkstra(permuted, 123, cutoff, graph::SearchDirection::Backward),
+        results[1]
+    );
+}
+
+TEST(test_compiled_graph, osm_coordinates) {
+    auto string_pool = std::make_shared<lib::StringPool>();
+    osm::OSMNode a{string_pool->intern("1"), 37.0f, 55.0f};
+    osm::OSMNode b{string_pool->intern("2"), 37.5f, 55.5f};
+    std::unordered_map<osm::OSMNode, std::unordered_map<osm::OSMNode, float>> weights;
+    weights[a][b] = 10.0f;
+    weights[b][a] = 10.0f;
+    osm::OSMGraph graph(std::move(weights), string_pool);
+    graph::CompiledGraph<osm::OSMNode> compiled(graph);
+
+    ASSERT_TRUE(compiled.has_coordinates());
+    ASSERT_EQ(compiled.x(compiled.index(b)), 37.5f);
+    ASSERT_EQ(compiled.y(compiled.index(a)), 55.0f);
+
+    auto report = compiled.memory_usage();
+    ASSERT_GE(report[lib::MemoryCategory::Topology], 3 * sizeof(std::uint32_t) + 2 * sizeof(std::uint32_t));
+    ASSERT_GE(report[lib::MemoryCategory::Weights], 2 * sizeof(float));
+    ASSERT_GE(report[lib::MemoryCategory::Coordinates], 4 * sizeof(float));
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/quantized_dijkstra.h>
+#include <algorithms/vertex_order.h>
+#include <compiled_graph.h>
+#include <compressed_graph.h>
+#include <geo_utils/osm_graph.h>
+#include <graph.h>
+#include <graph_fixtures.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template <typename G>
+std::vector<std::pair<std::uint32_t, float>> edges_of(const G& graph, std::uint32_t v, graph::SearchDirection direction) {
+    std::vector<std::pair<std::uint32_t, float>> res;
+    graph::dispatch_direction(direction, [&](auto direction_tag) {
+        graph.template for_each_edge<decltype(direction_tag)::value>(v, [&](std::uint32_t u, float weight) {
+            res.push_back({u, weight});
+        });
+    });
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+}  // namespace
+
+TEST(test_compressed_graph, same_edges) {
+    graph::Graph<int> graph(fixtures::make_half_unit_weights(3000, 4, 1, 200));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::CompressedGraph<int> compressed(compiled, {0.5f});
+    graph::CompressedGraph<int> forward_only(graph::CompiledGraph<int>(graph), {0.5f});
+
+    ASSERT_EQ(compressed.vertices_count(), compiled.vertices_count());
+    ASSERT_EQ(compressed.edges_count(), compiled.edges_count());
+    ASSERT_TRUE(compressed.has_transposed());
+    ASSERT_FALSE(forward_only.has_transposed());
+    ASSERT_THROW(forward_only.check_direction(graph::SearchDirection::Backward), std::runtime_error);
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+        ASSERT_EQ(compressed.vertex(v), compiled.vertex(v));
+        ASSERT_EQ(compressed.index(compiled.vertex(v)), v);
+        for (auto direction : {graph::SearchDirection::Forward, graph::SearchDirection::Backward}) {
+            ASSERT_EQ(edges_of(compressed, v, direction), edges_of(compiled, v, direction));
+        }
+    }
+}
+
+TEST(test_compressed_graph, dijkstra_matches_compiled) {
+    graph::Graph<int> graph(fixtures::make_half_unit_weights(3000, 3, 2, 200));
+    graph::CompiledGraph<int> unordered(graph, true);
+    // Without coordinates the bandwidth reducing order gives the locality
+    auto compiled = unordered.permuted(graph::algorithms::rcm_order(unordered));
+    graph::CompressedGraph<int> compressed(compiled, {0.5f});
+
+    size_t compiled_bytes = compiled.memory_usage()[lib::MemoryCategory::Topology] + compiled.memory_usage()[lib::MemoryCategory::Weights];
+    ASSERT_LT(compressed.adjacency_bytes() * 2, compiled_bytes);
+
+    for (float dist_cutoff : {0.0f, 250.0f, 1e9f}) {
+        auto cutoff = [dist_cutoff](float dist) { return dist <= dist_cutoff; };
+        for (int start : {0, 1000, 2999}) {
+            for (auto direction : {graph::SearchDirection::Forward, graph::SearchDirection::Backward}) {
+                ASSERT_EQ(
+                    graph::algorithms::compressed_dijkstra(compressed, start, cutoff, direction),
+                    graph::algorithms::single_source_dijkstra(compiled, start, cutoff, direction)
+                );
+            }
+        }
+    }
+}
+
+TEST(test_compressed_graph, osm_memory_usage) {
+    auto string_pool = std::make_shared<lib::StringPool>();
+    osm::OSMNode a{string_pool->intern("1"), 37.0f, 55.0f};
+    osm::OSMNode b{string_pool->intern("2"), 37.5f, 55.5f};
+    std::unordered_map<osm::OSMNode, std::unordered_map<osm::OSMNode, float>> weights;
+    weights[a][b] = 10.0f;
+    weights[b][a] = 10.0f;
+    osm::OSMGraph graph(std::move(weights), string_pool);
+    graph::CompiledGraph<osm::OSMNode> compiled(graph);
+    graph::CompressedGraph<osm::OSMNode> compressed(compiled);
+
+    // Both graphs keep the same vertices, so ids must be accounted the same way
+    auto compiled_report = compiled.memory_usage();
+    auto compressed_report = compressed.memory_usage();
+    ASSERT_EQ(compressed_report[lib::MemoryCategory::Ids], compiled_report[lib::MemoryCategory::Ids]);
+    ASSERT_EQ(compressed_report[lib::MemoryCategory::Coordinates], 4 * sizeof(float));
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <algorithms/connected_components.h>
+#include <algorithms/thread_pool.h>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <graph_fixtures.h>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+std::vector<bool> reachable(const graph::CompiledGraph<int>& graph, std::uint32_t start) {
+    std::vector<bool> reached(graph.vertices_count(), false);
+    std::vector<std::uint32_t> queue = {start};
+    reached[start] = true;
+    for (size_t head = 0; head < queue.size(); head++) {
+        for (auto edge = graph.first_edge(queue[head]); edge < graph.last_edge(queue[head]); edge++) {
+            if (!reached[graph.target(edge)]) {
+                reached[graph.target(edge)] = true;
+                queue.push_back(graph.target(edge));
+            }
+        }
+    }
+    return reached;
+}
+
+void expect_same_partition(const graph::algorithms::Components& lhs, const graph::algorithms::Components& rhs) {
+    ASSERT_EQ(lhs.count(), rhs.count());
+    ASSERT_EQ(lhs.component_of.size(), rhs.component_of.size());
+    std::vector<std::uint32_t> mapping(lhs.count(), graph::CompiledGraph<int>::kInvalidIndex);
+    for (size_t v = 0; v < lhs.component_of.size(); v++) {
+        auto& mapped = mapping[lhs.component_of[v]];
+        if (mapped == graph::CompiledGraph<int>::kInvalidIndex) {
+            mapped = rhs.component_of[v];
+        }
+        ASSERT_EQ(mapped, rhs.component_of[v]);
+    }
+    for (size_t id = 0; id < lhs.count(); id++) {
+        ASSERT_EQ(lhs.stats[id].vertices, rhs.stats[mapping[id]].vertices);
+        ASSERT_EQ(lhs.stats[id].edges, rhs.stats[mapping[id]].edges);
+    }
+}
+
+}  // namespace
+
+TEST(test_connected_components, small_graph) {
+    // Cycle 1-2-3 with a one-way entry from 4 and exit to 5, separate two-way street 6-7
+    GraphWeights weights = {
+        {1, {{2, 1}}},
+        {2, {{3, 1}}},
+        {3, {{1, 1}, {5, 1}}},
+        {4, {{1, 1}}},
+        {6, {{7, 1}}},
+        {7, {{6, 1}}}
+    };
+    graph::Graph<int> graph(std::move(weights));
+    graph::CompiledGraph<int> compiled(graph, true);
+
+    auto strong = graph::algorithms::connected_components(compiled);
+    ASSERT_EQ(strong.count(), 4);
+    ASSERT_EQ(strong.largest_size(), 3);
+    ASSERT_EQ(strong.stats[0].edges, 3);
+    ASSERT_EQ(strong.stats[1].vertices, 2);
+    ASSERT_EQ(strong.component_of[compiled.index(1)], 0);
+    ASSERT_EQ(strong.component_of[compiled.index(6)], 1);
+    ASSERT_NE(strong.component_of[compiled.index(4)], strong.component_of[compiled.index(5)]);
+
+    auto weak = graph::algorithms::connected_components(compiled, graph::algorithms::Connectivity::Weak);
+    ASSERT_EQ(weak.count(), 2);
+    ASSERT_EQ(weak.largest_size(), 5);
+    ASSERT_EQ(weak.stats[0].edges, 5);
+
+    auto largest = graph::algorithms::keep_largest_component(compiled, strong);
+    ASSERT_EQ(largest.vertices_count(), 3);
+    ASSERT_EQ(largest.edges_count(), 3);
+    ASSERT_TRUE(largest.has_transposed());
+    ASSERT_EQ(largest.find_index(4), graph::CompiledGraph<int>::kInvalidIndex);
+    ASSERT_EQ(largest.find_index(5), graph::CompiledGraph<int>::kInvalidIndex);
+    ASSERT_THROW(largest.index(6), std::out_of_range);
+    ASSERT_EQ(largest.vertex(largest.target(largest.first_edge(largest.index(1)))), 2);
+
+    auto pruned = graph::algorithms::keep_components(compiled, strong, 2);
+    ASSERT_EQ(pruned.vertices_count(), 5);
+    ASSERT_EQ(pruned.edges_count(), 5);
+    ASSERT_EQ(pruned.find_index(4), graph::CompiledGraph<int>::kInvalidIndex);
+    ASSERT_EQ(pruned.out_degree(pruned.index(3)), 1);
+}
+
+TEST(test_connected_components, matches_reachability) {
+    graph::Graph<int> graph(fixtures::make_random_weights(400, 1, 5));
+    graph::CompiledGraph<int> compiled(graph);
+    graph::algorithms::ThreadPool pool(3);
+
+    auto strong = graph::algorithms::connected_components(compiled, graph::algorithms::Connectivity::Strong, pool);
+    std::vector<std::vector<bool>> reach;
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+        reach.push_back(reachable(compiled, v));
+    }
+    for (std::uint32_t u = 0; u < compiled.vertices_count(); u++) {
+        for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+            ASSERT_EQ(strong.component_of[u] == strong.component_of[v], reach[u][v] && reach[v][u]);
+        }
+    }
+    for (size_t id = 1; id < strong.count(); id++) {
+        ASSERT_GE(strong.stats[id - 1].vertices, strong.stats[id].vertices);
+    }
+}
+
+TEST(test_connected_components, parallel_split_matches_serial) {
+    graph::Graph<int> graph(fixtures::make_random_weights(60000, 2, 6));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::CompiledGraph<int> forward_only(graph);
+    graph::algorithms::ThreadPool pool(4);
+    graph::algorithms::ThreadPool serial_pool(1);
+
+    // Large enough for the forward-backward split in the parallel run
+    auto parallel = graph::algorithms::connected_components(compiled, graph::algorithms::Connectivity::Strong, pool);
+    auto serial = graph::algorithms::connected_components(forward_only, graph::algorithms::Connectivity::Strong, serial_pool);
+    ASSERT_GT(parallel.largest_size(), 20000);
+    expect_same_partition(parallel, serial);
+
+    auto weak_parallel = graph::algorithms::connected_components(compiled, graph::algorithms::Connectivity::Weak, pool);
+    auto weak_serial = graph::algorithms::connected_components(compiled, graph::algorithms::Connectivity::Weak, serial_pool);
+    expect_same_partition(weak_parallel, weak_serial);
+}
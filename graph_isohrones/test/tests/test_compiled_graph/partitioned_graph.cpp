@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/partitioned_dijkstra.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <compiled_graph.h>
+#include <geo_utils/osm_graph.h>
+#include <graph_fixtures.h>
+#include <partitioned_graph.h>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+class TempFile {
+   public:
+    explicit TempFile(const std::string& name)
+        : path_((std::filesystem::temp_directory_path() / name).string()) {}
+
+    ~TempFile() {
+        std::filesystem::remove(path_);
+    }
+
+    const std::string& path() const {
+        return path_;
+    }
+
+   private:
+    std::string path_;
+};
+
+}  // namespace
+
+TEST(test_partitioned_graph, layout) {
+    auto string_pool = std::make_shared<lib::StringPool>();
+    graph::CompiledGraph<osm::OSMNode> compiled(fixtures::make_grid(40, string_pool, 7), true);
+    TempFile file("test_partitioned_graph_layout.bin");
+    graph::write_partitioned_graph(compiled, file.path(), 100);
+    graph::PartitionedGraph partitioned(file.path());
+
+    ASSERT_EQ(partitioned.vertices_count(), compiled.vertices_count());
+    ASSERT_EQ(partitioned.edges_count(), compiled.edges_count());
+    ASSERT_EQ(partitioned.cells_count(), 16);
+    ASSERT_EQ(partitioned.fingerprint(), compiled.fingerprint());
+    ASSERT_TRUE(partitioned.has_transposed());
+    ASSERT_EQ(partitioned.loaded_cells_count(), 0);
+
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+        auto p = partitioned.partitioned_index(v);
+        ASSERT_EQ(partitioned.original_index(p), v);
+        ASSERT_EQ(partitioned.x(p), compiled.x(v));
+        ASSERT_EQ(partitioned.y(p), compiled.y(v));
+
+        std::vector<std::pair<std::uint32_t, float>> expected, edges;
+        compiled.for_each_edge<graph::SearchDirection::Forward>(v, [&](std::uint32_t u, float weight) {
+            expected.push_back({partitioned.partitioned_index(u), weight});
+        });
+        partitioned.for_each_edge<graph::SearchDirection::Forward>(p, [&](std::uint32_t u, float weight) {
+            edges.push_back({u, weight});
+        });
+        ASSERT_EQ(edges, expected);
+    }
+    ASSERT_EQ(partitioned.loaded_cells_count(), 16);
+
+    // Boundary vertices are exactly the ones with a neighbor in another cell
+    for (std::uint32_t cell = 0; cell < partitioned.cells_count(); cell++) {
+        auto boundary = partitioned.boundary_vertices(cell);
+        for (std::uint32_t v = cell * 100; v < (cell + 1) * 100; v++) {
+            bool crosses = false;
+            auto check = [&](std::uint32_t u, float) { crosses |= partitioned.cell_of(u) != cell; };
+            partitioned.for_each_edge<graph::SearchDirection::Forward>(v, check);
+            partitioned.for_each_edge<graph::SearchDirection::Backward>(v, check);
+            ASSERT_EQ(std::find(boundary.begin(), boundary.end(), v) != boundary.end(), crosses);
+        }
+    }
+
+    ASSERT_THROW(graph::PartitionedGraph("/nonexistent/graph.bin"), std::runtime_error);
+    ASSERT_THROW(partitioned.partitioned_index(compiled.vertices_count()), std::out_of_range);
+}
+
+TEST(test_partitioned_graph, search_under_budget) {
+    auto string_pool = std::make_shared<lib::StringPool>();
+    graph::CompiledGraph<osm::OSMNode> compiled(fixtures::make_grid(60, string_pool, 7), true);
+    TempFile file("test_partitioned_graph_search.bin");
+    graph::write_partitioned_graph(compiled, file.path(), 64);
+    // Budget of a few cells, so wide searches have to evict
+    graph::PartitionedGraph partitioned(file.path(), 4 * 4096);
+    graph::algorithms::PartitionedDijkstraSearch search;
+    graph::algorithms::NoSearchStats stats;
+    graph::algorithms::DijkstraWorkspace workspace;
+
+    for (float dist_cutoff : {15.0f, 120.0f, 1e9f}) {
+        auto cutoff = [dist_cutoff](float dist) { return dist <= dist_cutoff; };
+        for (std::uint32_t start : {0u, 1234u, 3599u}) {
+            for (auto direction : {graph::SearchDirection::Forward, graph::SearchDirection::Backward}) {
+                graph::algorithms::single_source_dijkstra(compiled, start, cutoff, workspace, stats, direction);
+                graph::algorithms::partitioned_dijkstra(partitioned, partitioned.partitioned_index(start), cutoff, search, stats, direction);
+
+                ASSERT_EQ(search.settled().size(), workspace.reached().size());
+                for (const auto& [v, dist] : search.settled()) {
+                    ASSERT_EQ(dist, workspace.dist(partitioned.original_index(v)));
+                }
+                ASSERT_LE(partitioned.resident_bytes(), 4 * 4096);
+            }
+        }
+    }
+    ASSERT_GT(partitioned.evictions(), 0);
+
+    // A small isochrone maps only the cells around the start
+    partitioned.evict_all();
+    auto cutoff = [](float dist) { return dist <= 10; };
+    graph::algorithms::partitioned_dijkstra(partitioned, partitioned.partitioned_index(1800), cutoff, search, stats);
+    ASSERT_LE(partitioned.loaded_cells_count(), 4);
+    ASSERT_EQ(partitioned.resident_bytes(), partitioned.memory_usage()[lib::MemoryCategory::Topology]);
+}
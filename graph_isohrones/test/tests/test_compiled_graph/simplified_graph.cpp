@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/dijkstra_algorithm.h>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <random>
+#include <simplified_graph.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using GraphWeights = std::unordered_map<int, std::unordered_map<int, float>>;
+
+namespace {
+
+// Grid of streets drawn with shape_nodes intermediate vertices each, every fifth street one-way;
+// integer weights keep distances exact
+GraphWeights make_shaped_grid(int side, int shape_nodes, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> weight_dist(1, 20);
+    std::uniform_int_distribution<int> one_way_dist(0, 4);
+    GraphWeights weights;
+    int next_node = side * side;
+
+    auto add_street = [&](int from, int to) {
+        bool one_way = one_way_dist(gen) == 0;
+        int prev = from;
+        for (int i = 0; i <= shape_nodes; i++) {
+            int node = i == shape_nodes ? to : next_node++;
+            float weight = weight_dist(gen);
+            weights[prev][node] = weight;
+            weights[node];
+            if (!one_way) {
+                weights[node][prev] = weight;
+            }
+            prev = node;
+        }
+    };
+
+    for (int node = 0; node < side * side; node++) {
+        weights[node];
+        if (node % side + 1 < side) {
+            add_street(node, node + 1);
+        }
+        if (node + side < side * side) {
+            add_street(node, node + side);
+        }
+    }
+    return weights;
+}
+
+}  // namespace
+
+TEST(test_simplified_graph, chains) {
+    // Two-way chain 1 - 2 - 3 - 4 with a branch at 4, one-way chain 4 -> 5 -> 6 -> 1
+    // and a one-way ring 7 -> 8 -> 9 -> 7
+    GraphWeights weights = {
+        {1, {{2, 1}}},
+        {2, {{1, 1}, {3, 2}}},
+        {3, {{2, 2}, {4, 3}}},
+        {4, {{3, 3}, {5, 1}, {10, 1}}},
+        {5, {{6, 1}}},
+        {6, {{1, 1}}},
+        {7, {{8, 1}}},
+        {8, {{9, 1}}},
+        {9, {{7, 1}}},
+        {10, {{4, 1}}}
+    };
+    graph::Graph<int> graph(std::move(weights));
+    graph::SimplifiedGraph<int> simplified(graph);
+
+    ASSERT_EQ(simplified.original_vertices_count(), 10);
+    ASSERT_EQ(simplified.vertices_count(), 4);
+    ASSERT_TRUE(simplified.contains(1));
+    ASSERT_TRUE(simplified.contains(4));
+    ASSERT_FALSE(simplified.contains(2));
+    ASSERT_EQ(simplified.graph().get_neighbors(1).at(4), 6);
+    ASSERT_EQ(simplified.graph().get_neighbors(4).at(1), 3);
+    ASSERT_EQ(simplified.graph().get_neighbors(4).at(10), 1);
+
+    auto chains = simplified.chains_from(4);
+    ASSERT_EQ(chains.size(), 2);
+    for (const auto& chain : chains) {
+        auto vertices = simplified.chain_vertices(chain);
+        auto offsets = simplified.chain_offsets(chain);
+        ASSERT_EQ(chain.tail, 1);
+        if (vertices[0] == 3) {
+            ASSERT_EQ(chain.weight, 6);
+            ASSERT_EQ(std::vector<int>(vertices.begin(), vertices.end()), std::vector<int>({3, 2}));
+            ASSERT_EQ(std::vector<float>(offsets.begin(), offsets.end()), std::vector<float>({3, 5}));
+        } else {
+            ASSERT_EQ(chain.weight, 3);
+            ASSERT_EQ(std::vector<int>(vertices.begin(), vertices.end()), std::vector<int>({5, 6}));
+        }
+    }
+
+    auto cutoff = [](float dist) { return dist <= 4; };
+    auto dists = simplified.expand(graph::algorithms::single_source_dijkstra(simplified.graph(), 4, cutoff), cutoff);
+    ASSERT_EQ(dists, graph::algorithms::single_source_dijkstra(graph, 4, cutoff));
+
+    // The ring keeps one vertex with a self-loop chain
+    ASSERT_EQ(simplified.chains().back().head, simplified.chains().back().tail);
+    ASSERT_EQ(simplified.chains().back().weight, 3);
+
+    graph::SimplifiedGraph<int> with_source(graph, {2});
+    ASSERT_EQ(with_source.vertices_count(), 5);
+    ASSERT_EQ(with_source.graph().get_neighbors(2).at(4), 5);
+}
+
+TEST(test_simplified_graph, distances_match_original) {
+    graph::Graph<int> graph(make_shaped_grid(15, 4, 1));
+    // Grid corners are two-way chain vertices, so sources have to be kept
+    std::unordered_set<int> starts;
+    for (int start = 0; start < 15 * 15; start += 14) {
+        starts.insert(start);
+    }
+    graph::SimplifiedGraph<int> simplified(graph, starts);
+    graph::CompiledGraph<int> compiled(simplified.graph());
+
+    ASSERT_GT(simplified.original_vertices_count(), 3 * simplified.vertices_count());
+    for (float dist_cutoff : {40.0f, 300.0f, 10'000.0f}) {
+        auto cutoff = [dist_cutoff](float dist) { return dist <= dist_cutoff; };
+        for (int start : starts) {
+            auto expected = graph::algorithms::single_source_dijkstra(graph, start, cutoff);
+            ASSERT_EQ(simplified.expand(graph::algorithms::single_source_dijkstra(simplified.graph(), start, cutoff), cutoff), expected);
+            ASSERT_EQ(simplified.expand(graph::algorithms::single_source_dijkstra(compiled, start, cutoff), cutoff), expected);
+        }
+    }
+}
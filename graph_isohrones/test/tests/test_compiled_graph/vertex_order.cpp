@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/vertex_order.h>
+#include <compiled_graph.h>
+#include <geo_utils/osm_graph.h>
+#include <graph.h>
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Grid with node ids shuffled, so the hash map order has no locality
+template <typename MakeNode>
+auto make_shuffled_grid(int side, MakeNode&& make_node) {
+    using Node = decltype(make_node(0, 0, 0));
+    std::vector<int> ids(side * side);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+    std::unordered_map<Node, std::unordered_map<Node, float>> weights;
+
+    auto node = [&](int row, int col) { return make_node(ids[row * side + col], row, col); };
+    for (int row = 0; row < side; row++) {
+        for (int col = 0; col < side; col++) {
+            weights[node(row, col)];
+            if (col + 1 < side) {
+                weights[node(row, col)][node(row, col + 1)] = 1;
+                weights[node(row, col + 1)][node(row, col)] = 1;
+            }
+            if (row + 1 < side) {
+                weights[node(row, col)][node(row + 1, col)] = 1;
+                weights[node(row + 1, col)][node(row, col)] = 1;
+            }
+        }
+    }
+    return weights;
+}
+
+template <typename Vertex>
+void expect_permutation(const std::vector<std::uint32_t>& order, const graph::CompiledGraph<Vertex>& graph) {
+    std::vector<std::uint32_t> sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    ASSERT_EQ(sorted.size(), graph.vertices_count());
+    for (std::uint32_t v = 0; v < sorted.size(); v++) {
+        ASSERT_EQ(sorted[v], v);
+    }
+}
+
+}  // namespace
+
+TEST(test_vertex_order, rcm) {
+    const int side = 50;
+    graph::Graph<int> graph(make_shuffled_grid(side, [](int id, int, int) { return id; }));
+    graph::CompiledGraph<int> compiled(graph);
+
+    auto order = graph::algorithms::rcm_order(compiled);
+    expect_permutation(order, compiled);
+    ASSERT_EQ(graph::algorithms::locality_order(compiled), order);
+
+    auto reordered = graph::algorithms::reorder_for_locality(compiled);
+    ASSERT_LT(graph::algorithms::mean_edge_span(reordered), side * 1.5);
+    ASSERT_GT(graph::algorithms::mean_edge_span(compiled), side * 3);
+    ASSERT_THROW(graph::algorithms::hilbert_order(compiled), std::runtime_error);
+
+    auto cutoff = [](float dist) { return dist <= 20; };
+    ASSERT_EQ(
+        graph::algorithms::single_source_dijkstra(reordered, 1234, cutoff),
+        graph::algorithms::single_source_dijkstra(compiled, 1234, cutoff)
+    );
+}
+
+TEST(test_vertex_order, hilbert) {
+    const int side = 50;
+    auto string_pool = std::make_shared<lib::StringPool>();
+    auto make_node = [&string_pool](int id, int row, int col) {
+        return osm::OSMNode{string_pool->intern(std::to_string(id)), 37.0f + col * 0.001f, 55.0f + row * 0.001f};
+    };
+    osm::OSMGraph graph(make_shuffled_grid(side, make_node), string_pool);
+    graph::CompiledGraph<osm::OSMNode> compiled(graph);
+
+    auto order = graph::algorithms::hilbert_order(compiled);
+    expect_permutation(order, compiled);
+    ASSERT_EQ(graph::algorithms::locality_order(compiled), order);
+
+    auto reordered = compiled.permuted(order);
+    ASSERT_LT(graph::algorithms::mean_edge_span(reordered), side);
+    ASSERT_GT(graph::algorithms::mean_edge_span(compiled), side * 3);
+
+    // Coordinates follow their vertices
+    for (std::uint32_t v = 0; v < reordered.vertices_count(); v++) {
+        ASSERT_EQ(reordered.x(v), reordered.vertex(v).x);
+        ASSERT_EQ(reordered.y(v), reordered.vertex(v).y);
+        ASSERT_EQ(reordered.index(reordered.vertex(v)), v);
+    }
+
+    osm::OSMNode start{string_pool->intern("777"), 0, 0};
+    auto cutoff = [](float dist) { return dist <= 20; };
+    ASSERT_EQ(
+        graph::algorithms::single_source_dijkstra(reordered, start, cutoff),
+        graph::algorithms::single_source_dijkstra(compiled, start, cutoff)
+    );
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/dijkstra_algorithm.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <graph_fixtures.h>
+#include <cstddef>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Travel time over edges with their own speeds
+struct TimeWeight {
+    const std::vector<float>* speeds;
+
+    template <typename Vertex>
+    float operator()(const graph::CompiledGraph<Vertex>& graph, std::uint32_t edge) const {
+        return graph.weight(edge) / (*speeds)[edge];
+    }
+};
+
+// Stops after a number of settled vertices
+struct LimitVisitor {
+    size_t limit;
+    size_t settled = 0;
+
+    bool on_settle(std::uint32_t, float) {
+        return ++settled < limit;
+    }
+};
+
+}  // namespace
+
+TEST(test_dijkstra_search, parents) {
+    graph::Graph<int> graph(fixtures::make_random_weights(500, 3, 1));
+    graph::CompiledGraph<int> compiled(graph);
+    graph::algorithms::DijkstraSearch<graph::algorithms::BinaryHeap, graph::algorithms::ParentLabels> search;
+    graph::algorithms::NoSearchStats stats;
+    struct NoVisitor {} visitor;
+
+    search.run(compiled, 0, visitor, stats);
+    ASSERT_EQ(search.labels().parent(0), graph::algorithms::ParentLabels::kNoParent);
+    for (const auto& [v, dist] : search.settled()) {
+        // Path back to the start along parents sums up to the distance
+        float path = 0;
+        for (auto u = v; u != 0; u = search.labels().parent(u)) {
+            auto parent = search.labels().parent(u);
+            path += graph.get_neighbors(compiled.vertex(parent)).at(compiled.vertex(u));
+        }
+        ASSERT_NEAR(path, dist, dist * 1e-5);
+    }
+}
+
+TEST(test_dijkstra_search, weight_accessor) {
+    graph::Graph<int> graph(fixtures::make_random_weights(500, 3, 2));
+    graph::CompiledGraph<int> compiled(graph);
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> speed_dist(5, 20);
+    std::vector<float> speeds(compiled.edges_count());
+    GraphWeights time_weights;
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+        time_weights[compiled.vertex(v)];
+        for (auto edge = compiled.first_edge(v); edge < compiled.last_edge(v); edge++) {
+            speeds[edge] = speed_dist(gen);
+            time_weights[compiled.vertex(v)][compiled.vertex(compiled.target(edge))] = compiled.weight(edge) / speeds[edge];
+        }
+    }
+    graph::Graph<int> time_graph(std::move(time_weights));
+
+    graph::algorithms::DijkstraSearch<graph::algorithms::BinaryHeap, graph::algorithms::DistanceLabels, TimeWeight> search(TimeWeight{&speeds});
+    graph::algorithms::NoSearchStats stats;
+    auto cutoff = [](float dist) { return dist <= 10; };
+    graph::algorithms::CutoffVisitor<decltype(cutoff)> visitor{cutoff};
+
+    search.run(compiled, compiled.index(7), visitor, stats);
+    auto expected = graph::algorithms::single_source_dijkstra(time_graph, 7, cutoff);
+    ASSERT_EQ(search.settled().size(), expected.size());
+    for (const auto& [v, dist] : search.settled()) {
+        ASSERT_FLOAT_EQ(dist, expected.at(compiled.vertex(v)));
+    }
+}
+
+TEST(test_dijkstra_search, bands) {
+    graph::Graph<int> graph(fixtures::make_random_weights(500, 3, 4));
+    graph::CompiledGraph<int> compiled(graph);
+    graph::algorithms::DijkstraSearch<> search;
+    graph::algorithms::SearchStats stats;
+    std::vector<float> limits = {50, 100, 150};
+    std::vector<std::vector<std::uint32_t>> bands(limits.size());
+
+    search.run(compiled, 0, graph::algorithms::BandsVisitor{limits, bands}, stats);
+    auto cutoff = [](float dist) { return dist <= 150; };
+    auto expected = graph::algorithms::single_source_dijkstra(graph, compiled.vertex(0), cutoff);
+
+    size_t total = 0;
+    for (size_t band = 0; band < bands.size(); band++) {
+        for (auto v : bands[band]) {
+            float dist = expected.at(compiled.vertex(v));
+            ASSERT_LE(dist, limits[band]);
+            ASSERT_TRUE(band == 0 || dist > limits[band - 1]);
+        }
+        total += bands[band].size();
+    }
+    ASSERT_EQ(total, expected.size());
+    ASSERT_EQ(stats.settled_nodes, expected.size());
+}
+
+TEST(test_dijkstra_search, early_stop_resets_labels) {
+    graph::Graph<int> graph(fixtures::make_random_weights(500, 3, 5));
+    graph::CompiledGraph<int> compiled(graph);
+    graph::algorithms::DijkstraSearch<> search;
+    graph::algorithms::DijkstraSearch<> fresh_search;
+    graph::algorithms::NoSearchStats stats;
+    struct NoVisitor {} visitor;
+
+    search.run(compiled, 0, LimitVisitor{10}, stats);
+    ASSERT_EQ(search.settled().size(), 10);
+
+    // Labels left in the heap by the stopped search must not leak into the next one
+    search.run(compiled, 250, visitor, stats);
+    fresh_search.run(compiled, 250, visitor, stats);
+    ASSERT_EQ(search.settled(), fresh_search.settled());
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+        ASSERT_EQ(search.dist(v), fresh_search.dist(v));
+    }
+}
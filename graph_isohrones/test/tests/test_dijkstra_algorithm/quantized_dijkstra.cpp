@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/quantized_dijkstra.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <graph_fixtures.h>
+#include <quantized_weights.h>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+
+TEST(test_quantized_dijkstra, quantization) {
+    GraphWeights weights = {
+        {1, {{2, 1.24}, {3, 0.04}}},
+        {2, {{3, 6553.5}}},
+        {3, {{1, 7000}}}
+    };
+    graph::Graph<int> graph(std::move(weights));
+    graph::CompiledGraph<int> compiled(graph);
+
+    ASSERT_THROW(graph::QuantizedWeights<std::uint16_t>(compiled, {0.1f}), std::runtime_error);
+    ASSERT_THROW(graph::QuantizedWeights<std::uint16_t>(compiled, {0}), std::runtime_error);
+
+    graph::QuantizedWeights<std::uint16_t> saturated(compiled, {0.1f, graph::QuantizationOverflow::Saturate});
+    ASSERT_EQ(saturated.saturated_count(), 1);
+    ASSERT_EQ(saturated.max_weight(), 65535);
+    auto units = [&](int from, int to) {
+        auto v = compiled.index(from);
+        for (auto edge = compiled.first_edge(v); edge < compiled.last_edge(v); edge++) {
+            if (compiled.vertex(compiled.target(edge)) == to) {
+                return saturated[edge];
+            }
+        }
+        throw std::runtime_error("No edge");
+    };
+    ASSERT_EQ(units(1, 2), 12);
+    ASSERT_EQ(units(1, 3), 0);
+    ASSERT_EQ(units(2, 3), 65535);
+    ASSERT_EQ(units(3, 1), 65535);
+
+    graph::QuantizedWeights<std::uint32_t> wide(compiled, {0.1f});
+    ASSERT_EQ(wide.saturated_count(), 0);
+    ASSERT_EQ(wide.max_weight(), 70000);
+    ASSERT_EQ(wide.memory_usage()[lib::MemoryCategory::Weights], 2 * saturated.memory_usage()[lib::MemoryCategory::Weights]);
+}
+
+TEST(test_quantized_dijkstra, matches_compiled_dijkstra) {
+    graph::Graph<int> graph(fixtures::make_half_unit_weights(2000, 3, 1, 100));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::QuantizedWeights<std::uint16_t> weights(compiled, {0.5f});
+
+    for (float dist_cutoff : {0.0f, 150.0f, 400.0f, 1e9f}) {
+        auto cutoff = [dist_cutoff](float dist) { return dist <= dist_cutoff; };
+        for (int start : {0, 17, 1999}) {
+            for (auto direction : {graph::SearchDirection::Forward, graph::SearchDirection::Backward}) {
+                ASSERT_EQ(
+                    graph::algorithms::quantized_dijkstra(compiled, weights, start, cutoff, direction),
+                    graph::algorithms::single_source_dijkstra(compiled, start, cutoff, direction)
+                );
+            }
+        }
+    }
+
+    std::vector<int> starts = {3, 5, 8, 13, 21};
+    auto cutoff = [](float dist) { return dist <= 300; };
+    ASSERT_EQ(
+        graph::algorithms::multi_source_quantized_dijkstra(compiled, weights, starts, 2, cutoff),
+        graph::algorithms::multi_source_dijkstra(compiled, starts, 2, cutoff)
+    );
+}
+
+TEST(test_quantized_dijkstra, queue_growth_and_reuse) {
+    // Large weights make the bucket array grow while the queue holds vertices
+    graph::Graph<int> graph(fixtures::make_half_unit_weights(500, 4, 2, 30000));
+    graph::CompiledGraph<int> compiled(graph);
+    graph::QuantizedWeights<std::uint16_t> weights(compiled, {0.5f});
+    graph::algorithms::QuantizedDijkstraSearch<std::uint16_t> search(graph::algorithms::QuantizedWeight<std::uint16_t>{&weights});
+    graph::algorithms::SearchStats stats;
+
+    auto limited = [](float dist) { return dist <= 20000; };
+    auto unlimited = [](float) { return true; };
+    for (int start : {0, 250, 499}) {
+        graph::algorithms::quantized_dijkstra(compiled, weights, compiled.index(start), limited, search, stats);
+        ASSERT_EQ(graph::algorithms::quantized_to_map(compiled, weights, search), graph::algorithms::single_source_dijkstra(compiled, start, limited));
+        graph::algorithms::quantized_dijkstra(compiled, weights, compiled.index(start), unlimited, search, stats);
+        ASSERT_EQ(graph::algorithms::quantized_to_map(compiled, weights, search), graph::algorithms::single_source_dijkstra(compiled, start, unlimited));
+    }
+    ASSERT_EQ(stats.queries, 6);
+    ASSERT_GT(search.memory_usage()[lib::MemoryCategory::Caches], 0);
+}
+
+TEST(test_quantized_dijkstra, queue_keys_far_from_zero) {
+    graph::algorithms::DialQueue queue;
+    const std::uint32_t base = std::uint32_t(1) << 30;
+
+    // Sources may come in any order; only the span of queued keys is bounded
+    queue.push(base + 5, 1);
+    queue.push(base, 0);
+    queue.push(base + 5, 2);
+    ASSERT_EQ(queue.pop().first, base);
+    ASSERT_EQ(queue.pop().first, base + 5);
+    queue.push(base + 100, 3);
+    ASSERT_EQ(queue.pop().first, base + 5);
+    ASSERT_EQ(queue.pop(), std::make_pair(base + 100, std::uint32_t(3)));
+    ASSERT_TRUE(queue.empty());
+
+    // An emptied queue starts over at the next key
+    queue.push(7, 4);
+    ASSERT_EQ(queue.pop(), std::make_pair(std::uint32_t(7), std::uint32_t(4)));
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <graph.h>
+#include <algorithms/shortest_paths/dijkstra_algorithm.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+using GraphWeights = std::unordered_map<int, std::unordered_map<int, float>>;
+
+namespace {
+
+GraphWeights make_test_weights() {
+    return {
+        {1, {{2, 3}, {3, 1}, {7, 5}, {8, 1}}},
+        {2, {{1, 3}, {4, 2}}},
+        {3, {{1, 1}, {4, 5}, {5, 3}}},
+        {4, {{2, 2}, {3, 5}}},
+        {5, {{3, 3}}},
+        {6, {{7, 7}, {9, 2}}},
+        {7, {{1, 5}, {6, 7}}},
+        {8, {{1, 1}, {9, 1}}},
+        {9, {{8, 1}, {6, 2}}}
+    };
+}
+
+}  // namespace
+
+TEST(test_search_stats, single_source) {
+    graph::Graph<int> graph(make_test_weights());
+    auto cutoff = [](float dist) { return dist <= 5'000; };
+    graph::algorithms::SearchStats stats;
+    auto res = graph::algorithms::single_source_dijkstra(graph, 1, cutoff, stats);
+    auto true_res = graph::algorithms::single_source_dijkstra(graph, 1, cutoff);
+
+    EXPECT_EQ(res, true_res);
+    EXPECT_EQ(stats.queries, 1);
+    // Every reached vertex is settled once, all out edges of settled vertices are relaxed
+    EXPECT_EQ(stats.settled_nodes, res.size());
+    EXPECT_EQ(stats.relaxed_edges, 20);
+    EXPECT_EQ(stats.heap_pushes, stats.settled_nodes + stats.stale_pops);
+    EXPECT_GE(stats.peak_heap_size, 1);
+    EXPECT_LE(stats.peak_heap_size, stats.heap_pushes);
+    EXPECT_GE(stats.elapsed_seconds, 0);
+}
+
+TEST(test_search_stats, cutoff_reduces_work) {
+    graph::Graph<int> graph(make_test_weights());
+    graph::algorithms::SearchStats full_stats;
+    graph::algorithms::SearchStats cut_stats;
+    graph::algorithms::single_source_dijkstra(graph, 1, [](float dist) { return dist <= 5'000; }, full_stats);
+    graph::algorithms::single_source_dijkstra(graph, 1, [](float dist) { return dist <= 2; }, cut_stats);
+
+    EXPECT_LT(cut_stats.settled_nodes, full_stats.settled_nodes);
+    EXPECT_LT(cut_stats.relaxed_edges, full_stats.relaxed_edges);
+}
+
+TEST(test_search_stats, multi_source) {
+    graph::Graph<int> graph(make_test_weights());
+    auto cutoff = [](float dist) { return dist <= 5'000; };
+    std::vector<int> starts_vec = {1, 2, 3, 4, 5, 6, 7};
+    const int n_threads = 3;
+    graph::algorithms::BatchSearchStats stats;
+    auto res = graph::algorithms::multi_source_dijkstra(graph, starts_vec, n_threads, cutoff, stats);
+
+    ASSERT_EQ(res.size(), starts_vec.size());
+    ASSERT_EQ(stats.per_query.size(), starts_vec.size());
+    ASSERT_EQ(stats.per_thread.size(), n_threads);
+
+    std::uint64_t settled_nodes = 0;
+    for (size_t start_idx = 0; start_idx < starts_vec.size(); start_idx++) {
+        graph::algorithms::SearchStats true_stats;
+        graph::algorithms::single_source_dijkstra(graph, starts_vec[start_idx], cutoff, true_stats);
+
+        EXPECT_EQ(res[start_idx], graph::algorithms::single_source_dijkstra(graph, starts_vec[start_idx], cutoff));
+        EXPECT_EQ(stats.per_query[start_idx].settled_nodes, true_stats.settled_nodes);
+        EXPECT_EQ(stats.per_query[start_idx].relaxed_edges, true_stats.relaxed_edges);
+        settled_nodes += true_stats.settled_nodes;
+    }
+
+    auto total = stats.total();
+    EXPECT_EQ(total.queries, starts_vec.size());
+    EXPECT_EQ(total.settled_nodes, settled_nodes);
+}
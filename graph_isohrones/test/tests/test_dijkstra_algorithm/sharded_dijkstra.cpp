@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <algorithms/graph_partition.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <algorithms/shortest_paths/sharded_dijkstra.h>
+#include <compiled_graph.h>
+#include <geo_utils/osm_graph.h>
+#include <graph_fixtures.h>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+TEST(test_sharded_dijkstra, geometric_partition) {
+    auto string_pool = std::make_shared<lib::StringPool>();
+    graph::CompiledGraph<osm::OSMNode> compiled(fixtures::make_grid(40, string_pool, 11));
+
+    for (std::uint32_t shards : {1u, 2u, 3u, 4u, 7u}) {
+        auto partition = graph::algorithms::geometric_partition(compiled, shards, 0.05);
+        ASSERT_EQ(partition.count(), shards);
+        ASSERT_EQ(partition.shard_of.size(), compiled.vertices_count());
+
+        size_t total = 0, cut_edges = 0;
+        for (auto size : partition.shard_sizes) {
+            ASSERT_NEAR(size, 1600.0 / shards, 1600.0 / shards * 0.11);
+            total += size;
+        }
+        ASSERT_EQ(total, compiled.vertices_count());
+        for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+            for (auto edge = compiled.first_edge(v); edge < compiled.last_edge(v); edge++) {
+                cut_edges += partition.shard_of[v] != partition.shard_of[compiled.target(edge)];
+            }
+        }
+        ASSERT_EQ(partition.cut_edges, cut_edges);
+        // Straight cuts across the grid, not a scattered split
+        ASSERT_LE(partition.cut_edges, 2 * 45 * (shards - 1));
+    }
+
+    ASSERT_THROW(graph::algorithms::geometric_partition(compiled, 0), std::runtime_error);
+    ASSERT_THROW(graph::algorithms::geometric_partition(compiled, 1601), std::runtime_error);
+}
+
+TEST(test_sharded_dijkstra, geometric_partition_no_empty_shards) {
+    auto string_pool = std::make_shared<lib::StringPool>();
+
+    // With as few vertices as shards every split has to leave a vertex for every shard
+    for (int side : {2, 3, 5}) {
+        graph::CompiledGraph<osm::OSMNode> compiled(fixtures::make_grid(side, string_pool, 11));
+        for (std::uint32_t shards = 1; shards <= compiled.vertices_count(); shards++) {
+            auto partition = graph::algorithms::geometric_partition(compiled, shards, 0.05);
+            ASSERT_EQ(partition.count(), shards);
+            for (auto size : partition.shard_sizes) {
+                ASSERT_GT(size, 0) << side << "x" << side << " grid, " << shards << " shards";
+            }
+        }
+    }
+}
+
+TEST(test_sharded_dijkstra, matches_single_source) {
+    // Workers are forked before the graph is built, so they hold only their shards
+    graph::algorithms::ShardWorkers workers(4);
+    auto string_pool = std::make_shared<lib::StringPool>();
+    graph::CompiledGraph<osm::OSMNode> compiled(fixtures::make_grid(40, string_pool, 11));
+    ASSERT_THROW(
+        graph::algorithms::ShardedDijkstra(compiled, graph::algorithms::geometric_partition(compiled, 3), graph::algorithms::ShardWorkers(2)),
+        std::runtime_error
+    );
+    graph::algorithms::ShardedDijkstra sharded(compiled, graph::algorithms::geometric_partition(compiled, 4), std::move(workers));
+    ASSERT_EQ(sharded.shards_count(), 4);
+    ASSERT_GT(sharded.overlay().vertices_count(), 0);
+    ASSERT_LT(sharded.overlay().vertices_count(), compiled.vertices_count() / 4);
+
+    graph::algorithms::DijkstraWorkspace workspace;
+    graph::algorithms::NoSearchStats stats;
+    for (float max_distance : {10.0f, 150.0f, 1e9f}) {
+        auto cutoff = [max_distance](float dist) { return dist <= max_distance; };
+        for (std::uint32_t start : {0u, 777u, 1599u}) {
+            graph::algorithms::single_source_dijkstra(compiled, start, cutoff, workspace, stats);
+            auto labels = sharded.single_source_dijkstra(start, max_distance);
+
+            ASSERT_EQ(labels.size(), workspace.reached().size());
+            for (const auto& [v, dist] : labels) {
+                ASSERT_EQ(dist, workspace.dist(v));
+            }
+        }
+    }
+}
+
+TEST(test_sharded_dijkstra, concurrent_queries) {
+    graph::algorithms::ShardWorkers workers(3);
+    auto string_pool = std::make_shared<lib::StringPool>();
+    graph::CompiledGraph<osm::OSMNode> compiled(fixtures::make_grid(30, string_pool, 11));
+    graph::algorithms::ShardedDijkstra sharded(compiled, graph::algorithms::geometric_partition(compiled, 3), std::move(workers));
+    auto expected = sharded.single_source_dijkstra(450, 100);
+
+    std::vector<std::thread> threads;
+    std::vector<bool> same(4, false);
+    for (size_t i = 0; i < same.size(); i++) {
+        threads.emplace_back([&sharded, &expected, &same, i] {
+            bool res = true;
+            for (int query = 0; query < 20; query++) {
+                res = res && sharded.single_source_dijkstra(450, 100) == expected;
+            }
+            same[i] = res;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (bool res : same) {
+        ASSERT_TRUE(res);
+    }
+    ASSERT_THROW(sharded.single_source_dijkstra(900, 100), std::out_of_range);
+    ASSERT_EQ(sharded.single_source_dijkstra(450, 100), expected);
+}
+
+TEST(test_sharded_dijkstra, workers_need_single_thread) {
+    std::promise<void> release;
+    std::thread thread([future = release.get_future()]() mutable { future.wait(); });
+    ASSERT_THROW(graph::algorithms::ShardWorkers(2), std::runtime_error);
+    release.set_value();
+    thread.join();
+    ASSERT_EQ(graph::algorithms::ShardWorkers(2).size(), 2);
+}
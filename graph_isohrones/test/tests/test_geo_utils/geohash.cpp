@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 #include <geo_utils/geohash.h>
 #include <cstdint>
+#include <map>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 #include <fstream>
@@ -22,6 +24,93 @@ TEST(test_geohash, test_encode) {
     }
 }
 
+TEST(test_geohash, test_encode_bits_per_char) {
+    EXPECT_EQ(geo_utils::geohash::encode(-51.7216, 64.1835, 18, 2), "120220220311022220");
+    EXPECT_EQ(geo_utils::geohash::encode(-51.7216, 64.1835, 9, 4), "628a352a8");
+    EXPECT_EQ(geo_utils::geohash::encode(-51.7216, 64.1835, 6, 6), "Nccp@c");
+    EXPECT_EQ(geo_utils::geohash::encode(37.6, 55.75, 6, 6), "ZQ7UiF");
+    EXPECT_EQ(geo_utils::geohash::encode(179.9, -89.9, 9, 4), "fffff863e");
+    EXPECT_THROW(geo_utils::geohash::encode(0, 0, 12, 6), std::runtime_error);
+}
+
+TEST(test_geohash, test_decode) {
+    const std::vector<std::pair<double, double>> points = {
+        {-51.7216, 64.1835}, {37.6, 55.75}, {0, 0}, {179.9, -89.9}, {-180, 90}
+    };
+
+    for (int bits_per_char : {2, 4, 6}) {
+        for (int precision = 1; precision * bits_per_char <= 36; precision++) {
+            for (auto& point : points) {
+                std::string code = geo_utils::geohash::encode(point.first, point.second, precision, bits_per_char);
+                auto cell = geo_utils::geohash::decode_exactly(code, bits_per_char);
+
+                ASSERT_LE(cell.min_lon(), point.first);
+                ASSERT_GE(cell.max_lon(), point.first);
+                ASSERT_LE(cell.min_lat(), point.second);
+                ASSERT_GE(cell.max_lat(), point.second);
+                ASSERT_EQ(geo_utils::geohash::encode(cell.lon, cell.lat, precision, bits_per_char), code);
+                ASSERT_EQ(geo_utils::geohash::string_to_code(code, bits_per_char), geo_utils::geohash::encode_to_int(point.first, point.second, precision, bits_per_char));
+            }
+        }
+    }
+}
+
+TEST(test_geohash, test_neighbours) {
+    std::map<std::string, std::string> true_res = {
+        {"east", "0122"}, {"west", "0130"}, {"north", "0210"}, {"north-east", "0211"},
+        {"north-west", "0203"}, {"south", "0120"}, {"south-east", "0121"}, {"south-west", "0131"}
+    };
+    EXPECT_EQ(geo_utils::geohash::neighbours("0123", 2), true_res);
+
+    // North pole cell has no northern neighbours
+    std::string pole_code = geo_utils::geohash::encode(0.1, 89.9999, 8, 4);
+    auto pole_neighbours = geo_utils::geohash::neighbours(pole_code, 4);
+    EXPECT_EQ(pole_neighbours.size(), 5);
+    EXPECT_EQ(pole_neighbours.count("north"), 0);
+
+    // East neighbour of the last column wraps around the globe
+    std::string east_code = geo_utils::geohash::encode(179.99, 10.0, 5, 6);
+    auto wrapped = geo_utils::geohash::decode_exactly(geo_utils::geohash::neighbours(east_code, 6).at("east"), 6);
+    EXPECT_LT(wrapped.min_lon(), -179.9);
+}
+
+TEST(test_geohash, test_bbox_ranges) {
+    const int precision = 5;
+    const int bits_per_char = 2;
+    const std::uint64_t cells_count = 1ull << (precision * bits_per_char);
+    const std::vector<std::vector<double>> boxes = {
+        {30.0, 50.0, 40.0, 60.0},
+        {-180.0, -90.0, 180.0, 90.0},
+        {-3.0, -1.0, 3.0, 1.0},
+        {170.0, -20.0, -170.0, 20.0}
+    };
+
+    for (auto& box : boxes) {
+        auto ranges = geo_utils::geohash::bbox_ranges(box[0], box[1], box[2], box[3], precision, bits_per_char);
+        std::vector<bool> in_ranges(cells_count, false);
+
+        for (size_t i = 0; i < ranges.size(); i++) {
+            ASSERT_LE(ranges[i].first, ranges[i].second);
+            if (i > 0) {
+                // Ranges are sorted and not adjacent, i.e. minimal
+                ASSERT_GT(ranges[i].first, ranges[i - 1].second + 1);
+            }
+            for (auto code = ranges[i].first; code <= ranges[i].second; code++) {
+                in_ranges[code] = true;
+            }
+        }
+
+        for (std::uint64_t code = 0; code < cells_count; code++) {
+            auto cell = geo_utils::geohash::decode_int_exactly(code, precision, bits_per_char);
+            bool lon_hit = box[0] <= box[2]
+                ? cell.min_lon() <= box[2] && cell.max_lon() > box[0]
+                : cell.min_lon() <= box[2] || cell.max_lon() > box[0];
+            bool lat_hit = cell.min_lat() <= box[3] && cell.max_lat() > box[1];
+            ASSERT_EQ(in_ranges[code], lon_hit && lat_hit) << code;
+        }
+    }
+}
+
 TEST(test_geohash, benchmark_encode_to_string) {
     double test_lat = 64.1835;
     double test_lon = -51.7216;
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <algorithms/light_polygon.h>
+#include <algorithms/prepared_polygon.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Star shaped ring with a random radius per vertex, closed like GEOS rings
+graph::algorithms::LightSimplePolygon make_star_polygon(size_t vertices_count, double cx, double cy, std::mt19937& gen) {
+    std::uniform_real_distribution<double> radius_dist(0.2, 1.0);
+    std::vector<graph::algorithms::Point2d> points;
+
+    for (size_t i = 0; i < vertices_count; i++) {
+        double angle = 2 * M_PI * i / vertices_count;
+        double radius = radius_dist(gen);
+        points.push_back({cx + radius * std::cos(angle), cy + radius * std::sin(angle)});
+    }
+    points.push_back(points.front());
+
+    return graph::algorithms::LightSimplePolygon(points);
+}
+
+}  // namespace
+
+TEST(test_prepared_polygon, matches_light_polygon) {
+    std::mt19937 gen(42);
+
+    for (size_t vertices_count : {3, 10, 100, 5'000}) {
+        auto polygon = make_star_polygon(vertices_count, -51.7, 64.2, gen);
+        graph::algorithms::PreparedSimplePolygon prepared(polygon);
+        std::uniform_real_distribution<double> x_dist(polygon.bbox.xmin - 0.1, polygon.bbox.xmax + 0.1);
+        std::uniform_real_distribution<double> y_dist(polygon.bbox.ymin - 0.1, polygon.bbox.ymax + 0.1);
+        std::vector<graph::algorithms::Point2d> test_points;
+
+        for (size_t i = 0; i < 20'000; i++) {
+            test_points.push_back({x_dist(gen), y_dist(gen)});
+        }
+
+        // Degenerate cases: vertices, midpoints of edges and points level with vertices
+        for (size_t i = 0; i + 1 < polygon.points.size(); i++) {
+            auto a = polygon.points[i];
+            auto b = polygon.points[i + 1];
+            test_points.push_back(a);
+            test_points.push_back({(a.x + b.x) / 2, (a.y + b.y) / 2});
+            test_points.push_back({x_dist(gen), a.y});
+        }
+
+        size_t inside_count = 0;
+        for (auto point : test_points) {
+            bool true_res = polygon.contains(point);
+            inside_count += true_res;
+            ASSERT_EQ(prepared.contains(point), true_res) << point.x << " " << point.y;
+        }
+
+        ASSERT_GT(inside_count, 0);
+        ASSERT_LT(inside_count, test_points.size());
+    }
+}
+
+TEST(test_prepared_polygon, batched_contains) {
+    std::mt19937 gen(7);
+    auto polygon = make_star_polygon(1'000, 37.6, 55.75, gen);
+    graph::algorithms::PreparedSimplePolygon prepared(polygon, 4);
+    std::uniform_real_distribution<double> x_dist(36.5, 38.7);
+    std::uniform_real_distribution<double> y_dist(54.7, 56.8);
+    std::vector<double> lon_vec;
+    std::vector<double> lat_vec;
+
+    for (size_t i = 0; i < 10'000; i++) {
+        lon_vec.push_back(x_dist(gen));
+        lat_vec.push_back(y_dist(gen));
+    }
+
+    auto res = prepared.contains(lon_vec, lat_vec);
+    ASSERT_EQ(res.size(), lon_vec.size());
+    ASSERT_GT(prepared.slabsCount(), 1);
+
+    for (size_t i = 0; i < res.size(); i++) {
+        ASSERT_EQ(res[i] != 0, polygon.contains(lon_vec[i], lat_vec[i])) << i;
+    }
+
+    EXPECT_THROW(prepared.contains(lon_vec, std::vector<double>(1)), std::runtime_error);
+}
+
+TEST(test_prepared_polygon, empty_polygon) {
+    graph::algorithms::PreparedSimplePolygon prepared(graph::algorithms::LightSimplePolygon{});
+    ASSERT_FALSE(prepared.contains(0, 0));
+}
+
+TEST(test_bbox_tree, query_matches_scan) {
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coord_dist(0, 100);
+    std::uniform_real_distribution<double> size_dist(0, 5);
+    std::vector<graph::algorithms::BoundingBox> boxes;
+
+    for (size_t i = 0; i < 3'000; i++) {
+        double x = coord_dist(gen);
+        double y = coord_dist(gen);
+        boxes.push_back(graph::algorithms::BoundingBox(x, x + size_dist(gen), y, y + size_dist(gen)));
+    }
+
+    graph::algorithms::BBoxTree tree(boxes, 8);
+    ASSERT_EQ(tree.size(), boxes.size());
+    ASSERT_GT(tree.depth(), 2);
+
+    for (size_t i = 0; i < 1'000; i++) {
+        graph::algorithms::Point2d point{coord_dist(gen), coord_dist(gen)};
+        std::vector<std::uint32_t> res;
+        tree.query(point, [&res](std::uint32_t idx) {
+            res.push_back(idx);
+            return false;
+        });
+        std::sort(res.begin(), res.end());
+
+        std::vector<std::uint32_t> true_res;
+        for (std::uint32_t idx = 0; idx < boxes.size(); idx++) {
+            if (graph::algorithms::boxContains(boxes[idx], point)) {
+                true_res.push_back(idx);
+            }
+        }
+        ASSERT_EQ(res, true_res);
+    }
+
+    graph::algorithms::BBoxTree empty_tree(std::vector<graph::algorithms::BoundingBox>{});
+    ASSERT_FALSE(empty_tree.query(graph::algorithms::Point2d{1, 1}, [](std::uint32_t) { return true; }));
+}
+
+TEST(test_prepared_polygon, multipolygon_matches_light_polygon) {
+    std::mt19937 gen(11);
+    graph::algorithms::LightMultiPolygon multipolygon;
+
+    // Grid of islands, every island with a grid of holes
+    for (int i = 0; i < 30; i++) {
+        for (int j = 0; j < 30; j++) {
+            graph::algorithms::LightPolygon polygon;
+            polygon.external_polygon = make_star_polygon(50, 30 + 2.5 * i, 40 + 2.5 * j, gen);
+
+            for (int k = 0; k < 4; k++) {
+                double cx = 30 + 2.5 * i + (k % 2 ? 0.1 : -0.1);
+                double cy = 40 + 2.5 * j + (k / 2 ? 0.1 : -0.1);
+                std::vector<graph::algorithms::Point2d> hole = {
+                    {cx - 0.05, cy - 0.05}, {cx + 0.05, cy - 0.04}, {cx + 0.04, cy + 0.05}, {cx - 0.05, cy - 0.05}
+                };
+                polygon.internal_polygons_vec.push_back(graph::algorithms::LightSimplePolygon(hole));
+            }
+            multipolygon.polygons_vec.push_back(polygon);
+        }
+    }
+
+    graph::algorithms::PreparedMultiPolygon prepared(multipolygon);
+    std::uniform_real_distribution<double> x_dist(28, 105);
+    std::uniform_real_distribution<double> y_dist(38, 115);
+    std::uniform_real_distribution<double> offset_dist(-0.15, 0.15);
+    std::vector<double> lon_vec;
+    std::vector<double> lat_vec;
+
+    for (size_t i = 0; i < 20'000; i++) {
+        lon_vec.push_back(x_dist(gen));
+        lat_vec.push_back(y_dist(gen));
+    }
+
+    // Points near hole centers
+    for (size_t i = 0; i < 5'000; i++) {
+        lon_vec.push_back(30 + 2.5 * (i % 30) + offset_dist(gen));
+        lat_vec.push_back(40 + 2.5 * (i / 30 % 30) + offset_dist(gen));
+    }
+
+    auto res = prepared.contains(lon_vec, lat_vec);
+    size_t inside_count = 0;
+
+    for (size_t i = 0; i < lon_vec.size(); i++) {
+        bool true_res = multipolygon.contains(lon_vec[i], lat_vec[i]);
+        inside_count += true_res;
+        ASSERT_EQ(res[i] != 0, true_res) << lon_vec[i] << " " << lat_vec[i];
+    }
+
+    ASSERT_GT(inside_count, 0);
+}
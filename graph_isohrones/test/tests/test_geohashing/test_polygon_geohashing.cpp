@@ -25,6 +25,28 @@
 #include <geo_utils/geohash.h>
 #include <io/read_file.h>
 #include <algorithms/light_polygon.h>
+#include <algorithms/polygon_cover.h>
+
+namespace {
+
+graph::algorithms::LightMultiPolygon make_test_multipolygon() {
+    using graph::algorithms::LightPolygon;
+    using graph::algorithms::LightSimplePolygon;
+    using graph::algorithms::Point2d;
+
+    // Two polygons, one with hole; shifted to avoid cell centers on edges
+    LightPolygon first;
+    first.external_polygon = LightSimplePolygon({{40.13, 40.07}, {20.11, 45.03}, {45.17, 30.09}, {40.13, 40.07}});
+    LightPolygon second;
+    second.external_polygon = LightSimplePolygon({{20.13, 35.07}, {10.11, 30.03}, {10.17, 10.09}, {30.05, 5.01}, {45.19, 20.11}, {20.13, 35.07}});
+    second.internal_polygons_vec.push_back(LightSimplePolygon({{30.07, 20.03}, {20.09, 15.11}, {20.03, 25.07}, {30.07, 20.03}}));
+
+    graph::algorithms::LightMultiPolygon multipolygon;
+    multipolygon.polygons_vec = {first, second};
+    return multipolygon;
+}
+
+}  // namespace
 
 TEST(test_polygon_geohashing, small_polygon) {
     using namespace geos::io;
@@ -245,4 +267,94 @@ TEST(test_polygon_geohashing, moscow_light_polygon) {
     }
 
     fout.close();
+}
+
+TEST(test_polygon_cover, center_matches_contains) {
+    const int precision = 8;
+    const int bits_per_char = 2;
+    const std::uint64_t dim = 1ull << (precision * bits_per_char / 2);
+    auto multipolygon = make_test_multipolygon();
+
+    for (int n_threads : {1, 4}) {
+        auto codes = graph::algorithms::polygon_cover(multipolygon, precision, bits_per_char, n_threads);
+        std::vector<std::uint64_t> true_codes;
+
+        for (std::uint64_t code = 0; code < dim * dim; code++) {
+            auto cell = geo_utils::geohash::decode_int_exactly(code, precision, bits_per_char);
+            if (multipolygon.contains(cell.lon, cell.lat)) {
+                true_codes.push_back(code);
+            }
+        }
+
+        ASSERT_FALSE(true_codes.empty());
+        ASSERT_EQ(codes, true_codes);
+    }
+}
+
+TEST(test_polygon_cover, intersects_is_superset) {
+    const int precision = 8;
+    const int bits_per_char = 2;
+    auto multipolygon = make_test_multipolygon();
+    auto center_codes = graph::algorithms::polygon_cover(multipolygon, precision, bits_per_char, 2);
+    auto intersects_codes = graph::algorithms::polygon_cover(
+        multipolygon, precision, bits_per_char, 2, graph::algorithms::CoverMode::Intersects
+    );
+
+    ASSERT_GT(intersects_codes.size(), center_codes.size());
+    ASSERT_TRUE(std::includes(intersects_codes.begin(), intersects_codes.end(), center_codes.begin(), center_codes.end()));
+    ASSERT_TRUE(std::adjacent_find(intersects_codes.begin(), intersects_codes.end()) == intersects_codes.end());
+
+    // Every vertex lies in some covered cell
+    for (const auto& polygon : multipolygon.polygons_vec) {
+        for (const auto& point : polygon.external_polygon.points) {
+            auto code = geo_utils::geohash::encode_to_int(point.x, point.y, precision, bits_per_char);
+            ASSERT_TRUE(std::binary_search(intersects_codes.begin(), intersects_codes.end(), code));
+        }
+    }
+
+    // A polygon smaller than a cell still gets its cell
+    graph::algorithms::LightMultiPolygon tiny;
+    tiny.polygons_vec.resize(1);
+    tiny.polygons_vec[0].external_polygon = graph::algorithms::LightSimplePolygon({{1.01, 1.01}, {1.02, 1.01}, {1.02, 1.02}, {1.01, 1.01}});
+    auto tiny_codes = graph::algorithms::polygon_cover(tiny, precision, bits_per_char, 1, graph::algorithms::CoverMode::Intersects);
+    ASSERT_EQ(tiny_codes, std::vector<std::uint64_t>{geo_utils::geohash::encode_to_int(1.015, 1.015, precision, bits_per_char)});
+}
+
+TEST(test_polygon_cover, compact_cover) {
+    const int precision = 10;
+    const int bits_per_char = 2;
+    auto multipolygon = make_test_multipolygon();
+    auto codes = graph::algorithms::polygon_cover(multipolygon, precision, bits_per_char, 4);
+    auto cells = graph::algorithms::compact_cover(codes, precision, bits_per_char, 3);
+
+    ASSERT_LT(cells.size(), codes.size());
+
+    std::vector<std::uint64_t> expanded;
+    for (const auto& cell : cells) {
+        ASSERT_GE(cell.precision, 3);
+        ASSERT_LE(cell.precision, precision);
+        int shift = bits_per_char * (precision - cell.precision);
+        for (std::uint64_t code = cell.code << shift; code < (cell.code + 1) << shift; code++) {
+            expanded.push_back(code);
+        }
+    }
+
+    // Cells are ordered along the curve, so the expansion is sorted
+    ASSERT_EQ(expanded, codes);
+
+    auto strings = graph::algorithms::cover_to_strings(cells, bits_per_char);
+    ASSERT_EQ(strings.size(), cells.size());
+    ASSERT_EQ(strings[0].size(), cells[0].precision);
+}
+
+TEST(test_polygon_cover, many_polygons) {
+    auto multipolygon = make_test_multipolygon();
+    std::vector<graph::algorithms::LightMultiPolygon> polygons(5, multipolygon);
+    auto res = graph::algorithms::polygon_cover(polygons, 9, 2, 3);
+    auto single_res = graph::algorithms::polygon_cover(multipolygon, 9, 2, 1);
+
+    ASSERT_EQ(res.size(), polygons.size());
+    for (const auto& codes : res) {
+        ASSERT_EQ(codes, single_res);
+    }
 }
\ No newline at end of file
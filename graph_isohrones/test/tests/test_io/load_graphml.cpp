@@ -10,11 +10,11 @@ const std::string TEST_GRAPH_FILENAME = "test/tests/test_io/resources/sahalin_re
 const float TOL = 0.01;
 
 TEST(test_load_graphml, small_file) {
-    osm::OSMNode test_start_node = osm::OSMNode{"2591428522"};
+    osm::OSMNode test_start_node = osm::OSMNode{lib::pooled_string("2591428522"), 0, 0};
     std::unordered_map<osm::OSMNode, float> test_neighbors = {
-        {osm::OSMNode{"2591428547"}, 185.386},
-        {osm::OSMNode{"3128660940"}, 11017.845	},
-        {osm::OSMNode{"2591428524"}, 31.215}
+        {osm::OSMNode{lib::pooled_string("2591428547"), 0, 0}, 185.386},
+        {osm::OSMNode{lib::pooled_string("3128660940"), 0, 0}, 11017.845	},
+        {osm::OSMNode{lib::pooled_string("2591428524"), 0, 0}, 31.215}
     };
     std::fstream f{TEST_GRAPH_FILENAME};
     auto graph = io::load_graphml(f);
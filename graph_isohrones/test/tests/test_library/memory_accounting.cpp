@@ -0,0 +1,78 @@
+#include <graph.h>
+#include <gtest/gtest.h>
+#include <geo_utils/osm_graph.h>
+#include <library/const_string.h>
+#include <library/memory_accounting.h>
+#include <library/string_pool.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+using lib::MemoryCategory;
+
+TEST(test_memory_accounting, counting_allocator) {
+  auto &counters = lib::MemoryCounters::global();
+  std::size_t before = counters.current()[MemoryCategory::Indexes];
+
+  {
+    lib::CountedVector<double, MemoryCategory::Indexes> vec;
+    vec.reserve(1000);
+    ASSERT_EQ(counters.current()[MemoryCategory::Indexes], before + 1000 * sizeof(double));
+    ASSERT_GE(counters.peak()[MemoryCategory::Indexes], before + 1000 * sizeof(double));
+  }
+
+  ASSERT_EQ(counters.current()[MemoryCategory::Indexes], before);
+}
+
+TEST(test_memory_accounting, const_string) {
+  auto &counters = lib::MemoryCounters::global();
+  std::size_t before = counters.current()[MemoryCategory::Ids];
+
+  {
+    lib::const_string s = "2591428522";
+    lib::const_string ss = s;
+    // Copies share the buffer
+    ASSERT_EQ(counters.current()[MemoryCategory::Ids], before + s.heap_size());
+  }
+
+  ASSERT_EQ(counters.current()[MemoryCategory::Ids], before);
+}
+
+TEST(test_memory_accounting, int_graph) {
+  std::unordered_map<int, std::unordered_map<int, float>> weights{
+      {0, {{1, 1.0f}, {2, 2.0f}}}, {1, {{2, 1.0f}}}, {2, {}}};
+  graph::Graph<int> graph(std::move(weights));
+  auto report = graph.memory_usage();
+
+  ASSERT_EQ(report[MemoryCategory::Weights], 3 * sizeof(float));
+  ASSERT_EQ(report[MemoryCategory::Ids], 6 * sizeof(int));
+  ASSERT_EQ(report[MemoryCategory::Coordinates], 0);
+  ASSERT_GT(report[MemoryCategory::Topology], 0);
+  ASSERT_EQ(report.total(), report[MemoryCategory::Topology] + 9 * sizeof(float));
+}
+
+TEST(test_memory_accounting, osm_graph) {
+  auto string_pool = std::make_shared<lib::StringPool>(1024);
+  osm::OSMNode a{string_pool->intern("1"), 37.0f, 55.0f};
+  osm::OSMNode b{string_pool->intern("22"), 37.1f, 55.1f};
+  std::unordered_map<osm::OSMNode, std::unordered_map<osm::OSMNode, float>> weights;
+  weights[a][b] = 10.0f;
+  weights[b][a] = 10.0f;
+  osm::OSMGraph graph(std::move(weights), string_pool);
+  auto report = graph.memory_usage();
+  auto pool_report = string_pool->memory_usage();
+
+  ASSERT_EQ(report[MemoryCategory::Coordinates], 4 * 2 * sizeof(float));
+  ASSERT_EQ(report[MemoryCategory::Ids], 4 * sizeof(lib::pooled_string) + 1024);
+  ASSERT_EQ(report[MemoryCategory::Indexes], pool_report[MemoryCategory::Indexes]);
+  ASSERT_EQ(report[MemoryCategory::Weights], 2 * sizeof(float));
+}
+
+TEST(test_memory_accounting, results) {
+  std::unordered_map<std::string, float> result{{"a", 0.0f}, {"a_very_long_vertex_id_on_heap", 1.0f}};
+  auto report = lib::memory_usage(result);
+
+  ASSERT_EQ(report.total(), report[MemoryCategory::Results]);
+  ASSERT_GT(report[MemoryCategory::Results], 2 * sizeof(std::string) + 30);
+  ASSERT_STREQ(lib::memory_category_name(MemoryCategory::Results), "results");
+}
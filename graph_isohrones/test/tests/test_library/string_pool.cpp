@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <geo_utils/osm_graph.h>
+#include <library/string_pool.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+TEST(test_string_pool, intern) {
+  lib::StringPool pool(64);
+
+  auto s = pool.intern("2591428522");
+  auto ss = pool.intern(std::string("2591428522"));
+  auto other = pool.intern("2591428523");
+
+  ASSERT_EQ(s.c_str(), ss.c_str());
+  ASSERT_EQ(s, ss);
+  ASSERT_NE(s, other);
+  ASSERT_EQ(s.size(), 10);
+  ASSERT_STREQ(s.c_str(), "2591428522");
+  ASSERT_EQ(std::hash<lib::pooled_string>{}(s), std::hash<nonstd::string_view>{}("2591428522"));
+  ASSERT_EQ(pool.size(), 2);
+  ASSERT_THROW(lib::StringPool(0), std::runtime_error);
+}
+
+TEST(test_string_pool, arenas) {
+  lib::StringPool pool(64);
+  std::vector<lib::pooled_string> handles;
+
+  for (int i = 0; i < 10'000; i++) {
+    handles.push_back(pool.intern(std::to_string(i)));
+  }
+  // Strings longer than an arena get their own one
+  auto long_str = pool.intern(std::string(1000, 'x'));
+
+  ASSERT_EQ(pool.size(), 10'001);
+  ASSERT_GT(pool.arenas_count(), 1);
+  ASSERT_EQ(long_str.size(), 1000);
+
+  for (int i = 0; i < 10'000; i++) {
+    ASSERT_EQ(nonstd::string_view(handles[i]), std::to_string(i));
+    ASSERT_EQ(pool.intern(std::to_string(i)).c_str(), handles[i].c_str());
+  }
+}
+
+TEST(test_string_pool, handles) {
+  static_assert(std::is_trivially_copyable<lib::pooled_string>::value);
+  static_assert(sizeof(lib::pooled_string) == sizeof(void *));
+
+  lib::StringPool pool;
+  lib::pooled_string empty;
+
+  // Handles of different pools compare by content
+  ASSERT_EQ(pool.intern("123"), lib::pooled_string("123"));
+  ASSERT_NE(pool.intern("123"), lib::pooled_string("124"));
+  ASSERT_EQ(empty, pool.intern(""));
+  ASSERT_EQ(empty.size(), 0);
+  ASSERT_STREQ(empty.c_str(), "");
+}
+
+TEST(test_string_pool, osm_graph) {
+  auto string_pool = std::make_shared<lib::StringPool>();
+  osm::OSMNode a{string_pool->intern("1"), 37.0f, 55.0f};
+  osm::OSMNode b{string_pool->intern("2"), 37.1f, 55.1f};
+  std::unordered_map<osm::OSMNode, std::unordered_map<osm::OSMNode, float>> weights;
+  weights[a][b] = 10.0f;
+  weights[b];
+  osm::OSMGraph graph(std::move(weights), string_pool);
+  string_pool.reset();
+
+  // The graph keeps the pool alive, lookups by ids from the global pool work
+  ASSERT_EQ(graph.get_neighbors(osm::OSMNode{lib::pooled_string("1"), 0, 0}).at(osm::OSMNode{lib::pooled_string("2"), 0, 0}), 10.0f);
+  ASSERT_TRUE(graph.get_neighbors(osm::OSMNode{lib::pooled_string("2"), 0, 0}).empty());
+}
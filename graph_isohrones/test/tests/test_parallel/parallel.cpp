@@ -27,3 +27,23 @@ TEST(test_parallel, no_graph) {
         EXPECT_EQ(true_res[i], results[i]) << i;
     }
 }
+
+TEST(test_parallel, telemetry) {
+    const int n_threads = 4;
+    std::vector<int> input(1'000);
+    graph::algorithms::PoolTelemetry telemetry;
+    std::vector<graph::algorithms::TraceEvent> trace;
+    auto task_func = [](int itm, int thread_num) {
+        return thread_num;
+    };
+    auto results = graph::algorithms::run_in_threads(input, n_threads, task_func, telemetry, trace);
+
+    for (auto thread_num : results) {
+        EXPECT_GE(thread_num, 0);
+        EXPECT_LT(thread_num, n_threads);
+    }
+    ASSERT_EQ(telemetry.workers.size(), n_threads);
+    // One batch per thread
+    EXPECT_EQ(telemetry.total().tasks, n_threads);
+    EXPECT_EQ(trace.size(), n_threads);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <algorithms/query_scheduler.h>
+#include <algorithms/shortest_paths/async_dijkstra.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/thread_pool.h>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Occupies the only worker of the pool until released
+class Blocker {
+   public:
+    explicit Blocker(graph::algorithms::QueryScheduler& scheduler) {
+        auto started = std::make_shared<std::promise<void>>();
+        auto release = release_.get_future().share();
+        future_ = scheduler.submit([started, release](int, const std::atomic<bool>&) {
+            started->set_value();
+            release.wait();
+            return 0;
+        }, 1000);
+        started->get_future().wait();
+    }
+
+    void release() {
+        release_.set_value();
+        future_.wait();
+    }
+
+   private:
+    std::promise<void> release_;
+    graph::algorithms::QueryFuture<int> future_;
+};
+
+}  // namespace
+
+TEST(test_query_scheduler, priority_order) {
+    graph::algorithms::ThreadPool pool(1);
+    graph::algorithms::QueryScheduler scheduler(pool);
+    Blocker blocker(scheduler);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::vector<graph::algorithms::QueryFuture<int>> futures;
+    for (int id : {0, 1, 2, 3, 4}) {
+        int priority = id == 3 ? 10 : (id == 4 ? -1 : 0);
+        futures.push_back(scheduler.submit([id, &mutex, &order](int, const std::atomic<bool>&) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+            return id * 2;
+        }, priority));
+    }
+    ASSERT_EQ(scheduler.queued(), 5);
+    blocker.release();
+
+    for (int id = 0; id < 5; id++) {
+        ASSERT_EQ(futures[id].get(), id * 2);
+    }
+    ASSERT_EQ(order, std::vector<int>({3, 0, 1, 2, 4}));
+    ASSERT_EQ(scheduler.queued(), 0);
+}
+
+TEST(test_query_scheduler, cancellation) {
+    graph::algorithms::ThreadPool pool(1);
+    graph::algorithms::QueryScheduler scheduler(pool);
+    std::atomic<int> done_calls{0};
+
+    // Running tasks see the flag
+    auto running = scheduler.submit([](int, const std::atomic<bool>& cancelled) {
+        while (!cancelled.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        throw graph::algorithms::QueryCancelled();
+        return 0;
+    }, 0, [&done_calls](const graph::algorithms::QueryFuture<int>& future) {
+        ASSERT_TRUE(future.ready());
+        done_calls++;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // Queued tasks never start
+    std::atomic<bool> started{false};
+    auto queued = scheduler.submit([&started](int, const std::atomic<bool>&) {
+        started = true;
+        return 1;
+    });
+    queued.cancel();
+    running.cancel();
+
+    ASSERT_THROW(running.get(), graph::algorithms::QueryCancelled);
+    ASSERT_THROW(queued.get(), graph::algorithms::QueryCancelled);
+    ASSERT_FALSE(started.load());
+    ASSERT_EQ(done_calls.load(), 1);
+
+    // Errors reach the future
+    auto failing = scheduler.submit([](int, const std::atomic<bool>&) -> int {
+        throw std::runtime_error("failed");
+    });
+    ASSERT_THROW(failing.get(), std::runtime_error);
+}
+
+TEST(test_query_scheduler, async_dijkstra) {
+    std::unordered_map<int, std::unordered_map<int, float>> weights;
+    for (int v = 0; v < 400; v++) {
+        weights[v];
+        if (v % 20 + 1 < 20) {
+            weights[v][v + 1] = 1 + v % 3;
+            weights[v + 1][v] = 2;
+        }
+        if (v + 20 < 400) {
+            weights[v][v + 20] = 1 + v % 5;
+            weights[v + 20][v] = 1;
+        }
+    }
+    graph::CompiledGraph<int> compiled(graph::Graph<int>(std::move(weights)), true);
+    graph::algorithms::ThreadPool pool(2);
+    graph::algorithms::AsyncDijkstra<int> engine(compiled, pool);
+
+    auto cutoff = [](float dist) { return dist <= 15; };
+    std::vector<int> starts = {0, 19, 210, 399};
+    auto futures = engine.submit_batch(starts, 15);
+    auto backward = engine.submit(210, 15, 5, graph::SearchDirection::Backward);
+    for (size_t i = 0; i < starts.size(); i++) {
+        ASSERT_EQ(futures[i].get(), graph::algorithms::single_source_dijkstra(compiled, starts[i], cutoff));
+    }
+    ASSERT_EQ(backward.get(), graph::algorithms::single_source_dijkstra(compiled, 210, cutoff, graph::SearchDirection::Backward));
+
+    ASSERT_THROW(engine.submit(1000, 15), std::out_of_range);
+    ASSERT_THROW(engine.submit_batch({0, 1000}, 15), std::out_of_range);
+    ASSERT_EQ(engine.queued(), 0);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <algorithms/thread_pool.h>
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+TEST(test_thread_pool, parallel_for) {
+    const size_t test_samples_count = 100'000;
+    graph::algorithms::ThreadPool pool(8);
+    std::vector<size_t> results(test_samples_count, 0);
+    std::vector<int> worker_ids(test_samples_count, -1);
+
+    pool.parallel_for(test_samples_count, [&results, &worker_ids](size_t idx, int worker_id) {
+        results[idx] = idx * 2;
+        worker_ids[idx] = worker_id;
+    }, 100);
+
+    for (size_t i = 0; i < test_samples_count; i++) {
+        EXPECT_EQ(results[i], i * 2) << i;
+        EXPECT_GE(worker_ids[i], 0);
+        EXPECT_LT(worker_ids[i], pool.size());
+    }
+}
+
+TEST(test_thread_pool, nested_parallel_for) {
+    graph::algorithms::ThreadPool pool(4);
+    std::atomic<size_t> counter{0};
+
+    pool.parallel_for(16, [&pool, &counter](size_t, int worker_id) {
+        pool.parallel_for(100, [&counter, worker_id](size_t, int inner_worker_id) {
+            EXPECT_EQ(inner_worker_id, worker_id);
+            counter++;
+        });
+    });
+
+    EXPECT_EQ(counter.load(), 1600);
+}
+
+TEST(test_thread_pool, exception) {
+    graph::algorithms::ThreadPool pool(4);
+
+    EXPECT_THROW(
+        pool.parallel_for(1'000, [](size_t idx, int) {
+            if (idx == 500) {
+                throw std::runtime_error("Test error");
+            }
+        }),
+        std::runtime_error
+    );
+
+    // Pool is still usable after an error
+    std::atomic<size_t> counter{0};
+    pool.parallel_for(1'000, [&counter](size_t, int) { counter++; });
+    EXPECT_EQ(counter.load(), 1'000);
+}
+
+TEST(test_thread_pool, shared) {
+    EXPECT_EQ(&graph::algorithms::ThreadPool::shared(), &graph::algorithms::ThreadPool::shared());
+    EXPECT_GE(graph::algorithms::ThreadPool::shared().size(), 1);
+    EXPECT_THROW(graph::algorithms::ThreadPool(0), std::runtime_error);
+}
+
+TEST(test_thread_pool, telemetry) {
+    graph::algorithms::ThreadPool pool(4);
+    pool.reset_telemetry();
+    pool.parallel_for(1'000, [](size_t, int) {}, 10);
+
+    auto telemetry = pool.telemetry();
+    auto total = telemetry.total();
+    ASSERT_EQ(telemetry.workers.size(), 4);
+    EXPECT_EQ(total.tasks, 100);
+    EXPECT_LE(total.steals, total.tasks);
+    EXPECT_GT(telemetry.wall_seconds, 0);
+    EXPECT_GE(telemetry.utilization(), 0);
+    EXPECT_LE(telemetry.utilization(), 1);
+    EXPECT_GE(telemetry.imbalance(), 1);
+
+    for (const auto& worker : telemetry.workers) {
+        EXPECT_LE(worker.longest_task_seconds, worker.busy_seconds);
+        EXPECT_LE(worker.max_queue_wait_seconds, worker.queue_wait_seconds);
+        EXPECT_NEAR(worker.busy_seconds + worker.idle_seconds, telemetry.wall_seconds, 1e-3);
+    }
+
+    pool.reset_telemetry();
+    EXPECT_EQ(pool.telemetry().total().tasks, 0);
+}
+
+TEST(test_thread_pool, trace) {
+    graph::algorithms::ThreadPool pool(2);
+    pool.parallel_for(10, [](size_t, int) {}, 1, "untraced");
+
+    pool.start_trace();
+    pool.parallel_for(10, [](size_t, int) {}, 2, "traced");
+    auto trace = pool.stop_trace();
+
+    ASSERT_EQ(trace.size(), 5);
+    for (size_t i = 0; i < trace.size(); i++) {
+        EXPECT_STREQ(trace[i].name, "traced");
+        EXPECT_GE(trace[i].worker_id, 0);
+        EXPECT_LT(trace[i].worker_id, 2);
+        EXPECT_GE(trace[i].duration_us, 1);
+        if (i > 0) {
+            EXPECT_LE(trace[i - 1].start_us, trace[i].start_us);
+        }
+    }
+
+    std::ostringstream out;
+    graph::algorithms::write_chrome_trace(out, trace);
+    EXPECT_EQ(out.str().find("{\"traceEvents\":["), 0);
+    EXPECT_NE(out.str().find("\"name\":\"traced\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_TRUE(pool.stop_trace().empty());
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/distance_matrix.h>
+#include <algorithms/thread_pool.h>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <graph_fixtures.h>
+#include <unordered_map>
+#include <vector>
+
+TEST(test_distance_matrix, matches_dijkstra) {
+    graph::Graph<int> graph(fixtures::make_random_weights(2000, 2, 9));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::algorithms::ThreadPool pool(3);
+    auto no_cutoff = [](float) { return true; };
+
+    std::vector<int> sources;
+    std::vector<int> targets;
+    for (int i = 0; i < 50; i++) {
+        sources.push_back((i * 37) % 2000);
+        targets.push_back((i * 53 + 11) % 2000);
+    }
+    // Repeated targets and a source among the targets
+    targets.push_back(targets[3]);
+    targets.push_back(sources[5]);
+
+    auto matrix = graph::algorithms::distance_matrix(
+        compiled, sources, targets, graph::algorithms::DistanceMatrix::kUnreachable, graph::SearchDirection::Forward, pool
+    );
+    ASSERT_EQ(matrix.rows, sources.size());
+    ASSERT_EQ(matrix.cols, targets.size());
+
+    for (size_t row = 0; row < sources.size(); row++) {
+        auto dists = graph::algorithms::single_source_dijkstra(compiled, sources[row], no_cutoff);
+        for (size_t col = 0; col < targets.size(); col++) {
+            auto it = dists.find(targets[col]);
+            float expected = it == dists.end() ? graph::algorithms::DistanceMatrix::kUnreachable : it->second;
+            ASSERT_EQ(matrix.at(row, col), expected);
+        }
+    }
+    ASSERT_EQ(matrix.at(5, targets.size() - 1), 0);
+
+    // Backward searches from targets give the transposed matrix
+    auto transposed = graph::algorithms::distance_matrix(
+        compiled, targets, sources, graph::algorithms::DistanceMatrix::kUnreachable, graph::SearchDirection::Backward, pool
+    );
+    for (size_t row = 0; row < sources.size(); row++) {
+        for (size_t col = 0; col < targets.size(); col++) {
+            ASSERT_FLOAT_EQ(transposed.at(col, row), matrix.at(row, col));
+        }
+    }
+}
+
+TEST(test_distance_matrix, max_distance) {
+    GraphWeights weights = {
+        {1, {{2, 1}}},
+        {2, {{3, 2}}},
+        {3, {}},
+        {4, {{1, 1}}}
+    };
+    graph::Graph<int> graph(std::move(weights));
+    graph::CompiledGraph<int> compiled(graph);
+
+    auto matrix = graph::algorithms::distance_matrix(compiled, std::vector<int>{1, 3}, std::vector<int>{2, 3, 4}, 2.5f);
+    ASSERT_EQ(matrix.at(0, 0), 1);
+    ASSERT_EQ(matrix.at(0, 1), graph::algorithms::DistanceMatrix::kUnreachable);
+    ASSERT_EQ(matrix.at(0, 2), graph::algorithms::DistanceMatrix::kUnreachable);
+    ASSERT_EQ(matrix.at(1, 1), 0);
+    ASSERT_EQ(matrix.at(1, 0), graph::algorithms::DistanceMatrix::kUnreachable);
+}
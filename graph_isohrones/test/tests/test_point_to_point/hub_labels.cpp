@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/contraction_hierarchy.h>
+#include <algorithms/shortest_paths/hub_labels.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <algorithms/thread_pool.h>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <graph_fixtures.h>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+TEST(test_hub_labels, exact_distances) {
+    GraphWeights weights = fixtures::make_directed_grid(30, 3, std::uniform_int_distribution<int>(1, 20));
+    // Plus a vertex nobody reaches
+    weights[900][0] = 1;
+    graph::CompiledGraph<int> compiled(graph::Graph<int>(std::move(weights)));
+    auto hierarchy = graph::algorithms::contract_graph(compiled);
+    ASSERT_EQ(hierarchy.vertices_count(), compiled.vertices_count());
+    ASSERT_GE(hierarchy.edges_count(), compiled.edges_count());
+
+    graph::algorithms::HubLabels labels(compiled, hierarchy);
+    ASSERT_EQ(labels.fingerprint(), compiled.fingerprint());
+    ASSERT_FALSE(labels.is_mapped());
+
+    graph::algorithms::DijkstraWorkspace workspace;
+    graph::algorithms::NoSearchStats stats;
+    auto no_cutoff = [](float) { return true; };
+    for (std::uint32_t s = 0; s < compiled.vertices_count(); s += 7) {
+        graph::algorithms::single_source_dijkstra(compiled, s, no_cutoff, workspace, stats);
+        for (std::uint32_t t = 0; t < compiled.vertices_count(); t++) {
+            ASSERT_EQ(labels.distance(s, t), workspace.dist(t));
+        }
+    }
+
+    auto report = labels.report();
+    ASSERT_EQ(report.forward_sizes.size(), compiled.vertices_count());
+    ASSERT_GE(report.average_size, 1);
+    // Labels are far smaller than the graph
+    ASSERT_LT(report.average_size, compiled.vertices_count() / 10.0);
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+        ASSERT_EQ(report.forward_sizes[v], labels.forward_label(v).size());
+        ASSERT_LE(report.backward_sizes[v], report.max_size);
+    }
+}
+
+TEST(test_hub_labels, mapped_batches) {
+    GraphWeights weights = fixtures::make_directed_grid(20, 9, std::uniform_int_distribution<int>(1, 20));
+    // Plus a vertex nobody reaches
+    weights[400][0] = 1;
+    graph::CompiledGraph<int> compiled(graph::Graph<int>(std::move(weights)));
+    graph::algorithms::HubLabels built(compiled, graph::algorithms::contract_graph(compiled, 50));
+    auto path = (std::filesystem::temp_directory_path() / "test_hub_labels.bin").string();
+    built.write(path);
+    auto labels = graph::algorithms::HubLabels::open(path);
+    ASSERT_TRUE(labels.is_mapped());
+    ASSERT_EQ(labels.vertices_count(), compiled.vertices_count());
+    ASSERT_EQ(labels.report().bytes, std::filesystem::file_size(path));
+
+    graph::algorithms::ThreadPool pool(2);
+    std::vector<std::uint32_t> sources = {0, 5, 399, 400};
+    std::vector<std::uint32_t> targets = {400, 17, 0, 250, 399};
+    auto table = labels.distance_table(sources, targets, pool);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+    for (auto s : sources) {
+        for (auto t : targets) {
+            pairs.push_back({s, t});
+        }
+    }
+    auto distances = labels.distances(pairs, pool);
+    ASSERT_EQ(table.size(), pairs.size());
+    for (size_t i = 0; i < pairs.size(); i++) {
+        ASSERT_EQ(table[i], built.distance(pairs[i].first, pairs[i].second));
+        ASSERT_EQ(distances[i], table[i]);
+    }
+    // The extra vertex reaches the grid, nothing reaches it
+    auto extra = compiled.index(400);
+    ASSERT_EQ(labels.distance(extra, extra), 0);
+    ASSERT_EQ(labels.distance(compiled.index(0), extra), std::numeric_limits<float>::infinity());
+
+    std::filesystem::remove(path);
+    ASSERT_THROW(graph::algorithms::HubLabels::open(path), std::runtime_error);
+}
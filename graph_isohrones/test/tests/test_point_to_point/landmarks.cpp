@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/landmarks.h>
+#include <algorithms/shortest_paths/point_to_point.h>
+#include <compiled_graph.h>
+#include <graph.h>
+#include <graph_fixtures.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+TEST(test_landmarks, bounds_are_admissible) {
+    graph::Graph<int> graph(fixtures::make_directed_grid(40, 1, std::uniform_real_distribution<float>(1, 2)));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::algorithms::DijkstraWorkspace workspace;
+    graph::algorithms::NoSearchStats stats;
+    auto no_cutoff = [](float) { return true; };
+
+    for (auto selection : {graph::algorithms::LandmarkSelection::Farthest, graph::algorithms::LandmarkSelection::Avoid}) {
+        graph::algorithms::Landmarks<int> landmarks(compiled, 8, selection, 3);
+        ASSERT_EQ(landmarks.size(), 8);
+        ASSERT_TRUE(landmarks.matches(compiled));
+
+        double bound_sum = 0;
+        double dist_sum = 0;
+        for (std::uint32_t source = 0; source < compiled.vertices_count(); source += 37) {
+            graph::algorithms::single_source_dijkstra(compiled, source, no_cutoff, workspace, stats);
+            for (std::uint32_t target = 0; target < compiled.vertices_count(); target += 11) {
+                float bound = landmarks.lower_bound(source, target);
+                ASSERT_LE(bound, workspace.dist(target));
+                bound_sum += bound;
+                dist_sum += workspace.dist(target);
+            }
+        }
+        // Bounds are tight enough to be worth it
+        ASSERT_GT(bound_sum, dist_sum * 0.5);
+    }
+}
+
+TEST(test_landmarks, point_to_point) {
+    graph::Graph<int> graph(fixtures::make_directed_grid(60, 2, std::uniform_real_distribution<float>(1, 2)));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::algorithms::Landmarks<int> landmarks(compiled, 8);
+    graph::algorithms::PointToPointEngine<int> alt(compiled, landmarks);
+    graph::algorithms::PointToPointEngine<int> dijkstra(compiled);
+    graph::algorithms::PointToPointWorkspace workspace;
+    graph::algorithms::SearchStats alt_stats;
+    graph::algorithms::SearchStats dijkstra_stats;
+
+    ASSERT_EQ(alt.heuristic(), graph::algorithms::PointToPointHeuristic::Landmarks);
+    for (std::uint32_t source = 0; source < compiled.vertices_count(); source += 131) {
+        for (std::uint32_t target = 7; target < compiled.vertices_count(); target += 173) {
+            float expected = dijkstra.distance(source, target, workspace, dijkstra_stats);
+            ASSERT_NEAR(alt.distance(source, target, workspace, alt_stats), expected, expected * 1e-5);
+        }
+    }
+    ASSERT_LT(alt_stats.settled_nodes * 3, dijkstra_stats.settled_nodes);
+}
+
+TEST(test_landmarks, one_to_many) {
+    graph::Graph<int> graph(fixtures::make_directed_grid(30, 3, std::uniform_real_distribution<float>(1, 2)));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::algorithms::Landmarks<int> landmarks(compiled, 4, graph::algorithms::LandmarkSelection::Farthest);
+    graph::algorithms::PointToPointEngine<int> alt(compiled, landmarks);
+    graph::algorithms::PointToPointEngine<int> dijkstra(compiled);
+    auto cutoff = [](float) { return true; };
+
+    std::vector<int> targets = {5, 77, 310, 599, 77, 898};
+
+    for (auto direction : {graph::SearchDirection::Forward, graph::SearchDirection::Backward}) {
+        auto all_dists = graph::algorithms::single_source_dijkstra(compiled, 450, cutoff, direction);
+
+        for (const auto* engine : {&alt, &dijkstra}) {
+            auto dists = engine->distances_from(450, targets, direction);
+            ASSERT_EQ(dists.size(), targets.size());
+            for (size_t i = 0; i < targets.size(); i++) {
+                ASSERT_NEAR(dists[i], all_dists.at(targets[i]), 1e-3);
+            }
+        }
+    }
+}
+
+TEST(test_landmarks, save_load) {
+    graph::Graph<int> graph(fixtures::make_directed_grid(20, 4, std::uniform_real_distribution<float>(1, 2)));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::algorithms::Landmarks<int> landmarks(compiled, 4);
+
+    std::stringstream stream;
+    landmarks.save(stream);
+    auto loaded = graph::algorithms::Landmarks<int>::load(stream, compiled);
+
+    ASSERT_EQ(loaded.vertices(), landmarks.vertices());
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v += 7) {
+        ASSERT_EQ(loaded.lower_bound(v, 3), landmarks.lower_bound(v, 3));
+    }
+
+    graph::Graph<int> other_graph(fixtures::make_directed_grid(20, 5, std::uniform_real_distribution<float>(1, 2)));
+    graph::CompiledGraph<int> other_compiled(other_graph, true);
+    std::stringstream other_stream(stream.str());
+    ASSERT_THROW(graph::algorithms::Landmarks<int>::load(other_stream, other_compiled), std::runtime_error);
+    ASSERT_THROW(graph::algorithms::PointToPointEngine<int>(other_compiled, landmarks), std::runtime_error);
+
+    std::stringstream garbage("not landmarks");
+    ASSERT_THROW(graph::algorithms::Landmarks<int>::load(garbage, compiled), std::runtime_error);
+}
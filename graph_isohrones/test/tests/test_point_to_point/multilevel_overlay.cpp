@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/dijkstra_search.h>
+#include <algorithms/shortest_paths/multilevel_overlay.h>
+#include <algorithms/shortest_paths/search_stats.h>
+#include <algorithms/thread_pool.h>
+#include <compiled_graph.h>
+#include <geo_utils/osm_graph.h>
+#include <graph_fixtures.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Reference weights for plain Dijkstra
+struct VectorWeight {
+    const std::vector<float>* weights = nullptr;
+
+    float operator()(const graph::CompiledGraph<osm::OSMNode>&, std::uint32_t edge) const {
+        return (*weights)[edge];
+    }
+};
+
+void check_distances(
+    const graph::CompiledGraph<osm::OSMNode>& compiled,
+    const graph::algorithms::OverlayMetric<osm::OSMNode>& metric,
+    const std::vector<float>& weights
+) {
+    graph::algorithms::DijkstraSearch<graph::algorithms::BinaryHeap, graph::algorithms::DistanceLabels, VectorWeight> reference(VectorWeight{&weights});
+    graph::algorithms::OverlayDijkstraSearch search;
+    graph::algorithms::NoSearchStats stats;
+    struct NoVisitor {};
+
+    for (std::uint32_t s : {0u, 37u, 820u, 1599u}) {
+        reference.run(compiled, s, NoVisitor{}, stats);
+        for (std::uint32_t t = 0; t < compiled.vertices_count(); t += 13) {
+            ASSERT_EQ(graph::algorithms::overlay_distance(metric, s, t, search, stats), reference.dist(t));
+        }
+    }
+}
+
+}  // namespace
+
+TEST(test_multilevel_overlay, topology) {
+    auto string_pool = std::make_shared<lib::StringPool>();
+    graph::CompiledGraph<osm::OSMNode> compiled(fixtures::make_grid(40, string_pool, 5));
+    graph::algorithms::MultilevelOverlay<osm::OSMNode> overlay(compiled, 2, 2);
+
+    ASSERT_EQ(overlay.levels(), 2);
+    ASSERT_EQ(overlay.cells_count(1), 16);
+    ASSERT_EQ(overlay.cells_count(2), 4);
+    ASSERT_LT(overlay.boundary_count(2), overlay.boundary_count(1));
+
+    for (std::uint32_t v = 0; v < compiled.vertices_count(); v++) {
+        ASSERT_EQ(overlay.cell(v, 2), overlay.cell(v, 1) / 4);
+        for (std::uint32_t level = 1; level <= 2; level++) {
+            bool crosses = false;
+            for (auto edge = compiled.first_edge(v); edge < compiled.last_edge(v); edge++) {
+                crosses |= overlay.cell(compiled.target(edge), level) != overlay.cell(v, level);
+            }
+            if (crosses) {
+                ASSERT_NE(overlay.boundary_position(v, level), overlay.kInvalidIndex);
+            }
+        }
+    }
+
+    ASSERT_THROW(graph::algorithms::MultilevelOverlay<osm::OSMNode>(compiled, 0, 4), std::runtime_error);
+    ASSERT_THROW(graph::algorithms::MultilevelOverlay<osm::OSMNode>(compiled, 6, 4), std::runtime_error);
+    // The defaults ask for 4096 cells, more than the grid has vertices
+    try {
+        graph::algorithms::MultilevelOverlay<osm::OSMNode> too_fine(compiled);
+        FAIL() << "Overlay with more cells than vertices";
+    } catch (const std::runtime_error& error) {
+        ASSERT_NE(std::string(error.what()).find("levels"), std::string::npos);
+    }
+}
+
+TEST(test_multilevel_overlay, customization) {
+    auto string_pool = std::make_shared<lib::StringPool>();
+    graph::CompiledGraph<osm::OSMNode> compiled(fixtures::make_grid(40, string_pool, 5));
+    graph::algorithms::MultilevelOverlay<osm::OSMNode> overlay(compiled, 2, 2);
+    graph::algorithms::ThreadPool pool(2);
+
+    std::vector<float> weights(compiled.edges_count());
+    for (std::uint32_t edge = 0; edge < weights.size(); edge++) {
+        weights[edge] = compiled.weight(edge);
+    }
+    graph::algorithms::OverlayMetric<osm::OSMNode> metric(overlay, pool);
+    check_distances(compiled, metric, weights);
+
+    // Traffic update: some streets get slower, one is closed
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> slowdown(1, 4);
+    for (auto& weight : weights) {
+        weight *= slowdown(gen);
+    }
+    weights[100] = 1e6f;
+    metric.customize(weights, pool);
+    check_distances(compiled, metric, weights);
+
+    ASSERT_EQ(graph::algorithms::overlay_distance(metric, compiled.vertex(5), compiled.vertex(5)), 0);
+    weights.pop_back();
+    ASSERT_THROW(metric.customize(weights, pool), std::runtime_error);
+    weights.push_back(-1);
+    ASSERT_THROW(metric.customize(weights, pool), std::runtime_error);
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <algorithms/shortest_paths/compiled_dijkstra.h>
+#include <algorithms/shortest_paths/point_to_point.h>
+#include <algorithms/thread_pool.h>
+#include <compiled_graph.h>
+#include <geo_utils/distance.h>
+#include <geo_utils/osm_graph.h>
+#include <graph.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Jittered grid of points around Moscow, edges between grid neighbours weighted by length
+// times a detour factor >= 1, so great-circle distances are lower bounds
+osm::OSMGraph make_geo_grid(int side, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> jitter_dist(-0.0003, 0.0003);
+    std::uniform_real_distribution<float> detour_dist(1, 1.5);
+    auto string_pool = std::make_shared<lib::StringPool>();
+    std::vector<osm::OSMNode> nodes;
+
+    for (int node = 0; node < side * side; node++) {
+        float lon = 37.5f + (node % side) * 0.001f + jitter_dist(gen);
+        float lat = 55.7f + (node / side) * 0.001f + jitter_dist(gen);
+        nodes.push_back(osm::OSMNode{string_pool->intern(std::to_string(node)), lon, lat});
+    }
+
+    std::unordered_map<osm::OSMNode, std::unordered_map<osm::OSMNode, float>> weights;
+    auto add_edge = [&](int from_idx, int to_idx) {
+        const auto& from = nodes[from_idx];
+        const auto& to = nodes[to_idx];
+        float length = geo_utils::great_circle_distance(from.x, from.y, to.x, to.y);
+        weights[from][to] = length * detour_dist(gen);
+        weights[to][from] = length * detour_dist(gen);
+    };
+
+    for (int node = 0; node < side * side; node++) {
+        weights[nodes[node]];
+        if (node % side + 1 < side) {
+            add_edge(node, node + 1);
+        }
+        if (node + side < side * side) {
+            add_edge(node, node + side);
+        }
+    }
+    return osm::OSMGraph(std::move(weights), string_pool);
+}
+
+template <typename Vertex>
+void expect_matches_dijkstra(const graph::CompiledGraph<Vertex>& compiled, const graph::algorithms::PointToPointEngine<Vertex>& engine) {
+    graph::algorithms::PointToPointWorkspace p2p_workspace;
+    graph::algorithms::DijkstraWorkspace workspace;
+    graph::algorithms::NoSearchStats stats;
+    auto no_cutoff = [](float) { return true; };
+
+    for (std::uint32_t source = 0; source < compiled.vertices_count(); source += 97) {
+        graph::algorithms::single_source_dijkstra(compiled, source, no_cutoff, workspace, stats);
+
+        for (std::uint32_t target = 0; target < compiled.vertices_count(); target += 13) {
+            float expected = workspace.dist(target);
+            float dist = engine.distance(source, target, p2p_workspace, stats);
+            if (expected == graph::algorithms::DijkstraWorkspace::kUnreached) {
+                ASSERT_EQ(dist, engine.kUnreachable);
+            } else {
+                ASSERT_NEAR(dist, expected, expected * 1e-4);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(test_point_to_point, bidirectional_dijkstra) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> node_dist(0, 999);
+    std::uniform_real_distribution<float> weight_dist(1, 100);
+    std::unordered_map<int, std::unordered_map<int, float>> weights;
+    for (int node = 0; node < 1000; node++) {
+        weights[node];
+        for (int i = 0; i < 2; i++) {
+            weights[node][node_dist(gen)] = weight_dist(gen);
+        }
+    }
+    graph::Graph<int> graph(std::move(weights));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::algorithms::PointToPointEngine<int> engine(compiled);
+
+    ASSERT_EQ(engine.heuristic(), graph::algorithms::PointToPointHeuristic::None);
+    ASSERT_THROW(
+        graph::algorithms::PointToPointEngine<int>(compiled, 1, graph::algorithms::PointToPointHeuristic::GreatCircle),
+        std::runtime_error
+    );
+    ASSERT_EQ(engine.distance(5, 5), 0);
+    expect_matches_dijkstra(compiled, engine);
+}
+
+TEST(test_point_to_point, unreachable) {
+    std::unordered_map<int, std::unordered_map<int, float>> weights = {
+        {1, {{2, 1}}},
+        {2, {}},
+        {3, {{1, 1}}}
+    };
+    graph::Graph<int> graph(std::move(weights));
+    graph::CompiledGraph<int> compiled(graph, true);
+    graph::algorithms::PointToPointEngine<int> engine(compiled);
+
+    ASSERT_EQ(engine.distance(3, 2), 2);
+    ASSERT_EQ(engine.distance(2, 3), engine.kUnreachable);
+}
+
+TEST(test_point_to_point, great_circle_a_star) {
+    auto graph = make_geo_grid(50, 11);
+    graph::CompiledGraph<osm::OSMNode> compiled(graph, true);
+    graph::algorithms::PointToPointEngine<osm::OSMNode> a_star(compiled);
+    graph::algorithms::PointToPointEngine<osm::OSMNode> dijkstra(compiled, 1, graph::algorithms::PointToPointHeuristic::None);
+
+    ASSERT_EQ(a_star.heuristic(), graph::algorithms::PointToPointHeuristic::GreatCircle);
+    ASSERT_THROW(graph::algorithms::PointToPointEngine<osm::OSMNode>(compiled, 0), std::runtime_error);
+    expect_matches_dijkstra(compiled, a_star);
+
+    // The potentials prune the search
+    graph::algorithms::PointToPointWorkspace workspace;
+    graph::algorithms::SearchStats a_star_stats;
+    graph::algorithms::SearchStats dijkstra_stats;
+    for (std::uint32_t source = 0; source < compiled.vertices_count(); source += 101) {
+        std::uint32_t target = (source * 7 + 1) % compiled.vertices_count();
+        ASSERT_FLOAT_EQ(
+            a_star.distance(source, target, workspace, a_star_stats),
+            dijkstra.distance(source, target, workspace, dijkstra_stats)
+        );
+    }
+    ASSERT_LT(a_star_stats.settled_nodes, dijkstra_stats.settled_nodes);
+}
+
+TEST(test_point_to_point, batched) {
+    auto graph = make_geo_grid(40, 5);
+    graph::CompiledGraph<osm::OSMNode> compiled(graph, true);
+    graph::algorithms::PointToPointEngine<osm::OSMNode> engine(compiled);
+    graph::algorithms::ThreadPool pool(4);
+
+    std::vector<std::pair<osm::OSMNode, osm::OSMNode>> pairs;
+    for (std::uint32_t i = 0; i < 200; i++) {
+        pairs.push_back({compiled.vertex(i * 3), compiled.vertex((i * 17 + 5) % compiled.vertices_count())});
+    }
+
+    auto dists = engine.distances(pairs, pool);
+    ASSERT_EQ(dists.size(), pairs.size());
+    for (size_t i = 0; i < pairs.size(); i++) {
+        ASSERT_EQ(dists[i], engine.distance(pairs[i].first, pairs[i].second));
+    }
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <algorithms/light_polygon.h>
+#include <algorithms/spatial_join.h>
+#include <algorithms/thread_pool.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Overlapping square zones with a square hole each
+std::vector<graph::algorithms::LightMultiPolygon> make_test_zones(size_t zones_count, std::mt19937& gen) {
+    std::uniform_real_distribution<double> coord_dist(30, 40);
+    std::uniform_real_distribution<double> size_dist(0.2, 1.5);
+    std::vector<graph::algorithms::LightMultiPolygon> zones;
+
+    for (size_t i = 0; i < zones_count; i++) {
+        double x = coord_dist(gen);
+        double y = coord_dist(gen);
+        double size = size_dist(gen);
+        graph::algorithms::LightPolygon polygon;
+        polygon.external_polygon = graph::algorithms::LightSimplePolygon({{x, y}, {x + size, y}, {x + size, y + size}, {x, y + size}, {x, y}});
+        double hx = x + size / 3;
+        double hy = y + size / 3;
+        polygon.internal_polygons_vec.push_back(graph::algorithms::LightSimplePolygon(
+            {{hx, hy}, {hx + size / 4, hy}, {hx + size / 4, hy + size / 4}, {hx, hy + size / 4}, {hx, hy}}
+        ));
+
+        graph::algorithms::LightMultiPolygon zone;
+        zone.polygons_vec.push_back(polygon);
+        zones.push_back(zone);
+    }
+
+    return zones;
+}
+
+}  // namespace
+
+TEST(test_spatial_join, join_matches_brute_force) {
+    std::mt19937 gen(5);
+    auto zones = make_test_zones(300, gen);
+    graph::algorithms::ThreadPool pool(4);
+    graph::algorithms::PolygonIndex index(zones, pool);
+    std::uniform_real_distribution<double> coord_dist(29, 42);
+    std::vector<double> lon_vec;
+    std::vector<double> lat_vec;
+
+    for (size_t i = 0; i < 30'000; i++) {
+        lon_vec.push_back(coord_dist(gen));
+        lat_vec.push_back(coord_dist(gen));
+    }
+    lon_vec.push_back(std::numeric_limits<double>::quiet_NaN());
+    lat_vec.push_back(35);
+
+    auto res = index.join(lon_vec, lat_vec, pool, 1'000);
+    auto assigned = index.assign(lon_vec, lat_vec, pool, 777);
+    graph::algorithms::SpatialJoinResult true_res;
+    std::vector<std::int64_t> true_assigned(lon_vec.size(), -1);
+
+    for (size_t point_idx = 0; point_idx < lon_vec.size(); point_idx++) {
+        for (size_t zone_idx = 0; zone_idx < zones.size(); zone_idx++) {
+            if (zones[zone_idx].contains(lon_vec[point_idx], lat_vec[point_idx])) {
+                true_res.point_ids.push_back(point_idx);
+                true_res.polygon_ids.push_back(zone_idx);
+                if (true_assigned[point_idx] < 0) {
+                    true_assigned[point_idx] = zone_idx;
+                }
+            }
+        }
+    }
+
+    ASSERT_GT(true_res.point_ids.size(), lon_vec.size() / 2);
+    ASSERT_EQ(res.point_ids, true_res.point_ids);
+    ASSERT_EQ(res.polygon_ids, true_res.polygon_ids);
+    ASSERT_EQ(assigned, true_assigned);
+}
+
+TEST(test_spatial_join, empty_inputs) {
+    graph::algorithms::ThreadPool pool(2);
+    graph::algorithms::PolygonIndex empty_index(std::vector<graph::algorithms::LightMultiPolygon>{}, pool);
+    auto assigned = empty_index.assign(std::vector<double>{1, 2}, std::vector<double>{1, 2}, pool);
+    ASSERT_EQ(assigned, std::vector<std::int64_t>({-1, -1}));
+
+    std::mt19937 gen(1);
+    graph::algorithms::PolygonIndex index(make_test_zones(10, gen), pool);
+    ASSERT_EQ(index.size(), 10);
+    ASSERT_TRUE(index.join(std::vector<double>{}, std::vector<double>{}, pool).point_ids.empty());
+    ASSERT_THROW(index.join(std::vector<double>{1}, std::vector<double>{}, pool), std::runtime_error);
+}